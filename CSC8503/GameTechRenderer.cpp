@@ -7,6 +7,7 @@
 #include "MshLoader.h"
 #include "BindingSlots.h"
 #include "Debug.h"
+#include "JobSystem.h"
 
 #include "OGLRenderer.h"
 #include "OGLShader.h"
@@ -111,8 +112,8 @@ void GameTechRenderer::UpdatePassUBO(const PassDataCPU& data) {
 }
 
 void GameTechRenderer::UpdateScenePassData() {
-	Matrix4 viewMatrix = gameWorld.GetMainCamera().BuildViewMatrix();
-	Matrix4 projMatrix = gameWorld.GetMainCamera().BuildProjectionMatrix(hostWindow.GetScreenAspect());
+	Matrix4 viewMatrix = frameSnapshot->GetCamera().BuildViewMatrix();
+	Matrix4 projMatrix = frameSnapshot->GetCamera().BuildProjectionMatrix(hostWindow.GetScreenAspect());
 
 	PassDataCPU pass = {};
 	pass.viewMatrix = viewMatrix;
@@ -120,11 +121,11 @@ void GameTechRenderer::UpdateScenePassData() {
 	pass.viewProjMatrix = projMatrix * viewMatrix;
 	pass.shadowMatrix = shadowMatrix;
 
-	Vector3 camPos = gameWorld.GetMainCamera().GetPosition();
+	Vector3 camPos = frameSnapshot->GetCamera().GetPosition();
 	pass.cameraPos = Vector4(camPos.x, camPos.y, camPos.z, 1.0f);
 
-	Vector3 sunPos = gameWorld.GetSunPosition();
-	Vector3 sunCol = gameWorld.GetSunColour();
+	Vector3 sunPos = frameSnapshot->GetSunPosition();
+	Vector3 sunCol = frameSnapshot->GetSunColour();
 	pass.lightColour = Vector4(sunCol.x, sunCol.y, sunCol.z, 1.0f);
 	pass.lightPosRadius = Vector4(sunPos.x, sunPos.y, sunPos.z, 10000.0f);
 
@@ -175,11 +176,11 @@ void GameTechRenderer::BuildAndUploadObjectTable() {
 	frameObjects.clear();
 	frameObjects.reserve(opaqueObjects.size() + transparentObjects.size());
 
-	std::vector<MaterialDataCPU> frameMaterials;
+	ArenaVector<MaterialDataCPU> frameMaterials(frameArena);
 	frameMaterials.reserve(256);
 
-	std::unordered_map<const OGLTexture*, uint32_t> texToMat;
-	std::vector<OGLTexture*> uniqueTextures;
+	ArenaUnorderedMap<const OGLTexture*, uint32_t> texToMat(frameArena);
+	ArenaVector<OGLTexture*> uniqueTextures(frameArena);
 	uniqueTextures.reserve(256);
 
 	auto materialIDFor = [&](OGLTexture* tex) -> uint32_t {
@@ -202,16 +203,16 @@ void GameTechRenderer::BuildAndUploadObjectTable() {
 
 	auto push = [&](const std::vector<ObjectSortState>& list) {
 		for (const auto& s : list) {
-			const RenderObject* o = s.object;
-			OGLTexture* diffuseTex = (OGLTexture*)o->GetMaterial().diffuseTex;
+			const RenderSnapshot::Entry* o = s.object;
+			OGLTexture* diffuseTex = (OGLTexture*)o->diffuseTex;
 
 			ObjectDataCPU od{};
-			od.modelMatrix = o->GetTransform().GetMatrix();
-			od.colour = o->GetColour();
+			od.modelMatrix = o->modelMatrix;
+			od.colour = o->colour;
 			od.materialID = materialIDFor(diffuseTex);
 
 			od.flags = 0;
-			if (!o->GetMesh()->GetColourData().empty()) od.flags |= 2u; // hasVertexColours
+			if (o->hasVertexColours) od.flags |= 2u;
 			frameObjects.push_back(od);
 		}
 		};
@@ -220,7 +221,7 @@ void GameTechRenderer::BuildAndUploadObjectTable() {
 	push(transparentObjects);
 
 	// texture array + texIndex 回填
-	std::unordered_map<const OGLTexture*, uint32_t> layerMap;
+	ArenaUnorderedMap<const OGLTexture*, uint32_t> layerMap(frameArena);
 	BuildMainTexArray(uniqueTextures, layerMap, mainTexArrayW, mainTexArrayH);
 
 	for (auto& kv : texToMat) {
@@ -257,7 +258,7 @@ void GameTechRenderer::InitMaterialSSBO() {
 	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_SSBO_SLOT, materialSSBO);
 }
 
-void GameTechRenderer::UpdateMaterialSSBO(const std::vector<MaterialDataCPU>& materials) {
+void GameTechRenderer::UpdateMaterialSSBO(const ArenaVector<MaterialDataCPU>& materials) {
 	materialSSBOCount = materials.size();
 	const size_t neededBytes = materials.size() * sizeof(MaterialDataCPU);
 
@@ -282,8 +283,8 @@ void GameTechRenderer::UpdateMaterialSSBO(const std::vector<MaterialDataCPU>& ma
 	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void GameTechRenderer::BuildMainTexArray(const std::vector<OGLTexture*>& textures,
-	std::unordered_map<const OGLTexture*, uint32_t>& outLayerMap, uint32_t& outW, uint32_t& outH) {
+void GameTechRenderer::BuildMainTexArray(const ArenaVector<OGLTexture*>& textures,
+	ArenaUnorderedMap<const OGLTexture*, uint32_t>& outLayerMap, uint32_t& outW, uint32_t& outH) {
 	outLayerMap.clear();
 	outW = outH = 0;
 	if (textures.empty()) return;
@@ -406,6 +407,17 @@ Texture* GameTechRenderer::LoadTexture(const std::string& name) {
 void GameTechRenderer::RenderFrame() {
 	glEnable(GL_CULL_FACE);
 	glClearColor(1, 1, 1, 1);
+	frameArena.Reset(); //everything allocated from it last frame has gone out of scope by now
+
+	//Without a snapshot handed to us, fall back to taking our own from the live world
+	if (externalSnapshot) {
+		frameSnapshot = externalSnapshot;
+	}
+	else {
+		gameWorld.UpdateTransforms();
+		ownSnapshot.Capture(gameWorld);
+		frameSnapshot = &ownSnapshot;
+	}
 	BuildObjectLists();
 	
 	{
@@ -448,40 +460,38 @@ void GameTechRenderer::BuildObjectLists() {
 	opaqueObjects.clear();
 	transparentObjects.clear();
 
-	Vector3 camPos = gameWorld.GetMainCamera().GetPosition();
-
-	gameWorld.OperateOnContents(
-		[&](GameObject* o) {
-			if (o->IsActive()) {
-				const RenderObject* g = o->GetRenderObject();
-				if (g) {
-					GameTechMaterial mat = g->GetMaterial();
-
-					ObjectSortState o;
-					o.object = g;
-					o.distanceFromCamera = Vector::LengthSquared(camPos - g->GetTransform().GetPosition());
-
-					if (mat.type == MaterialType::Opaque) {
-						opaqueObjects.emplace_back(o);
-					}
-					else if (mat.type == MaterialType::Transparent) {
-						transparentObjects.emplace_back(o);
-					}
-				}
-			}
-		}
-	);
+	Vector3 camPos = frameSnapshot->GetCamera().GetPosition();
 
-	std::sort(opaqueObjects.begin(), opaqueObjects.end(),
-		[](ObjectSortState& a, ObjectSortState& b) {
-			return a.distanceFromCamera < b.distanceFromCamera;
+	//The snapshot only holds active objects, so no need to check here
+	for (const RenderSnapshot::Entry& e : frameSnapshot->GetEntries()) {
+		ObjectSortState o;
+		o.object = &e;
+		o.distanceFromCamera = Vector::LengthSquared(camPos - Vector3(e.modelMatrix.GetColumn(3)));
+
+		if (e.type == MaterialType::Opaque) {
+			opaqueObjects.emplace_back(o);
 		}
-	);
+		else if (e.type == MaterialType::Transparent) {
+			transparentObjects.emplace_back(o);
+		}
+	}
+
+	//The two lists are independent, so one is sorted on a worker while we do the other
+	JobCounter opaqueSorted;
+	JobSystem::Get().Run([&]() {
+		std::sort(opaqueObjects.begin(), opaqueObjects.end(),
+			[](ObjectSortState& a, ObjectSortState& b) {
+				return a.distanceFromCamera < b.distanceFromCamera;
+			}
+		);
+	}, &opaqueSorted);
+
 	std::sort(transparentObjects.rbegin(), transparentObjects.rend(),
 		[](ObjectSortState& a, ObjectSortState& b) {
 			return a.distanceFromCamera < b.distanceFromCamera;
 		}
 	);
+	JobSystem::Get().Wait(opaqueSorted);
 }
 
 void GameTechRenderer::RenderShadowMapPass(std::vector<ObjectSortState>& list) {
@@ -495,7 +505,7 @@ void GameTechRenderer::RenderShadowMapPass(std::vector<ObjectSortState>& list) {
 	UseShader(*shadowShader);
 	int mvpLocation = glGetUniformLocation(shadowShader->GetProgramID(), "mvpMatrix");
 
-	Matrix4 shadowViewMatrix = Matrix::View(gameWorld.GetSunPosition(), Vector3(0, 0, 0), Vector3(0, 1, 0));
+	Matrix4 shadowViewMatrix = Matrix::View(frameSnapshot->GetSunPosition(), Vector3(0, 0, 0), Vector3(0, 1, 0));
 	Matrix4 shadowProjMatrix = Matrix::Perspective(100.0f, 500.0f, 1.0f, 45.0f);
 
 	Matrix4 mvMatrix = shadowProjMatrix * shadowViewMatrix;
@@ -503,13 +513,13 @@ void GameTechRenderer::RenderShadowMapPass(std::vector<ObjectSortState>& list) {
 	shadowMatrix = biasMatrix * mvMatrix; //we'll use this one later on
 
 	for (const auto&i : list) {
-		const RenderObject* o = i.object;
+		const RenderSnapshot::Entry* o = i.object;
 
-		Matrix4 modelMatrix = o->GetTransform().GetMatrix();
+		Matrix4 modelMatrix = o->modelMatrix;
 		Matrix4 mvpMatrix	= mvMatrix * modelMatrix;
 		glUniformMatrix4fv(mvpLocation, 1, false, (float*)&mvpMatrix);
-		BindMesh((OGLMesh&)*o->GetMesh());
-		size_t layerCount = o->GetMesh()->GetSubMeshCount();
+		BindMesh((const OGLMesh&)*o->mesh);
+		size_t layerCount = o->mesh->GetSubMeshCount();
 		for (size_t i = 0; i < layerCount; ++i) {
 			DrawBoundMesh((uint32_t)i);
 		}
@@ -569,16 +579,16 @@ void GameTechRenderer::RenderOpaquePass(std::vector<ObjectSortState>& list) {
 
 	// ---- Draw grouped by (mesh + diffuseTex) ----
 	for (size_t i = 0; i < list.size(); ) {
-		const RenderObject* o0 = list[i].object;
-		OGLMesh* mesh0 = (OGLMesh*)o0->GetMesh();
+		const RenderSnapshot::Entry* o0 = list[i].object;
+		const OGLMesh* mesh0 = (const OGLMesh*)o0->mesh;
 
 		// 关键：用 frameObjects 里的 materialID 当分组依据
 		const uint32_t mat0 = frameObjects[base + (uint32_t)i].materialID;
 
 		size_t j = i + 1;
 		for (; j < list.size(); ++j) {
-			const RenderObject* oj = list[j].object;
-			if (oj->GetMesh() != mesh0) break;
+			const RenderSnapshot::Entry* oj = list[j].object;
+			if (oj->mesh != mesh0) break;
 
 			const uint32_t matj = frameObjects[base + (uint32_t)j].materialID;
 			if (matj != mat0) break;
@@ -628,16 +638,16 @@ void GameTechRenderer::RenderTransparentPass(std::vector<ObjectSortState>& list)
 
 	// ---- Draw grouped by (mesh + diffuseTex) ----
 	for (size_t i = 0; i < list.size(); ) {
-		const RenderObject* o0 = list[i].object;
-		OGLMesh* mesh0 = (OGLMesh*)o0->GetMesh();
+		const RenderSnapshot::Entry* o0 = list[i].object;
+		const OGLMesh* mesh0 = (const OGLMesh*)o0->mesh;
 
 		// 关键：用 frameObjects 里的 materialID 当分组依据
 		const uint32_t mat0 = frameObjects[base + (uint32_t)i].materialID;
 
 		size_t j = i + 1;
 		for (; j < list.size(); ++j) {
-			const RenderObject* oj = list[j].object;
-			if (oj->GetMesh() != mesh0) break;
+			const RenderSnapshot::Entry* oj = list[j].object;
+			if (oj->mesh != mesh0) break;
 
 			const uint32_t matj = frameObjects[base + (uint32_t)j].materialID;
 			if (matj != mat0) break;
@@ -663,11 +673,11 @@ void GameTechRenderer::RenderTransparentPass(std::vector<ObjectSortState>& list)
 }
 
 void GameTechRenderer::RenderLines() {
-	const std::vector<Debug::DebugLineEntry>& lines = Debug::GetDebugLines();
+	const std::vector<Debug::DebugLineEntry>& lines = frameSnapshot->GetDebugLines();
 	if (lines.empty()) return;
 
-	Matrix4 viewMatrix = gameWorld.GetMainCamera().BuildViewMatrix();
-	Matrix4 projMatrix = gameWorld.GetMainCamera().BuildProjectionMatrix(hostWindow.GetScreenAspect());
+	Matrix4 viewMatrix = frameSnapshot->GetCamera().BuildViewMatrix();
+	Matrix4 projMatrix = frameSnapshot->GetCamera().BuildProjectionMatrix(hostWindow.GetScreenAspect());
 
 	UseShader(*debugShader);
 	if (!activeShader) return;
@@ -699,7 +709,7 @@ void GameTechRenderer::RenderLines() {
 }
 
 void GameTechRenderer::RenderText() {
-	const std::vector<Debug::DebugStringEntry>& strings = Debug::GetDebugStrings();
+	const std::vector<Debug::DebugStringEntry>& strings = frameSnapshot->GetDebugStrings();
 	if (strings.empty()) return;
 
 	UseShader(*debugShader);
@@ -753,7 +763,7 @@ void GameTechRenderer::RenderText() {
 }
 
 void GameTechRenderer::RenderTextures() {
-	const std::vector<Debug::DebugTexEntry>& texEntries = Debug::GetDebugTex();
+	const std::vector<Debug::DebugTexEntry>& texEntries = frameSnapshot->GetDebugTex();
 	if (texEntries.empty()) return;
 
 	UseShader(*debugShader);
@@ -3,6 +3,8 @@
 #include "GameTechRendererInterface.h"
 #include "OGLMesh.h"
 #include "OGLShader.h"
+#include "RenderSnapshot.h"
+#include "FrameArena.h"
 
 namespace NCL {
 	namespace Rendering {
@@ -25,11 +27,20 @@ namespace NCL {
 
 			Mesh*		LoadMesh(const std::string& name)									override;
 			Texture*	LoadTexture(const std::string& name)								override;
+
+			/*
+			Draw from this snapshot instead of the live world, so the next frame
+			can be simulated while this one is rendered. It must stay untouched
+			until Render returns. Pass nullptr to go back to reading the world.
+			*/
+			void SetRenderSnapshot(const RenderSnapshot* snapshot) {
+				externalSnapshot = snapshot;
+			}
 	
 		protected:
 
 			struct ObjectSortState {
-				const RenderObject* object;
+				const RenderSnapshot::Entry* object;
 				float distanceFromCamera;
 			};
 
@@ -71,13 +82,13 @@ namespace NCL {
 			size_t materialSSBOCount = 0;
 
 			void InitMaterialSSBO();
-			void UpdateMaterialSSBO(const std::vector<MaterialDataCPU>& materials);
+			void UpdateMaterialSSBO(const ArenaVector<MaterialDataCPU>& materials);
 
 			GLuint   mainTexArray = 0;
 			uint32_t mainTexArrayW = 0;
 			uint32_t mainTexArrayH = 0;
 			uint32_t mainTexArrayLayers = 0;
-			void BuildMainTexArray(const std::vector<OGLTexture*>& textures, std::unordered_map<const OGLTexture*, 
+			void BuildMainTexArray(const ArenaVector<OGLTexture*>& textures, ArenaUnorderedMap<const OGLTexture*, 
 				uint32_t>& outLayerMap, uint32_t& outW, uint32_t& outH);
 
 			// -------- Pass data (UBO) --------
@@ -127,6 +138,13 @@ namespace NCL {
 
 			GameWorld&	gameWorld;
 
+			//Scratch space for anything that only lives until the end of RenderFrame
+			FrameArena	frameArena;
+
+			RenderSnapshot			ownSnapshot;
+			const RenderSnapshot*	externalSnapshot	= nullptr;
+			const RenderSnapshot*	frameSnapshot		= nullptr;
+
 			OGLShader*	defaultShader;
 
 			//Skybox pass data
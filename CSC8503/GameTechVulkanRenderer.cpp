@@ -363,15 +363,25 @@ void GameTechVulkanRenderer::RenderFrame() {
 
 	TransitionUndefinedToColour(context.cmdBuffer, context.colourImage);
 
+	//Without a snapshot handed to us, fall back to taking our own from the live world
+	if (externalSnapshot) {
+		frameSnapshot = externalSnapshot;
+	}
+	else {
+		gameWorld.UpdateTransforms();
+		ownSnapshot.Capture(gameWorld);
+		frameSnapshot = &ownSnapshot;
+	}
+
 	GlobalData frameData;
-	frameData.lightColour	= Vector4(gameWorld.GetSunColour(), 1.0f);
+	frameData.lightColour	= Vector4(frameSnapshot->GetSunColour(), 1.0f);
 	frameData.lightRadius	= 1000.0f;
-	frameData.lightPosition = gameWorld.GetSunPosition();
+	frameData.lightPosition = frameSnapshot->GetSunPosition();
 
-	frameData.cameraPos		= gameWorld.GetMainCamera().GetPosition();
+	frameData.cameraPos		= frameSnapshot->GetCamera().GetPosition();
 
-	frameData.viewMatrix	= gameWorld.GetMainCamera().BuildViewMatrix();
-	frameData.projMatrix	= gameWorld.GetMainCamera().BuildProjectionMatrix(Window::GetWindow()->GetScreenAspect());
+	frameData.viewMatrix	= frameSnapshot->GetCamera().BuildViewMatrix();
+	frameData.projMatrix	= frameSnapshot->GetCamera().BuildProjectionMatrix(Window::GetWindow()->GetScreenAspect());
 	frameData.orthoMatrix	= Matrix::Orthographic(0.0f, 100.0f, 100.0f, 0.0f, -1.0f, 1.0f);
 	frameData.shadowMatrix  =	  Matrix::Perspective(50.0f, 5000.0f, 1, 45.0f) 
 								* Matrix::View(frameData.lightPosition, Vector3(0, 0, 0), Vector3(0, 1, 0));
@@ -436,29 +446,21 @@ void GameTechVulkanRenderer::UpdateObjectList() {
 	opaqueObjects.clear();
 	transparentObjects.clear();
 
-	Vector3 camPos = gameWorld.GetMainCamera().GetPosition();
-
-	gameWorld.OperateOnContents(
-		[&](GameObject* o) {
-			if (o->IsActive()) {
-				const RenderObject* g = o->GetRenderObject();
-				if (g && g->GetMesh()) {
-					GameTechMaterial mat = g->GetMaterial();
-
-					ObjectSortState o;
-					o.object = g;
-					o.distanceFromCamera = Vector::LengthSquared(camPos - g->GetTransform().GetPosition());
-
-					if (mat.type == MaterialType::Opaque) {
-						opaqueObjects.emplace_back(o);
-					}
-					else if (mat.type == MaterialType::Transparent) {
-						transparentObjects.emplace_back(o);
-					}
-				}
-			}
+	Vector3 camPos = frameSnapshot->GetCamera().GetPosition();
+
+	//The snapshot only holds active objects, so no need to check here
+	for (const RenderSnapshot::Entry& e : frameSnapshot->GetEntries()) {
+		ObjectSortState o;
+		o.object = &e;
+		o.distanceFromCamera = Vector::LengthSquared(camPos - Vector3(e.modelMatrix.GetColumn(3)));
+
+		if (e.type == MaterialType::Opaque) {
+			opaqueObjects.emplace_back(o);
 		}
-	);
+		else if (e.type == MaterialType::Transparent) {
+			transparentObjects.emplace_back(o);
+		}
+	}
 
 	std::sort(opaqueObjects.begin(), opaqueObjects.end(),
 		[](ObjectSortState& a, ObjectSortState& b) {
@@ -474,14 +476,12 @@ void GameTechVulkanRenderer::UpdateObjectList() {
 	auto objectWriter = [&](std::vector<ObjectSortState>& objects) {
 		for (auto& o : objects) {
 			ObjectState state;
-			state.modelMatrix	= o.object->GetTransform().GetMatrix();
-			state.colour		= o.object->GetColour();
+			state.modelMatrix	= o.object->modelMatrix;
+			state.colour		= o.object->colour;
 			state.index[0]		= 0;
 
-			GameTechMaterial mat = o.object->GetMaterial();
-
-			if (mat.diffuseTex) {
-				VulkanTexture* t = (VulkanTexture*)mat.diffuseTex;
+			if (o.object->diffuseTex) {
+				VulkanTexture* t = (VulkanTexture*)o.object->diffuseTex;
 				state.index[0] = t->GetAssetID();
 			}
 			currentFrame->WriteData<ObjectState>(state);
@@ -504,13 +504,13 @@ void GameTechVulkanRenderer::RenderOpaquePass(std::vector<ObjectSortState>& list
 
 	cmds.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *scenePipeline.layout, 0, (uint32_t)std::size(sets), sets, 0, nullptr);
 
-	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->GetMesh();
+	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->mesh;
 
 	uint32_t	startingIndex = 0;
 	uint32_t	instanceCount = 0;
 
 	for (int i = 0; i < list.size(); ++i) {
-		VulkanMesh* objectMesh = (VulkanMesh*)list[i].object->GetMesh();
+		VulkanMesh* objectMesh = (VulkanMesh*)list[i].object->mesh;
 
 		//The new mesh is different than previous meshes, flush out the old list
 		if (prevMesh != objectMesh) {
@@ -544,7 +544,7 @@ void GameTechVulkanRenderer::RenderTransparentPass(std::vector<ObjectSortState>&
 
 	cmds.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *scenePipeline.layout, 0, (uint32_t)std::size(sets), sets, 0, nullptr);
 
-	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->GetMesh();
+	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->mesh;
 
 	uint32_t	startingIndex = opaqueObjects.size();
 	uint32_t	instanceCount = 0;
@@ -552,7 +552,7 @@ void GameTechVulkanRenderer::RenderTransparentPass(std::vector<ObjectSortState>&
 	for (int i = 0; i < list.size(); ++i) {
 		uint32_t objectIndex = startingIndex + i;
 
-		VulkanMesh* objectMesh = (VulkanMesh*)list[i].object->GetMesh();
+		VulkanMesh* objectMesh = (VulkanMesh*)list[i].object->mesh;
 
 		cmds.pushConstants(*scenePipeline.layout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(uint32_t), (void*)&objectIndex);
 
@@ -577,13 +577,13 @@ void GameTechVulkanRenderer::RenderSceneObjects(VulkanPipeline& pipe, vk::Comman
 
 	cmds.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipe.layout, 0, (uint32_t)std::size(sets), sets, 0, nullptr);
 
-	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->GetMesh();
+	VulkanMesh* prevMesh = (VulkanMesh*)opaqueObjects[0].object->mesh;
 
 	uint32_t	startingIndex = 0;
 	uint32_t	instanceCount = 0;
 
 	for (int i = 0; i < opaqueObjects.size(); ++i) {
-		VulkanMesh* objectMesh = (VulkanMesh*)opaqueObjects[i].object->GetMesh();
+		VulkanMesh* objectMesh = (VulkanMesh*)opaqueObjects[i].object->mesh;
 
 		//The new mesh is different than previous meshes, flush out the old list
 		if (prevMesh != objectMesh) {
@@ -613,9 +613,9 @@ void GameTechVulkanRenderer::RenderSkybox(vk::CommandBuffer cmds) {
 }
 
 void GameTechVulkanRenderer::UpdateDebugData() {
-	const std::vector<Debug::DebugStringEntry>& strings = Debug::GetDebugStrings();
-	const std::vector<Debug::DebugLineEntry>&   lines	= Debug::GetDebugLines();
-	const std::vector<Debug::DebugTexEntry>&	tex		= Debug::GetDebugTex();
+	const std::vector<Debug::DebugStringEntry>& strings = frameSnapshot->GetDebugStrings();
+	const std::vector<Debug::DebugLineEntry>&   lines	= frameSnapshot->GetDebugLines();
+	const std::vector<Debug::DebugTexEntry>&	tex		= frameSnapshot->GetDebugTex();
 
 	currentFrame->textVertCount		= 0;
 	currentFrame->lineVertCount		= 0;
@@ -4,6 +4,7 @@
 #include "GameTechRendererInterface.h"
 #include "VulkanMesh.h"
 #include "SmartTypes.h"
+#include "RenderSnapshot.h"
 
 #include "../GLTFLoader/GLTFLoader.h"
 
@@ -32,6 +33,15 @@ namespace NCL {
 			Mesh*	 LoadMesh(const string& name);
 			Texture* LoadTexture(const string& name);
 
+			/*
+			Draw from this snapshot instead of the live world, so the next frame
+			can be simulated while this one is rendered. It must stay untouched
+			until Render returns. Pass nullptr to go back to reading the world.
+			*/
+			void SetRenderSnapshot(const RenderSnapshot* snapshot) {
+				externalSnapshot = snapshot;
+			}
+
 		protected:
 			struct GlobalData {
 				Matrix4 shadowMatrix;
@@ -57,7 +67,7 @@ namespace NCL {
 			};
 
 			struct ObjectSortState {
-				const RenderObject* object;
+				const RenderSnapshot::Entry* object;
 				float distanceFromCamera;
 			};
 
@@ -132,7 +142,10 @@ namespace NCL {
 				const std::string& debugName = "CubeMap");
 
 			GameWorld& gameWorld;
-			std::vector<const RenderObject*> activeObjects;
+
+			RenderSnapshot			ownSnapshot;
+			const RenderSnapshot*	externalSnapshot	= nullptr;
+			const RenderSnapshot*	frameSnapshot		= nullptr;
 
 			std::vector<ObjectSortState> opaqueObjects;
 			std::vector<ObjectSortState> transparentObjects;
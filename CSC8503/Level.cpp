@@ -43,9 +43,6 @@ void Level::ClearWorld() {
 
     // MyGame already calls ClearAndErase + physics.Clear before Build()
     // This is here as an optional helper if a level wants to rebuild itself
-    if (context.metalObjects) {
-        context.metalObjects->clear();
-    }
     if (context.playerOut) {
         *context.playerOut = nullptr;
     }
@@ -54,6 +51,24 @@ void Level::ClearWorld() {
     }*/
 }
 
+PhysicsObject* Level::AttachParts(GameObject* o, CollisionVolume* volume, Mesh* mesh, const Vector4& colour, float inverseMass) {
+    o->SetBoundingVolume(volume);
+
+    o->SetRenderObject(new RenderObject(o->GetTransform(), mesh, notexMaterial));
+    o->GetRenderObject()->SetColour(colour);
+
+    PhysicsObject* po = new PhysicsObject(o->GetTransform(), o->GetBoundingVolume());
+    po->SetInverseMass(inverseMass);
+    if (volume->type == VolumeType::Sphere) {
+        po->InitSphereInertia();
+    }
+    else {
+        po->InitCubeInertia();
+    }
+    o->SetPhysicsObject(po);
+    return po;
+}
+
 GameObject* Level::AddFloorToWorld(const Vector3& position) {
     EnsureAssetsLoaded();
     if (!context.world) return nullptr;
@@ -61,19 +76,11 @@ GameObject* Level::AddFloorToWorld(const Vector3& position) {
     GameObject* floor = new GameObject("Floor");
 
     Vector3 floorHalfSize = Vector3(200, 1, 200);
-    AABBVolume* volume = new AABBVolume(floorHalfSize);
-    floor->SetBoundingVolume(volume);
-
     floor->GetTransform()
         .SetScale(floorHalfSize * 2.0f)
         .SetPosition(position);
 
-    floor->SetRenderObject(new RenderObject(floor->GetTransform(), cubeMesh, notexMaterial));
-    floor->GetRenderObject()->SetColour(Vector4(0.25f, 0.25f, 0.25f, 1.0f));
-
-    floor->SetPhysicsObject(new PhysicsObject(floor->GetTransform(), floor->GetBoundingVolume()));
-    floor->GetPhysicsObject()->SetInverseMass(0.0f);
-    floor->GetPhysicsObject()->InitCubeInertia();
+    AttachParts(floor, new AABBVolume(floorHalfSize), cubeMesh, Vector4(0.25f, 0.25f, 0.25f, 1.0f), 0.0f);
 
     context.world->AddGameObject(floor);
     return floor;
@@ -85,21 +92,12 @@ Player* Level::AddPlayerToWorld(const Vector3& position, float radius, float inv
 
     Player* p = new Player(context.world);
 
-    SphereVolume* volume = new SphereVolume(radius * 0.5f);
-    p->SetBoundingVolume(volume);
-
     p->GetTransform()
         .SetScale(Vector3(radius, radius, radius))
         .SetPosition(position);
 
-    p->SetRenderObject(new RenderObject(p->GetTransform(), playerMesh, notexMaterial));
-    p->GetRenderObject()->SetColour(Vector4(0, 1, 1, 1));
-
-    PhysicsObject* po = new PhysicsObject(p->GetTransform(), p->GetBoundingVolume());
-    po->SetInverseMass(inverseMass);
-    po->InitSphereInertia();
+    PhysicsObject* po = AttachParts(p, new SphereVolume(radius * 0.5f), playerMesh, Vector4(0, 1, 1, 1), inverseMass);
     po->SetElasticity(0.0f); // no bounciness
-    p->SetPhysicsObject(po);
 
     context.world->AddGameObject(p);
 
@@ -120,25 +118,14 @@ MetalObject* Level::AddMetalCubeToWorld(const Vector3& position,
 
     // Keep your existing MetalObject default construction
     MetalObject* cube = new MetalObject();
-    AABBVolume* volume = new AABBVolume(halfDims);
-    cube->SetBoundingVolume(volume);
 
     cube->GetTransform()
         .SetPosition(position)
         .SetScale(halfDims * 2.0f);
 
-    cube->SetRenderObject(new RenderObject(cube->GetTransform(), cubeMesh, notexMaterial));
-    cube->GetRenderObject()->SetColour(colour);
-
-    cube->SetPhysicsObject(new PhysicsObject(cube->GetTransform(), cube->GetBoundingVolume()));
-    cube->GetPhysicsObject()->SetInverseMass(inverseMass);
-    cube->GetPhysicsObject()->InitCubeInertia();
+    AttachParts(cube, new AABBVolume(halfDims), cubeMesh, colour, inverseMass);
 
-    context.world->AddGameObject(cube);
-
-    if (context.metalObjects) {
-        context.metalObjects->push_back(cube);
-    }
+    context.world->AddGameObject(cube); // the world indexes it by its metal tag
 
     return cube;
 }
@@ -160,20 +147,13 @@ DialogueNPC* Level::AddDialogueNPCToWorld(const std::string& dialogueGraphId, co
     if (!context.world) return nullptr;
 
 	DialogueNPC* npc = new DialogueNPC(dialogueGraphId, interactRadius);
-    SphereVolume* volume = new SphereVolume(radius * 0.5f);
-	npc->SetBoundingVolume(volume);
 
     npc->GetTransform()
         .SetScale(Vector3(radius, radius, radius))
 		.SetPosition(position);
-	npc->SetRenderObject(new RenderObject(npc->GetTransform(), NPCMesh, notexMaterial));
-	npc->GetRenderObject()->SetColour(colour);
 
-	PhysicsObject* NPCpo = new PhysicsObject(npc->GetTransform(), npc->GetBoundingVolume());
-    NPCpo->SetInverseMass(inverseMass);
-    NPCpo->InitSphereInertia();
+	PhysicsObject* NPCpo = AttachParts(npc, new SphereVolume(radius * 0.5f), NPCMesh, colour, inverseMass);
     NPCpo->SetElasticity(0.0f); // no bounciness
-    npc->SetPhysicsObject(NPCpo);
 
 	context.world->AddGameObject(npc);
 
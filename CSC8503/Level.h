@@ -5,11 +5,13 @@
 
 #include "Vector.h"
 #include "RenderObject.h" // GameTechMaterial, Rendering::Mesh/Texture forward deps in this framework
+#include "GameObjectHandle.h"
 #include "Dialogue/DialogueNPC.h"
 #include "Dialogue/DialogueDB.h"
 #include "Dialogue/DialogueSystem.h"
 
 namespace NCL {
+    class CollisionVolume;
     namespace Rendering {
         class Mesh;
         class Texture;
@@ -23,6 +25,7 @@ namespace NCL::CSC8503 {
     class GameObject;
     class Player;
     class MetalObject;
+    class PhysicsObject;
 
     struct LevelContext {
         GameWorld* world = nullptr;
@@ -30,7 +33,6 @@ namespace NCL::CSC8503 {
         GameTechRendererInterface* renderer = nullptr;
 
         // Optional outputs / shared lists owned by MyGame
-        std::vector<MetalObject*>* metalObjects = nullptr;
         std::vector<DialogueNPC*>* dialogueNPCs = nullptr;
         Player** playerOut = nullptr;
     };
@@ -54,6 +56,11 @@ namespace NCL::CSC8503 {
         DialogueNPC* AddDialogueNPCToWorld(const std::string& dialogueGraphId, const NCL::Maths::Vector3& position,
             float radius, float inverseMass, const Vector4& colour, float interactRadius = 6.0f);
 
+        // Gives an object its volume, render and physics parts in one go, so each comes out of
+        // its pool right after the last object's. Returns the physics part for any extra tweaks.
+        PhysicsObject* AttachParts(GameObject* o, CollisionVolume* volume, NCL::Rendering::Mesh* mesh,
+            const NCL::Maths::Vector4& colour, float inverseMass);
+
         void ClearWorld();
 
         bool LoadDialogue(const std::string& filepath);
@@ -26,6 +26,8 @@
 #include "BehaviourAction.h"
 
 #include "PhysicsSystem.h"
+#include "JobSystem.h"
+#include "RenderSnapshot.h"
 
 #ifdef USEOPENGL
 #include "GameTechRenderer.h"
@@ -76,6 +78,8 @@ int main() {
 	w->ShowOSPointer(false);
 	w->LockMouseToWindow(true);
 
+	JobSystem::Get().Initialise(); //one worker per spare hardware thread
+
 	GameWorld* world = new GameWorld();
 	PhysicsSystem* physics = new PhysicsSystem(*world);
 
@@ -88,6 +92,18 @@ int main() {
 	//TutorialGame* g = new TutorialGame(*world, *renderer, *physics);
 	MyGame* mg = new MyGame(*world, *renderer, *physics);
 
+	/*
+	Simulation and rendering are pipelined - while frame N is drawn from
+	the snapshot captured at the end of the last simulation step, frame N+1
+	is simulated on a worker and captured into the other snapshot. The two
+	only meet at the end of the loop, so frame time is the longer of the
+	two rather than their sum.
+	*/
+	RenderSnapshot	frameSnapshots[2];
+	int				renderIndex = 0;
+	world->UpdateTransforms();
+	frameSnapshots[renderIndex].Capture(*world);
+
 	w->GetTimer().GetTimeDeltaSeconds(); //Clear the timer so we don't get a larget first dt!
 	while (w->UpdateWindow() && !Window::GetKeyboard()->KeyDown(KeyCodes::ESCAPE)) {
 		float dt = w->GetTimer().GetTimeDeltaSeconds();
@@ -108,14 +124,29 @@ int main() {
 
 		w->SetTitle("Gametech frame time:" + std::to_string(1000.0f * dt));
 
-		mg->UpdateGame(dt);
+		RenderSnapshot& captureTo = frameSnapshots[1 - renderIndex];
+
+		JobCounter simulation;
+		JobSystem::Get().Run([&]() {
+			mg->UpdateGame(dt);
 
-		world->UpdateWorld(dt);
-		physics->Update(dt);
+			world->UpdateWorld(dt);
+			physics->Update(dt);
+
+			world->UpdateTransforms();
+			captureTo.Capture(*world);
+			Debug::UpdateRenderables(dt);
+		}, &simulation);
+
+		renderer->SetRenderSnapshot(&frameSnapshots[renderIndex]);
 		renderer->Update(dt);	
 		renderer->Render();
-		
-		Debug::UpdateRenderables(dt);
+
+		//Sync point - the world is no longer changing, so anything that had to wait for the main thread happens now
+		JobSystem::Get().Wait(simulation);
+		JobSystem::Get().RunMainThreadJobs();
+		renderIndex = 1 - renderIndex;
 	}
+	JobSystem::Get().Shutdown();
 	Window::DestroyGameWindow();
 }
\ No newline at end of file
@@ -1,3 +1,12 @@
 #include "MetalObject.h"
 
-// Intentionally empty: behaviour is driven by PhysicsObject forces applied externally.
+using namespace NCL::CSC8503;
+
+// Behaviour is driven by PhysicsObject forces applied externally.
+MetalObject::~MetalObject() {
+}
+
+Tag MetalObject::GetMetalTag() {
+    static const Tag metalTag(NameID("Metal"));
+    return metalTag;
+}
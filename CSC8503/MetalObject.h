@@ -6,10 +6,15 @@ namespace NCL::CSC8503 {
     /*
         MetalObject: objects that can be affected by the player's pull / push.
         Keep it minimal so it fits the existing NCL framework without extra dependencies.
+        Every MetalObject carries the metal tag, so the world keeps the list of them for us.
     */
     class MetalObject : public GameObject {
     public:
-        MetalObject(const std::string& name = "MetalObject") : GameObject(name) {}
+        MetalObject(const std::string& name = "MetalObject") : GameObject(name) {
+            AddTag(GetMetalTag());
+        }
         ~MetalObject();
+
+        static Tag GetMetalTag();
     };
 }
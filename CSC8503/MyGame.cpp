@@ -11,11 +11,15 @@
 
 #include "Window.h"
 #include "Debug.h"
+#include "JobSystem.h"
 #include "KeyboardMouseController.h"
+#include "NavigationBaker.h"
 
 #include "GameTechRendererInterface.h"
 #include "Ray.h"
 
+#include <iostream>
+
 using namespace NCL;
 using namespace NCL::Maths;
 using namespace NCL::CSC8503;
@@ -48,10 +52,31 @@ MyGame::~MyGame() {
     controller = nullptr;
 }
 
+// Restart the level from the snapshot taken when it was built - much cheaper than
+// tearing the world down and reloading it. Falls back to a full rebuild if the
+// world has changed shape since (objects added/removed at runtime).
+void MyGame::ResetGame() {
+    // Gameplay state isn't in the snapshot, so it's reset here whichever way the level comes back
+    DialogueSystem::Get().ForceEnd();
+
+    // Queued adds and removes go in first, so a pending change counts as the world changing shape
+    world.FlushCommands();
+    if (levelStartState && physics.ReadSnapshot(*levelStartState)) {
+        if (player) {
+            player->ResetState();
+        }
+        return;
+    }
+    // Rebuilding loads meshes, which needs the graphics context - so it's left for the main thread's sync point
+    JobSystem::Get().Run([this]() { InitWorld(); }, nullptr, JobAffinity::MainThread);
+}
+
 void MyGame::UpdateGame(float dt) {
     // Update camera controller (free look), then we apply follow camera
     world.GetMainCamera().UpdateCamera(dt);
 
+    UpdateNavMesh();
+
     if (!player) return;
 
 	// Dialogue interaction check (simple proximity check)
@@ -77,12 +102,21 @@ void MyGame::UpdateGame(float dt) {
 
 	// GameMechanic: Pull/push interaction
     SetCameraToPlayer(player);
-    player->Update(dt);
+    updateScheduler.Update(world, dt); // every object's update, the player's included
     ApplyPullPush(player);
 
     Debug::Print("LMB: Pull | RMB: Push | F: lock on object", Vector2(5, 5), Vector4(1, 1, 1, 1));
 
-    // update physics/world
+    if (kb->KeyPressed(KeyCodes::F1)) {
+        ResetGame();
+        return;
+    }
+    if (kb->KeyPressed(KeyCodes::F2)) {
+        SaveNavMesh();
+    }
+
+    // update physics/world - gameplay's deferred adds and removes go in first, so physics sees them this frame
+    world.FlushCommands();
     physics.Update(dt);
     world.UpdateWorld(dt);
 }
@@ -98,10 +132,12 @@ void MyGame::InitCamera() {
 void MyGame::InitWorld() {
     world.ClearAndErase();
     physics.Clear();
-    metalObjects.clear();
     dialogueNPCs.clear();
     player = nullptr;
 
+    snapshotPool.Release(levelStartState);
+    levelStartState = nullptr;
+
     // Build via Level (so teammates can own Level.cpp/h without touching MyGame)
     currentLevel = LevelRegistry::Get().Create(0);
     if (!currentLevel) {
@@ -112,16 +148,52 @@ void MyGame::InitWorld() {
     ctx.world = &world;
     ctx.physics = &physics;
     ctx.renderer = &renderer;
-    ctx.metalObjects = &metalObjects;
     ctx.playerOut = &player;
     ctx.dialogueNPCs = &dialogueNPCs;
 
     currentLevel->SetContext(ctx);
     currentLevel->Build();
 
-    // Let Player do pre-lock selection on our metal list
-    if (player) {
-        player->SetMetalObjects(&metalObjects);
+    BuildNavMesh();
+
+    levelStartState = snapshotPool.Acquire();
+    physics.WriteSnapshot(*levelStartState);
+}
+
+void MyGame::BuildNavMesh() {
+    NavMeshGeometry geometry;
+    geometry.AddWorld(world);
+    navBuilder.SetGeometry(geometry);
+    navBuilder.BuildAllTiles();
+    RefreshNavMesh();
+}
+
+void MyGame::RebuildNavMesh(const Vector3& boundsMin, const Vector3& boundsMax) {
+    NavMeshGeometry geometry;
+    geometry.AddWorld(world);
+    navBuilder.SetGeometry(geometry);
+    navBuilder.RebuildTiles(boundsMin, boundsMax);
+}
+
+// Tiles rebuilt in the background are swapped in once they're done
+void MyGame::UpdateNavMesh() {
+    if (navBuilder.Update()) {
+        RefreshNavMesh();
+    }
+}
+
+void MyGame::RefreshNavMesh() {
+    std::vector<Vector3> verts;
+    std::vector<int> indices;
+    std::vector<int> neighbours;
+    navBuilder.GetMesh(verts, indices, neighbours);
+    navMesh = std::make_unique<NavigationMesh>(verts, indices, neighbours);
+}
+
+// Writes the level's navmesh out as text, then bakes it, so it can be shipped and mapped in instead of built at load
+void MyGame::SaveNavMesh() {
+    if (navBuilder.SaveMesh("Level00.navmesh") && NavigationBaker::BakeMesh("Level00.navmesh", "Level00.navbin")) {
+        std::cout << "Saved navmesh to Level00.navmesh and Level00.navbin\n";
     }
 }
 
@@ -169,7 +241,7 @@ void MyGame::ApplyPullPush(Player* p) {
         return;
     }
 
-    if (metalObjects.empty()) return;
+    if (world.GetObjectsWithTag(MetalObject::GetMetalTag()).empty()) return;
 
     Vector3 origin = p->GetMagnetOrigin();
 
@@ -208,8 +280,8 @@ void MyGame::ApplyPullPush(Player* p) {
         GameObject* hitGO = static_cast<GameObject*>(hit.node);
         if (!hitGO) return;
 
-        // 3.Only allow metallic objects (currently filtered by name)
-        if (hitGO->GetName().find("MetalObject") == std::string::npos) return;
+        // 3.Only allow metallic objects
+        if (!hitGO->HasTag(MetalObject::GetMetalTag())) return;
 
         objPhys = hitGO->GetPhysicsObject();
         if (!objPhys) return;
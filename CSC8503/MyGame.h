@@ -3,6 +3,10 @@
 #include "Player.h"
 #include "MetalObject.h"
 #include "Dialogue/DialogueNPC.h" 
+#include "WorldSnapshot.h"
+#include "UpdateScheduler.h"
+#include "NavMeshBuilder.h"
+#include "NavigationMesh.h"
 
 #include <vector>
 #include <memory>
@@ -22,12 +26,23 @@ namespace NCL {
             ~MyGame();
 
             void UpdateGame(float dt);
-            void ResetGame() { InitWorld(); }
+            void ResetGame();
+
+            // Builds the navmesh around part of the level again in the background - call it once static geometry there has changed
+            void RebuildNavMesh(const Vector3& boundsMin, const Vector3& boundsMax);
+
+            const NavigationMesh* GetNavMesh() const { return navMesh.get(); }
 
         private:
             void InitCamera();
             void InitWorld();
 
+            // Navmesh from the level's static collision geometry
+            void BuildNavMesh();
+            void UpdateNavMesh();
+            void RefreshNavMesh();
+            void SaveNavMesh();
+
             // Camera follow logic
             void SetCameraToPlayer(Player* player);
 
@@ -40,13 +55,20 @@ namespace NCL {
             PhysicsSystem& physics;
 
             Controller* controller = nullptr;
+            UpdateScheduler updateScheduler;
 
             Player* player = nullptr;
 
-            std::vector<MetalObject*> metalObjects; // All metal objects that can be pulled / pushed
 			std::vector<DialogueNPC*> dialogueNPCs; // List of dialogue NPCs for interaction checks
             std::unique_ptr<Level> currentLevel; // Current level instance
 
+            // Level restart: physics state captured right after Build, restored instead of rebuilding
+            SnapshotPool snapshotPool;
+            WorldSnapshot* levelStartState = nullptr;
+
+            NavMeshBuilder navBuilder;
+            std::unique_ptr<NavigationMesh> navMesh;
+
             // Magnet tuning (simple)
             float interactConeDot = 0.6f;   // >0.6 means roughly in front
             float interactForce = 250.0f;   // base force magnitude (F). Acceleration will depend on mass automatically.
@@ -101,16 +101,8 @@ void NetworkedGame::UpdateAsClient(float dt) {
 }
 
 void NetworkedGame::BroadcastSnapshot(bool deltaFrame) {
-	std::vector<GameObject*>::const_iterator first;
-	std::vector<GameObject*>::const_iterator last;
-
-	world.GetObjectIterators(first, last);
-
-	for (auto i = first; i != last; ++i) {
-		NetworkObject* o = (*i)->GetNetworkObject();
-		if (!o) {
-			continue;
-		}
+	//Only networked objects are in here - everything else in the world is skipped for free
+	for (NetworkObject* o : world.GetNetworkComponents().GetComponents()) {
 		//TODO - you'll need some way of determining
 		//when a player has sent the server an acknowledgement
 		//and store the lastID somewhere. A map between player
@@ -118,11 +110,11 @@ void NetworkedGame::BroadcastSnapshot(bool deltaFrame) {
 		//NetworkPlayer struct. 
 		int playerState = 0;
 		GamePacket* newPacket = nullptr;
-		if (o->WritePacket(&newPacket, deltaFrame, playerState)) {
-			thisServer->SendGlobalPacket(*newPacket);
-			delete newPacket;
+		if (o->WritePacket(&newPacket, deltaFrame, playerState, packetArena)) {
+			thisServer->SendGlobalPacket(*newPacket); //enet copies the packet, so we're done with it after this
 		}
 	}
+	packetArena.Reset();
 }
 
 void NetworkedGame::UpdateMinimumState() {
@@ -136,15 +128,7 @@ void NetworkedGame::UpdateMinimumState() {
 	}
 	//every client has acknowledged reaching at least state minID
 	//so we can get rid of any old states!
-	std::vector<GameObject*>::const_iterator first;
-	std::vector<GameObject*>::const_iterator last;
-	world.GetObjectIterators(first, last);
-
-	for (auto i = first; i != last; ++i) {
-		NetworkObject* o = (*i)->GetNetworkObject();
-		if (!o) {
-			continue;
-		}
+	for (NetworkObject* o : world.GetNetworkComponents().GetComponents()) {
 		o->UpdateStateHistory(minID); //clear out old states so they arent taking up memory...
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "TutorialGame.h"
 #include "NetworkBase.h"
+#include "FrameArena.h"
 
 namespace NCL::CSC8503 {
 	class GameServer;
@@ -35,6 +36,8 @@ namespace NCL::CSC8503 {
 		void UpdateMinimumState();
 		std::map<int, int> stateIDs;
 
+		FrameArena packetArena; //snapshot packets only live until they've been handed to enet
+
 		GameServer* thisServer;
 		GameClient* thisClient;
 		float timeToNextPacket;
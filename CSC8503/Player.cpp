@@ -15,6 +15,25 @@ Player::Player(GameWorld* world)
 
 Player::~Player() = default;
 
+void Player::ResetState() {
+    ignoreInput = false;
+    canDoubleJump = false;
+    currentInputs = PlayerInputs();
+    lockMode = LockMode::PreLock;
+    preTarget = GameObjectHandle();
+    hardTarget = GameObjectHandle();
+}
+
+MetalObject* Player::ResolveMetal(GameObjectHandle h) const {
+    if (!gameWorld) return nullptr;
+    // The Metal tag can be given to anything, so check it really is one
+    return dynamic_cast<MetalObject*>(gameWorld->GetGameObject(h));
+}
+
+MetalObject* Player::GetLockedTarget() const {
+    return ResolveMetal(hardTarget);
+}
+
 void Player::Update(float dt) {
     if (!gameWorld) return;
 
@@ -28,25 +47,30 @@ void Player::Update(float dt) {
 	// Debug lines to targets
 	if (lockMode == LockMode::PreLock) {
         preTarget = SelectBestPreTarget(); // always update pre-target
-        if (preTarget) {
-            Vector3 pos = preTarget->GetTransform().GetPosition();
+        if (MetalObject* target = ResolveMetal(preTarget)) {
+            Vector3 pos = target->GetTransform().GetPosition();
             Debug::DrawLine(player_position, pos, Vector4(1.0f, 0.55f, 0.0f, 0.1f)); // orange for pre-target
         }
     }
 
     if (lockMode == LockMode::HardLock) {
-        if (hardTarget) {
-            Vector3 pos = hardTarget->GetTransform().GetPosition();
+        if (MetalObject* target = ResolveMetal(hardTarget)) {
+            Vector3 pos = target->GetTransform().GetPosition();
             Debug::DrawLine(player_position, pos, Vector4(1.0f, 0.55f, 0.0f, 0.8f));
 
 			// if hard-locked, but somehow target got out of range, drop lock  // not works
-            Vector3 toTarget = hardTarget->GetTransform().GetPosition() - player_position;
+            Vector3 toTarget = target->GetTransform().GetPosition() - player_position;
             float dist = Vector::Length(toTarget);
             if (dist > lockRadius) {
                 lockMode = LockMode::PreLock;
-                hardTarget = nullptr;
+                hardTarget = GameObjectHandle();
             }
         }
+        else {
+            // target was removed from the world while we were locked on
+            lockMode = LockMode::PreLock;
+            hardTarget = GameObjectHandle();
+        }
     }
 
     PlayerControl(dt);
@@ -79,13 +103,13 @@ void Player::ReadLocalInput() {
 
 	// F: toggle lock-on mode
     if (Window::GetKeyboard()->KeyPressed(KeyCodes::F)) {
-        if (preTarget && !hardTarget) {
+        if (ResolveMetal(preTarget) && hardTarget.IsNull()) {
             lockMode = LockMode::HardLock;
             hardTarget = preTarget;
         }
-        else if (hardTarget) {
+        else if (!hardTarget.IsNull()) {
             lockMode = LockMode::PreLock;
-            hardTarget = nullptr;
+            hardTarget = GameObjectHandle();
         }
     }
 }
@@ -161,19 +185,18 @@ Vector3 Player::GetAimForward() {
 }
 
 // select best pre-target based on camera position/direction
-MetalObject* Player::SelectBestPreTarget() {
+GameObjectHandle Player::SelectBestPreTarget() {
     auto& cam = gameWorld->GetMainCamera();
     Vector3 camFwd = Vector::Normalise(cam.GetForwardVector());
     Vector3 playerPos = transform.GetPosition();
 
-    MetalObject* best = nullptr;
+    GameObjectHandle best;
     float bestCenter = 1e9f;
     float bestDist = 1e9f;
 
-	if (!metalObjects) return nullptr;
-
-	for (MetalObject* obj : *metalObjects) { // list of potential targets
-        if (!obj) continue;
+	for (GameObject* candidate : gameWorld->GetObjectsWithTag(MetalObject::GetMetalTag())) { // list of potential targets
+        MetalObject* obj = dynamic_cast<MetalObject*>(candidate);
+        if (!obj) continue; // tagged Metal, but not a MetalObject
 
         Vector3 objPos = obj->GetTransform().GetPosition();
         Vector3 toObj = objPos - playerPos;
@@ -203,7 +226,7 @@ MetalObject* Player::SelectBestPreTarget() {
         else if (fabs(centerError - bestCenter) <= centerTieEps && distPlayer < bestDist) better = true;
 
         if (better) {
-            best = obj;
+            best = obj->GetHandle();
             bestCenter = centerError;
             bestDist = distPlayer;
         }
@@ -31,12 +31,11 @@ namespace NCL::CSC8503 {
         bool GetIgnoreInput() const { return ignoreInput; }
         void SetPlayerInput(const PlayerInputs& inputs) { currentInputs = inputs; }
 
-        void SetMetalObjects(const std::vector<MetalObject*>* list) { metalObjects = list; }
+        // Back to how it was when spawned - the physics snapshot only covers the body, not this
+        void ResetState();
 
-		// Get the current target based on lock mode. Will return nullptr if no valid target.
-        MetalObject* GetLockedTarget() const {
-            return hardTarget;
-        }
+		// Get the current target based on lock mode. Will return nullptr if no valid target (or it has been removed).
+        MetalObject* GetLockedTarget() const;
 		float GetLockRadius() const { return lockRadius; }
         bool IsPullHeld() const { return currentInputs.pullHeld; }
         bool IsPushHeld() const { return currentInputs.pushHeld; }
@@ -48,7 +47,8 @@ namespace NCL::CSC8503 {
         void PlayerControl(float dt);
         bool IsPlayerOnGround();
         void ReadLocalInput();
-        MetalObject* SelectBestPreTarget();
+        GameObjectHandle SelectBestPreTarget();
+        MetalObject* ResolveMetal(GameObjectHandle h) const;
 
     private:
         GameWorld* gameWorld = nullptr;
@@ -58,15 +58,13 @@ namespace NCL::CSC8503 {
         PlayerInputs currentInputs;
 
         LockMode lockMode = LockMode::PreLock;
-        MetalObject* preTarget = nullptr;
-        MetalObject* hardTarget = nullptr;
+        GameObjectHandle preTarget;
+        GameObjectHandle hardTarget;
 
 		float lockRadius = 60.0f; // Max distance for locking onto targets and for pull/push interactions
         float minFacingDot = 0.15f;
         float centerTieEps = 0.02f;
 
-        const std::vector<MetalObject*>* metalObjects = nullptr;
-
         float moveForce = 60.0f;
         float maxSpeed = 15.0f;
         float rotationSpeed = 10.0f;
@@ -12,6 +12,15 @@ namespace NCL {
 
             virtual void Update(float dt);
 
+            //Only ever moves itself, so its state machines can all be stepped in parallel
+            UpdatePhaseMask GetUpdatePhases() const override {
+                return UpdatePhaseBit(UpdatePhase::Apply);
+            }
+
+            void RunUpdatePhase(UpdatePhase phase, float dt) override {
+                Update(dt);
+            }
+
         protected:
             void MoveLeft(float dt);
             void MoveRight(float dt);
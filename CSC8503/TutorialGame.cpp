@@ -168,11 +168,7 @@ void TutorialGame::UpdateGame(float dt) {
 	SelectObject();
 	MoveSelectedObject();	
 	
-	world.OperateOnContents(
-		[dt](GameObject* o) {
-			o->Update(dt);
-		}
-	);
+	updateScheduler.Update(world, dt);
 }
 
 void TutorialGame::InitCamera() {
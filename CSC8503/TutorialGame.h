@@ -1,5 +1,6 @@
 #pragma once
 #include "RenderObject.h"
+#include "UpdateScheduler.h"
 namespace NCL {
 	class Controller;
 
@@ -54,6 +55,7 @@ namespace NCL {
 			GameTechRendererInterface& renderer;
 			PhysicsSystem& physics;
 			Controller* controller;
+			UpdateScheduler updateScheduler;
 
 			bool useGravity;
 			bool inSelectionMode;
@@ -3,7 +3,7 @@
 
 namespace NCL {
 	using namespace NCL::Maths;
-	class AABBVolume : public CollisionVolume
+	class AABBVolume : public CollisionVolume, public PoolAllocated<AABBVolume>
 	{
 	public:
 		AABBVolume(const Vector3& halfDims) {
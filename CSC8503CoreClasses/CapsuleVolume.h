@@ -2,7 +2,7 @@
 #include "CollisionVolume.h"
 
 namespace NCL {
-    class CapsuleVolume : public CollisionVolume
+    class CapsuleVolume : public CollisionVolume, public PoolAllocated<CapsuleVolume>
     {
     public:
         CapsuleVolume(float halfHeight, float radius) {
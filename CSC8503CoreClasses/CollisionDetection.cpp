@@ -418,6 +418,37 @@ bool CollisionDetection::OBBIntersection(const OBBVolume& volumeA, const Transfo
 		Vector::Dot(tWorld, A[2])
 	);
 
+	/*
+	Temporal coherence: collisionInfo.satAxis holds the axis that separated
+	(or least penetrated) this pair last substep. Axes are numbered 0-2 for A,
+	3-5 for B and 6-14 for the Ai x Bj edge axes. A pair that was apart last
+	substep is almost always still apart along the same axis, so test that one
+	on its own first and skip the other 14.
+	*/
+	auto axisSeparates = [&](int k) {
+		if (k < 3) {
+			float rb = halfSizeB.x * absR[k][0] + halfSizeB.y * absR[k][1] + halfSizeB.z * absR[k][2];
+			return std::fabs(t[k]) > halfSizeA[k] + rb;
+		}
+		if (k < 6) {
+			int j = k - 3;
+			float ra = halfSizeA.x * absR[0][j] + halfSizeA.y * absR[1][j] + halfSizeA.z * absR[2][j];
+			return std::fabs(t.x * R[0][j] + t.y * R[1][j] + t.z * R[2][j]) > ra + halfSizeB[j];
+		}
+		int i = (k - 6) / 3;
+		int j = (k - 6) % 3;
+		Vector3 axis = Vector::Cross(A[i], B[j]);
+		if (Vector::Dot(axis, axis) < EPSILON * EPSILON) {
+			return false;
+		}
+		float ra = halfSizeA[(i + 1) % 3] * absR[(i + 2) % 3][j] + halfSizeA[(i + 2) % 3] * absR[(i + 1) % 3][j];
+		float rb = halfSizeB[(j + 1) % 3] * absR[i][(j + 2) % 3] + halfSizeB[(j + 2) % 3] * absR[i][(j + 1) % 3];
+		return std::fabs(t[(i + 2) % 3] * R[(i + 1) % 3][j] - t[(i + 1) % 3] * R[(i + 2) % 3][j]) > ra + rb;
+	};
+	if (collisionInfo.satAxis >= 0 && collisionInfo.satAxis < 15 && axisSeparates(collisionInfo.satAxis)) {
+		return false;
+	}
+
 	float minPenetration = FLT_MAX;
 	Vector3 bestAxis;     // ��ײ���ߣ�����ռ䣩
 
@@ -450,6 +481,7 @@ bool CollisionDetection::OBBIntersection(const OBBVolume& volumeA, const Transfo
 
 		float dist = std::fabs(t[i]);
 		if (dist > ra + rb) {
+			collisionInfo.satAxis = i;
 			return false; // �ҵ������ᣬû����
 		}
 
@@ -477,6 +509,7 @@ bool CollisionDetection::OBBIntersection(const OBBVolume& volumeA, const Transfo
 		float dist = std::fabs(distSigned);
 
 		if (dist > ra + rb) {
+			collisionInfo.satAxis = 3 + j;
 			return false; // ������
 		}
 
@@ -515,6 +548,7 @@ bool CollisionDetection::OBBIntersection(const OBBVolume& volumeA, const Transfo
 			float dist = std::fabs(signedDist);
 
 			if (dist > ra + rb) {
+				collisionInfo.satAxis = 6 + i * 3 + j;
 				return false; // ������
 			}
 
@@ -531,6 +565,8 @@ bool CollisionDetection::OBBIntersection(const OBBVolume& volumeA, const Transfo
 	Vector3 collisionNormal = Vector::Normalise(bestAxis);
 	float penetration = minPenetration;
 
+	collisionInfo.satAxis = (bestAxisType == 2) ? 6 + bestAxisIndex : bestAxisType * 3 + bestAxisIndex;
+
 	// === 5. ʹ�� clipping ���� contact manifold����㣩 ===
 
 	// helper: support point on OBB in given direction (world space)
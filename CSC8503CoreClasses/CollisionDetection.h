@@ -31,6 +31,9 @@ namespace NCL {
 
 			ContactPoint point;
 
+			//Last separating / least penetrating SAT axis for OBB pairs, -1 if unknown
+			int		satAxis = -1;
+
 			CollisionInfo() {
 
 			}
@@ -43,14 +46,15 @@ namespace NCL {
 			}
 
 			//Advanced collision detection / resolution
+			//Ordered by world ID rather than address, so iterating the collision
+			//sets visits pairs in the same order on every run and every machine
 			bool operator < (const CollisionInfo& other) const {
-				size_t otherHash = (size_t)other.a + ((size_t)other.b << 32);
-				size_t thisHash  = (size_t)a + ((size_t)b << 32);
-
-				if (thisHash < otherHash) {
-					return true;
+				int thisA	= a->GetWorldID();
+				int otherA	= other.a->GetWorldID();
+				if (thisA != otherA) {
+					return thisA < otherA;
 				}
-				return false;
+				return b->GetWorldID() < other.b->GetWorldID();
 			}
 
 			bool operator ==(const CollisionInfo& other) const {
@@ -90,6 +94,12 @@ namespace NCL {
 
 		static bool ObjectIntersection(GameObject* a, GameObject* b, CollisionInfo& collisionInfo);
 
+		//Whether ObjectIntersection runs the separating axis test on these, so a cached satAxis is any use
+		static bool UsesSATAxis(const CollisionVolume& volA, const CollisionVolume& volB) {
+			return	(volA.type == VolumeType::OBB && (volB.type == VolumeType::OBB || volB.type == VolumeType::AABB)) ||
+					(volB.type == VolumeType::OBB && volA.type == VolumeType::AABB);
+		}
+
 
 		static bool AABBIntersection(	const AABBVolume& volumeA, const Transform& worldTransformA,
 										const AABBVolume& volumeB, const Transform& worldTransformB, CollisionInfo& collisionInfo);
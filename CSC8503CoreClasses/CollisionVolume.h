@@ -1,4 +1,6 @@
 #pragma once
+#include "ObjectPool.h"
+
 namespace NCL {
 	enum class VolumeType 
 	{
@@ -18,7 +20,7 @@ namespace NCL {
 		{
 			type = VolumeType::Invalid;
 		}
-		~CollisionVolume() = default;
+		virtual ~CollisionVolume() = default; //volumes are deleted through this, and need their own size for the pools
 
 		VolumeType type;
 	};
@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+
+namespace NCL::CSC8503 {
+	class GameObject;
+
+	/*
+	A densely packed list of one kind of component (physics, render,
+	network...), alongside the GameObject that owns each one. Systems that
+	only care about one component type walk this instead of every object
+	in the world, so objects without that component cost them nothing.
+
+	Removal swaps the last entry into the gap, so entries don't keep a
+	stable position - the GameWorld tracks where each object's entries are.
+	*/
+	template <typename T>
+	class ComponentArray
+	{
+	public:
+		int Add(GameObject* owner, T* component) {
+			components.emplace_back(component);
+			owners.emplace_back(owner);
+			return (int)components.size() - 1;
+		}
+
+		//Returns the owner of the entry that was moved into index, if any
+		GameObject* RemoveAt(int index) {
+			int lastIndex = (int)components.size() - 1;
+			GameObject* moved = nullptr;
+			if (index != lastIndex) {
+				components[index]	= components[lastIndex];
+				owners[index]		= owners[lastIndex];
+				moved = owners[index];
+			}
+			components.pop_back();
+			owners.pop_back();
+			return moved;
+		}
+
+		void Set(int index, T* component) {
+			components[index] = component;
+		}
+
+		void Clear() {
+			components.clear();
+			owners.clear();
+		}
+
+		size_t Size() const {
+			return components.size();
+		}
+
+		T* Get(int index) const {
+			return components[index];
+		}
+
+		GameObject* GetOwner(int index) const {
+			return owners[index];
+		}
+
+		const std::vector<T*>& GetComponents() const {
+			return components;
+		}
+
+		const std::vector<GameObject*>& GetOwners() const {
+			return owners;
+		}
+
+	protected:
+		std::vector<T*>				components;
+		std::vector<GameObject*>	owners;
+	};
+}
@@ -2,6 +2,9 @@
 
 namespace NCL {
 	namespace CSC8503 {
+		class WorldSnapshot;
+		class GameObject;
+
 		class Constraint	
 		{
 		public:
@@ -9,6 +12,15 @@ namespace NCL {
 			virtual ~Constraint() = default;
 
 			virtual void UpdateConstraint(float dt) = 0;
+
+			//Constraints with changing internal state should store it here, so
+			//that the state survives a PhysicsSystem snapshot / restore
+			virtual void WriteSnapshot(WorldSnapshot& s) const {}
+			virtual bool ReadSnapshot(const WorldSnapshot& s, size_t& offset) { return true; }
+
+			//Whether this constraint acts on the given object - the world drops any
+			//constraint using an object as that object is removed
+			virtual bool Uses(const GameObject* o) const { return false; }
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,514 @@
+#include "Crowd.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define CROWD_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace NCL;
+using namespace CSC8503;
+
+const float LINE_EPSILON = 0.00001f;
+
+//Agents this close to an intermediate waypoint (as a fraction of their radius) move on to the next one
+const float WAYPOINT_REACHED	= 1.0f;
+//...and this close to the last one have arrived
+const float PATH_FINISHED		= 0.25f;
+//How far to one side of their waypoints (as a fraction of their speed) agents aim
+const float SYMMETRY_NUDGE		= 0.05f;
+
+static inline float Det(const Vector2& a, const Vector2& b) {
+	return (a.x * b.y) - (a.y * b.x);
+}
+
+Crowd::Crowd(float neighbourDistance, int maxNeighbours) {
+	this->neighbourDistance	= neighbourDistance;
+	this->maxNeighbours		= maxNeighbours;
+	timeHorizon				= 2.0f;
+	hashMask				= 0;
+}
+
+Crowd::~Crowd() {
+}
+
+int Crowd::AddAgent(const Vector3& position, float agentRadius, float agentMaxSpeed) {
+	int id = 0;
+	if (!freeIDs.empty()) {
+		id = freeIDs.back();
+		freeIDs.pop_back();
+	}
+	else {
+		id = (int)idToIndex.size();
+		idToIndex.emplace_back();
+	}
+	idToIndex[id] = (int)indexToID.size();
+	indexToID.push_back(id);
+
+	posX.push_back(position.x);
+	posY.push_back(position.y);
+	posZ.push_back(position.z);
+	velX.push_back(0.0f);
+	velZ.push_back(0.0f);
+	preferredX.push_back(0.0f);
+	preferredZ.push_back(0.0f);
+	newVelX.push_back(0.0f);
+	newVelZ.push_back(0.0f);
+	radius.push_back(agentRadius);
+	maxSpeed.push_back(agentMaxSpeed);
+	targetX.push_back(position.x);
+	targetZ.push_back(position.z);
+	hasTarget.push_back(0);
+	paths.emplace_back();
+
+	return id;
+}
+
+void Crowd::RemoveAgent(int agent) {
+	int index		= idToIndex[agent];
+	int lastIndex	= (int)indexToID.size() - 1;
+
+	auto removeAt = [&](auto& values) {
+		values[index] = std::move(values[lastIndex]);
+		values.pop_back();
+	};
+	removeAt(posX);
+	removeAt(posY);
+	removeAt(posZ);
+	removeAt(velX);
+	removeAt(velZ);
+	removeAt(preferredX);
+	removeAt(preferredZ);
+	removeAt(newVelX);
+	removeAt(newVelZ);
+	removeAt(radius);
+	removeAt(maxSpeed);
+	removeAt(targetX);
+	removeAt(targetZ);
+	removeAt(hasTarget);
+	removeAt(paths);
+
+	int movedID = indexToID[lastIndex];
+	indexToID[index]	= movedID;
+	idToIndex[movedID]	= index;
+	indexToID.pop_back();
+
+	idToIndex[agent] = -1;
+	freeIDs.push_back(agent);
+}
+
+void Crowd::SetPath(int agent, const NavigationPath& path) {
+	int index = idToIndex[agent];
+	paths[index] = path;
+
+	Vector3 waypoint;
+	hasTarget[index] = paths[index].PopWaypoint(waypoint);
+	if (hasTarget[index]) {
+		targetX[index] = waypoint.x;
+		targetZ[index] = waypoint.z;
+	}
+}
+
+void Crowd::Stop(int agent) {
+	int index = idToIndex[agent];
+	paths[index].Clear();
+	hasTarget[index] = 0;
+}
+
+Vector3 Crowd::GetPosition(int agent) const {
+	int index = idToIndex[agent];
+	return Vector3(posX[index], posY[index], posZ[index]);
+}
+
+void Crowd::SetPosition(int agent, const Vector3& position) {
+	int index = idToIndex[agent];
+	posX[index] = position.x;
+	posY[index] = position.y;
+	posZ[index] = position.z;
+}
+
+Vector3 Crowd::GetVelocity(int agent) const {
+	int index = idToIndex[agent];
+	return Vector3(velX[index], 0.0f, velZ[index]);
+}
+
+bool Crowd::HasArrived(int agent) const {
+	return !hasTarget[idToIndex[agent]];
+}
+
+void Crowd::Update(float dt) {
+	int count = GetAgentCount();
+	if (count == 0 || dt <= 0.0f) {
+		return;
+	}
+	JobSystem::Get().ParallelFor(count, 256, [&](int start, int end) {
+		FollowPaths(start, end, dt);
+	});
+
+	BuildHash();
+
+	JobSystem::Get().ParallelFor(count, 32, [&](int start, int end) {
+		Scratch scratch;
+		for (int i = start; i < end; ++i) {
+			ComputeVelocity(i, dt, scratch);
+		}
+	});
+
+	//Plain loops over plain arrays, which the compiler can vectorise
+	float* px = posX.data();
+	float* pz = posZ.data();
+	float* vx = velX.data();
+	float* vz = velZ.data();
+	const float* nx = newVelX.data();
+	const float* nz = newVelZ.data();
+	for (int i = 0; i < count; ++i) {
+		vx[i] = nx[i];
+		vz[i] = nz[i];
+		px[i] += nx[i] * dt;
+		pz[i] += nz[i] * dt;
+	}
+}
+
+//Moves agents on to their next waypoints, and works out where they'd go if nothing was in the way
+void Crowd::FollowPaths(int start, int end, float dt) {
+	for (int i = start; i < end; ++i) {
+		preferredX[i] = 0.0f;
+		preferredZ[i] = 0.0f;
+		if (!hasTarget[i]) {
+			continue;
+		}
+		float dx = targetX[i] - posX[i];
+		float dz = targetZ[i] - posZ[i];
+		float distance = std::sqrt(dx * dx + dz * dz);
+
+		Vector3 waypoint;
+		while (distance <= radius[i] * WAYPOINT_REACHED && paths[i].PopWaypoint(waypoint)) {
+			targetX[i]	= waypoint.x;
+			targetZ[i]	= waypoint.z;
+			dx			= targetX[i] - posX[i];
+			dz			= targetZ[i] - posZ[i];
+			distance	= std::sqrt(dx * dx + dz * dz);
+		}
+		bool lastWaypoint = paths[i].IsEmpty();
+		if (lastWaypoint && distance <= radius[i] * PATH_FINISHED) {
+			hasTarget[i] = 0;
+			continue;
+		}
+		if (distance <= 0.0f) {
+			continue;
+		}
+		//slows down for the last waypoint, rather than overshooting it
+		float speed = lastWaypoint ? std::min(maxSpeed[i], distance / dt) : maxSpeed[i];
+		preferredX[i] = (dx / distance) * speed;
+		preferredZ[i] = (dz / distance) * speed;
+
+		/*
+		Agents heading straight at each other can each wait forever for the
+		other to move first, so everyone aims slightly off to the same side,
+		the way people in corridors keep to one side.
+		*/
+		float preferredDirX = preferredX[i];
+		preferredX[i] += preferredZ[i] * SYMMETRY_NUDGE;
+		preferredZ[i] -= preferredDirX * SYMMETRY_NUDGE;
+	}
+}
+
+/*
+Buckets are cells of the XZ plane neighbourDistance across, hashed into a
+table twice the size of the crowd, so it doesn't matter how big the world
+is or where the crowd is in it. A counting sort puts every bucket's agents
+next to each other in cellAgents.
+*/
+void Crowd::BuildHash() {
+	int count = GetAgentCount();
+
+	uint32_t tableSize = 16;
+	while (tableSize < (uint32_t)count * 2) {
+		tableSize *= 2;
+	}
+	hashMask = tableSize - 1;
+
+	agentCells.resize(count);
+	cellStarts.assign(tableSize + 1, 0);
+	cellAgents.resize(count);
+
+	float invCellSize = 1.0f / neighbourDistance;
+	for (int i = 0; i < count; ++i) {
+		agentCells[i] = HashCell((int)std::floor(posX[i] * invCellSize), (int)std::floor(posZ[i] * invCellSize));
+		cellStarts[agentCells[i] + 1]++;
+	}
+	for (uint32_t b = 0; b < tableSize; ++b) {
+		cellStarts[b + 1] += cellStarts[b];
+	}
+	std::vector<int> fill(cellStarts.begin(), cellStarts.end() - 1);
+	for (int i = 0; i < count; ++i) {
+		cellAgents[fill[agentCells[i]]++] = i;
+	}
+}
+
+uint32_t Crowd::HashCell(int x, int z) const {
+	return (((uint32_t)x * 73856093u) ^ ((uint32_t)z * 19349663u)) & hashMask;
+}
+
+/*
+Gathers every agent in the 3x3 cells around this one, then tests their
+distances four at a time. Different cells can share a bucket, so each
+bucket is only gathered once.
+*/
+void Crowd::FindNeighbours(int index, Scratch& scratch) const {
+	scratch.candidateX.clear();
+	scratch.candidateZ.clear();
+	scratch.candidates.clear();
+	scratch.neighbours.clear();
+
+	float invCellSize = 1.0f / neighbourDistance;
+	int cellX = (int)std::floor(posX[index] * invCellSize);
+	int cellZ = (int)std::floor(posZ[index] * invCellSize);
+
+	uint32_t buckets[9];
+	int bucketCount = 0;
+	for (int z = cellZ - 1; z <= cellZ + 1; ++z) {
+		for (int x = cellX - 1; x <= cellX + 1; ++x) {
+			uint32_t b = HashCell(x, z);
+			if (std::find(buckets, buckets + bucketCount, b) != buckets + bucketCount) {
+				continue;
+			}
+			buckets[bucketCount++] = b;
+
+			for (int c = cellStarts[b]; c < cellStarts[b + 1]; ++c) {
+				int other = cellAgents[c];
+				if (other == index) {
+					continue;
+				}
+				scratch.candidates.push_back(other);
+				scratch.candidateX.push_back(posX[other]);
+				scratch.candidateZ.push_back(posZ[other]);
+			}
+		}
+	}
+	int count = (int)scratch.candidates.size();
+	float rangeSq = neighbourDistance * neighbourDistance;
+
+#ifdef CROWD_USE_SSE
+	//Padding lanes are a long way off, so never pass the range test
+	size_t padded = (count + 3) & ~3;
+	scratch.candidateX.resize(padded, posX[index] + neighbourDistance * 2.0f);
+	scratch.candidateZ.resize(padded, posZ[index]);
+
+	__m128 ax		= _mm_set1_ps(posX[index]);
+	__m128 az		= _mm_set1_ps(posZ[index]);
+	__m128 range	= _mm_set1_ps(rangeSq);
+	for (int i = 0; i < count; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&scratch.candidateX[i]), ax);
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(&scratch.candidateZ[i]), az);
+		__m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, range));
+		if (!mask) {
+			continue;
+		}
+		float distances[4];
+		_mm_storeu_ps(distances, distSq);
+		for (int lane = 0; lane < 4; ++lane) {
+			if (mask & (1 << lane)) {
+				scratch.neighbours.push_back({ distances[lane], scratch.candidates[i + lane] });
+			}
+		}
+	}
+#else
+	for (int i = 0; i < count; ++i) {
+		float dx = scratch.candidateX[i] - posX[index];
+		float dz = scratch.candidateZ[i] - posZ[index];
+		float distSq = dx * dx + dz * dz;
+		if (distSq < rangeSq) {
+			scratch.neighbours.push_back({ distSq, scratch.candidates[i] });
+		}
+	}
+#endif
+	//only the closest few matter
+	if ((int)scratch.neighbours.size() > maxNeighbours) {
+		std::nth_element(scratch.neighbours.begin(), scratch.neighbours.begin() + maxNeighbours, scratch.neighbours.end());
+		scratch.neighbours.resize(maxNeighbours);
+	}
+}
+
+/*
+Each neighbour gives a half plane of velocities that won't hit it within
+the time horizon (or, if the two already overlap, within this step), set
+up so that each of the pair does half the work of getting out of the way.
+The new velocity is the closest one to the preferred velocity that's in
+all of them - or, if they can't all be met, the one that breaks them by
+the least.
+*/
+void Crowd::ComputeVelocity(int index, float dt, Scratch& scratch) {
+	FindNeighbours(index, scratch);
+	scratch.lines.clear();
+
+	Vector2 position(posX[index], posZ[index]);
+	Vector2 velocity(velX[index], velZ[index]);
+	float invTimeHorizon = 1.0f / timeHorizon;
+
+	for (const auto& n : scratch.neighbours) {
+		int other = n.second;
+		Vector2 relativePosition	= Vector2(posX[other], posZ[other]) - position;
+		Vector2 relativeVelocity	= velocity - Vector2(velX[other], velZ[other]);
+		float distSq				= n.first;
+		float combinedRadius		= radius[index] + radius[other];
+		float combinedRadiusSq		= combinedRadius * combinedRadius;
+
+		Line line;
+		Vector2 u;
+		if (distSq > combinedRadiusSq) { //not touching yet
+			//w goes from the centre of the cut-off circle to the relative velocity
+			Vector2 w		= relativeVelocity - relativePosition * invTimeHorizon;
+			float wLengthSq	= Vector::LengthSquared(w);
+			float dotProduct = Vector::Dot(w, relativePosition);
+
+			if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq) { //nearest the cut-off circle
+				float wLength	= std::sqrt(wLengthSq);
+				Vector2 unitW	= w / wLength;
+				line.direction	= Vector2(unitW.y, -unitW.x);
+				u = unitW * (combinedRadius * invTimeHorizon - wLength);
+			}
+			else { //nearest one of the legs of the cone
+				float leg = std::sqrt(distSq - combinedRadiusSq);
+				if (Det(relativePosition, w) > 0.0f) {
+					line.direction = Vector2(relativePosition.x * leg - relativePosition.y * combinedRadius,
+											 relativePosition.x * combinedRadius + relativePosition.y * leg) / distSq;
+				}
+				else {
+					line.direction = -Vector2(relativePosition.x * leg + relativePosition.y * combinedRadius,
+											  -relativePosition.x * combinedRadius + relativePosition.y * leg) / distSq;
+				}
+				u = line.direction * Vector::Dot(relativeVelocity, line.direction) - relativeVelocity;
+			}
+		}
+		else { //already overlapping - get apart within this step
+			float invTimeStep	= 1.0f / dt;
+			Vector2 w			= relativeVelocity - relativePosition * invTimeStep;
+			float wLength		= Vector::Length(w);
+			Vector2 unitW;
+			if (wLength > LINE_EPSILON) {
+				unitW = w / wLength;
+			}
+			else { //right on top of each other and moving together, so just split them apart along X
+				unitW = Vector2((indexToID[index] < indexToID[other]) ? 1.0f : -1.0f, 0.0f);
+			}
+			line.direction	= Vector2(unitW.y, -unitW.x);
+			u = unitW * (combinedRadius * invTimeStep - wLength);
+		}
+		line.point = velocity + u * 0.5f;
+		scratch.lines.push_back(line);
+	}
+
+	Vector2 preferred(preferredX[index], preferredZ[index]);
+	Vector2 result;
+	int lineFail = LinearProgram2(scratch.lines, maxSpeed[index], preferred, false, result);
+	if (lineFail < (int)scratch.lines.size()) {
+		LinearProgram3(scratch.lines, lineFail, maxSpeed[index], result, scratch.projectedLines);
+	}
+	newVelX[index] = result.x;
+	newVelZ[index] = result.y;
+}
+
+//The best velocity along line lineNo that the lines before it allow, within the speed limit
+bool Crowd::LinearProgram1(const std::vector<Line>& lines, int lineNo, float speed, const Vector2& optVelocity, bool directionOpt, Vector2& result) {
+	const Line& line	= lines[lineNo];
+	float dotProduct	= Vector::Dot(line.point, line.direction);
+	float discriminant	= dotProduct * dotProduct + speed * speed - Vector::LengthSquared(line.point);
+	if (discriminant < 0.0f) {
+		return false; //the line misses the speed limit circle entirely
+	}
+	float sqrtDiscriminant	= std::sqrt(discriminant);
+	float tLeft				= -dotProduct - sqrtDiscriminant;
+	float tRight			= -dotProduct + sqrtDiscriminant;
+
+	for (int i = 0; i < lineNo; ++i) {
+		float denominator	= Det(line.direction, lines[i].direction);
+		float numerator		= Det(lines[i].direction, line.point - lines[i].point);
+
+		if (std::abs(denominator) <= LINE_EPSILON) { //parallel
+			if (numerator < 0.0f) {
+				return false;
+			}
+			continue;
+		}
+		float t = numerator / denominator;
+		if (denominator >= 0.0f) {
+			tRight = std::min(tRight, t);
+		}
+		else {
+			tLeft = std::max(tLeft, t);
+		}
+		if (tLeft > tRight) {
+			return false;
+		}
+	}
+	if (directionOpt) {
+		result = line.point + line.direction * ((Vector::Dot(optVelocity, line.direction) > 0.0f) ? tRight : tLeft);
+	}
+	else {
+		float t = Vector::Dot(line.direction, optVelocity - line.point);
+		result = line.point + line.direction * std::clamp(t, tLeft, tRight);
+	}
+	return true;
+}
+
+//Returns the number of lines it got through - less than all of them if they can't all be met
+int Crowd::LinearProgram2(const std::vector<Line>& lines, float speed, const Vector2& optVelocity, bool directionOpt, Vector2& result) {
+	if (directionOpt) {
+		result = optVelocity * speed;
+	}
+	else if (Vector::LengthSquared(optVelocity) > speed * speed) {
+		result = Vector::Normalise(optVelocity) * speed;
+	}
+	else {
+		result = optVelocity;
+	}
+	for (int i = 0; i < (int)lines.size(); ++i) {
+		if (Det(lines[i].direction, lines[i].point - result) > 0.0f) { //result breaks this one
+			Vector2 previous = result;
+			if (!LinearProgram1(lines, i, speed, optVelocity, directionOpt, result)) {
+				result = previous;
+				return i;
+			}
+		}
+	}
+	return (int)lines.size();
+}
+
+//Too crowded to meet every line, so finds the velocity that's the least distance past any of them
+void Crowd::LinearProgram3(const std::vector<Line>& lines, int beginLine, float speed, Vector2& result, std::vector<Line>& projectedLines) {
+	float distance = 0.0f;
+
+	for (int i = beginLine; i < (int)lines.size(); ++i) {
+		if (Det(lines[i].direction, lines[i].point - result) <= distance) {
+			continue;
+		}
+		projectedLines.clear();
+		for (int j = 0; j < i; ++j) {
+			Line line;
+			float determinant = Det(lines[i].direction, lines[j].direction);
+
+			if (std::abs(determinant) <= LINE_EPSILON) {
+				if (Vector::Dot(lines[i].direction, lines[j].direction) > 0.0f) {
+					continue; //same direction
+				}
+				line.point = (lines[i].point + lines[j].point) * 0.5f;
+			}
+			else {
+				line.point = lines[i].point + lines[i].direction * (Det(lines[j].direction, lines[i].point - lines[j].point) / determinant);
+			}
+			line.direction = Vector::Normalise(lines[j].direction - lines[i].direction);
+			projectedLines.push_back(line);
+		}
+		Vector2 previous = result;
+		if (LinearProgram2(projectedLines, speed, Vector2(-lines[i].direction.y, lines[i].direction.x), true, result) < (int)projectedLines.size()) {
+			result = previous; //can only fail through rounding - the result is already as good as it gets
+		}
+		distance = Det(lines[i].direction, lines[i].point - result);
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "NavigationPath.h"
+#include "Vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		using namespace NCL::Maths;
+
+		/*
+		Lots of agents walking along NavigationPaths without walking into
+		each other, for pedestrians and the like. Nothing here goes near the
+		physics system - each agent is just a circle on the XZ plane, and
+		steers around the others with ORCA (optimal reciprocal collision
+		avoidance): every nearby agent rules out the velocities that would
+		hit it within the time horizon, each agent taking half of the
+		avoiding, and the agent picks the allowed velocity closest to the
+		one that heads straight for its next waypoint.
+
+		Agents are stored as a structure of arrays, so the passes over them
+		only pull in the values they use. Neighbours are found through a
+		spatial hash rebuilt each Update, and each agent's new velocity only
+		reads the others' current ones, so that part is split across the
+		job system's workers.
+
+		Walls aren't avoided - the paths are expected to keep agents clear of
+		them. Y is left alone, other than by SetPosition. Agent IDs stay the
+		same for as long as the agent exists, but are reused after removal.
+		*/
+		class Crowd {
+		public:
+			//neighbourDistance should be more than twice the largest agent radius
+			Crowd(float neighbourDistance = 5.0f, int maxNeighbours = 10);
+			~Crowd();
+
+			int		AddAgent(const Vector3& position, float radius, float maxSpeed);
+			void	RemoveAgent(int agent);
+
+			//Replaces whatever the agent was following - it stops at the last waypoint
+			void	SetPath(int agent, const NavigationPath& path);
+			void	Stop(int agent);
+
+			void	Update(float dt);
+
+			Vector3	GetPosition(int agent) const;
+			void	SetPosition(int agent, const Vector3& position);
+			Vector3	GetVelocity(int agent) const;
+
+			//True once the agent has reached the end of its path, or if it never had one
+			bool	HasArrived(int agent) const;
+
+			int		GetAgentCount() const {
+				return (int)indexToID.size();
+			}
+
+			//How far ahead (in seconds) agents look for collisions - longer is smoother, but more timid in crowds
+			void	SetTimeHorizon(float seconds) {
+				timeHorizon = seconds;
+			}
+
+		protected:
+			/*
+			The velocities an agent can pick from are on the left of each line,
+			looking along its direction.
+			*/
+			struct Line {
+				Vector2 point;
+				Vector2 direction;
+			};
+
+			//Per batch of agents, so each worker reuses its own
+			struct Scratch {
+				std::vector<float>	candidateX;
+				std::vector<float>	candidateZ;
+				std::vector<int>	candidates;
+				std::vector<std::pair<float, int>> neighbours; //distance squared, and index
+				std::vector<Line>	lines;
+				std::vector<Line>	projectedLines;
+			};
+
+			void		FollowPaths(int start, int end, float dt);
+			void		BuildHash();
+			void		FindNeighbours(int index, Scratch& scratch) const;
+			void		ComputeVelocity(int index, float dt, Scratch& scratch);
+
+			uint32_t	HashCell(int x, int z) const;
+
+			static bool	LinearProgram1(const std::vector<Line>& lines, int lineNo, float speed, const Vector2& optVelocity, bool directionOpt, Vector2& result);
+			static int	LinearProgram2(const std::vector<Line>& lines, float speed, const Vector2& optVelocity, bool directionOpt, Vector2& result);
+			static void	LinearProgram3(const std::vector<Line>& lines, int beginLine, float speed, Vector2& result, std::vector<Line>& projectedLines);
+
+			float	neighbourDistance;
+			int		maxNeighbours;
+			float	timeHorizon;
+
+			//One entry per agent, in the same order
+			std::vector<float>		posX;
+			std::vector<float>		posY;
+			std::vector<float>		posZ;
+			std::vector<float>		velX;
+			std::vector<float>		velZ;
+			std::vector<float>		preferredX;
+			std::vector<float>		preferredZ;
+			std::vector<float>		newVelX;
+			std::vector<float>		newVelZ;
+			std::vector<float>		radius;
+			std::vector<float>		maxSpeed;
+			std::vector<float>		targetX;
+			std::vector<float>		targetZ;
+			std::vector<uint8_t>	hasTarget;
+			std::vector<NavigationPath>	paths; //the waypoints after the current target
+
+			//Removal swaps the last agent into the gap, so IDs are looked up through these
+			std::vector<int>	indexToID;
+			std::vector<int>	idToIndex;
+			std::vector<int>	freeIDs;
+
+			//The agents in each hash bucket are cellAgents[cellStarts[b]] to cellAgents[cellStarts[b + 1]]
+			std::vector<int>		cellStarts;
+			std::vector<int>		cellAgents;
+			std::vector<uint32_t>	agentCells;
+			uint32_t				hashMask;
+		};
+	}
+}
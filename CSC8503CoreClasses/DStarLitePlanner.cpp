@@ -0,0 +1,282 @@
+#include "DStarLitePlanner.h"
+#include "NavigationGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+using namespace NCL;
+using namespace CSC8503;
+
+const float DIAGONAL_COST	= 1.41421356f;
+const float INFINITE_COST	= std::numeric_limits<float>::infinity();
+
+/*
+Diagonal costs don't add up to exactly the same float every way round, so
+nodes whose keys only tie with the start's after rounding are dealt with
+too - left in the queue, they can leave the path downhill from the start
+broken.
+*/
+const float KEY_TOLERANCE	= 0.001f;
+
+//The straight directions first, so 4-way searches can just stop after them
+const int NEIGHBOUR_OFFSETS[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+DStarLitePlanner::DStarLitePlanner(const NavigationGrid& grid) : grid(grid) {
+	stamp		= 0;
+	start		= -1;
+	lastStart	= -1;
+	goal		= -1;
+	keyModifier	= 0.0f;
+	seenChanges	= 0;
+	diagonals	= false;
+	expanded	= 0;
+}
+
+DStarLitePlanner::~DStarLitePlanner() {
+}
+
+void DStarLitePlanner::Reset() {
+	goal = -1;
+}
+
+bool DStarLitePlanner::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) {
+	int fromX, fromZ, toX, toZ;
+	if (!grid.WorldToGrid(from, fromX, fromZ) || !grid.WorldToGrid(to, toX, toZ)) {
+		return false; //outside of map region!
+	}
+	int width		= grid.GetWidth();
+	int newStart	= (fromZ * width) + fromX;
+	int newGoal		= (toZ * width) + toX;
+
+	std::vector<int> changed;
+	bool caughtUp = grid.GetChangesSince(seenChanges, changed);
+
+	if (newGoal != goal || !caughtUp || diagonals != grid.GetDiagonalMovement()) {
+		start		= newStart;
+		lastStart	= newStart;
+		StartOver(newGoal);
+	}
+	else {
+		start = newStart;
+		if (start != lastStart) { //keeps the keys already in the queue as lower bounds from the new start
+			keyModifier	+= Heuristic(lastStart, start);
+			lastStart	= start;
+		}
+		//a node changing affects the steps into and out of it, and the diagonals that cut past it
+		for (int node : changed) {
+			int x = node % width;
+			int z = node / width;
+			UpdateNode(node);
+			for (int i = 0; i < 8; ++i) {
+				int nx = x + NEIGHBOUR_OFFSETS[i][0];
+				int nz = z + NEIGHBOUR_OFFSETS[i][1];
+				if (nx >= 0 && nx < width && nz >= 0 && nz < grid.GetHeight()) {
+					UpdateNode((nz * width) + nx);
+				}
+			}
+		}
+	}
+	seenChanges = grid.GetChangeCount();
+
+	expanded = 0;
+	ComputeShortestPath();
+
+	if (GetG(start) == INFINITE_COST) {
+		return false;
+	}
+	//every node knows its cost to the goal now, so the path is just downhill from the start
+	int directions = diagonals ? 8 : 4;
+	int nodeCount = width * grid.GetHeight();
+
+	std::vector<int> nodes;
+	nodes.push_back(start);
+	for (int current = start; current != goal; ) {
+		int		best		= -1;
+		float	bestCost	= INFINITE_COST;
+		int x = current % width;
+		int z = current / width;
+		for (int i = 0; i < directions; ++i) {
+			int nx = x + NEIGHBOUR_OFFSETS[i][0];
+			int nz = z + NEIGHBOUR_OFFSETS[i][1];
+			if (!grid.IsWalkable(nx, nz)) {
+				continue;
+			}
+			int neighbour = (nz * width) + nx;
+			float cost = StepCost(current, neighbour) + GetG(neighbour);
+			if (cost < bestCost) {
+				bestCost	= cost;
+				best		= neighbour;
+			}
+		}
+		if (best < 0 || (int)nodes.size() > nodeCount) {
+			return false;
+		}
+		nodes.push_back(best);
+		current = best;
+	}
+	for (int i = (int)nodes.size() - 1; i >= 0; --i) {
+		outPath.PushWaypoint(grid.GetNode(nodes[i]).position);
+	}
+	return true;
+}
+
+void DStarLitePlanner::StartOver(int newGoal) {
+	int nodeCount = grid.GetWidth() * grid.GetHeight();
+	if ((int)records.size() < nodeCount) {
+		records.resize(nodeCount);
+	}
+	stamp++;
+	if (stamp == 0) { //wrapped around, so old stamps could match again
+		for (NodeRecord& r : records) {
+			r.stamp = 0;
+		}
+		stamp = 1;
+	}
+	open		= decltype(open)();
+	goal		= newGoal;
+	keyModifier	= 0.0f;
+	diagonals	= grid.GetDiagonalMovement();
+
+	SetRHS(goal, 0.0f);
+	open.push({ CalculateKey(goal), goal });
+}
+
+void DStarLitePlanner::UpdateNode(int node) {
+	if (node != goal) {
+		int directions	= diagonals ? 8 : 4;
+		int x			= node % grid.GetWidth();
+		int z			= node / grid.GetWidth();
+		float best		= INFINITE_COST;
+
+		for (int i = 0; i < directions; ++i) {
+			int nx = x + NEIGHBOUR_OFFSETS[i][0];
+			int nz = z + NEIGHBOUR_OFFSETS[i][1];
+			if (nx < 0 || nx >= grid.GetWidth() || nz < 0 || nz >= grid.GetHeight()) {
+				continue;
+			}
+			int neighbour = (nz * grid.GetWidth()) + nx;
+			best = std::min(best, StepCost(node, neighbour) + GetG(neighbour));
+		}
+		SetRHS(node, best);
+	}
+	if (GetG(node) != GetRHS(node)) {
+		open.push({ CalculateKey(node), node });
+	}
+}
+
+void DStarLitePlanner::ComputeShortestPath() {
+	int directions = diagonals ? 8 : 4;
+
+	auto updateNeighbours = [&](int node) {
+		int x = node % grid.GetWidth();
+		int z = node / grid.GetWidth();
+		for (int i = 0; i < directions; ++i) {
+			int nx = x + NEIGHBOUR_OFFSETS[i][0];
+			int nz = z + NEIGHBOUR_OFFSETS[i][1];
+			if (nx >= 0 && nx < grid.GetWidth() && nz >= 0 && nz < grid.GetHeight()) {
+				UpdateNode((nz * grid.GetWidth()) + nx);
+			}
+		}
+	};
+
+	while (!open.empty()) {
+		QueueEntry top = open.top();
+		Key startKey = CalculateKey(start);
+		startKey.primary += KEY_TOLERANCE;
+		if (!(top.key < startKey) && GetG(start) == GetRHS(start)) {
+			break; //nothing left in the queue can make the start's path any shorter
+		}
+		open.pop();
+
+		int node	= top.node;
+		float g		= GetG(node);
+		float rhs	= GetRHS(node);
+		if (g == rhs) {
+			continue; //an old entry for a node that's been dealt with since
+		}
+		Key current = CalculateKey(node);
+		if (top.key < current) { //the start has moved since this went in
+			open.push({ current, node });
+			continue;
+		}
+		expanded++;
+
+		if (g > rhs) { //a shorter route has been found - settle it, and let the neighbours know
+			SetG(node, rhs);
+			updateNeighbours(node);
+		}
+		else { //its route got longer (or blocked) - clear it out so it and its neighbours look again
+			SetG(node, INFINITE_COST);
+			UpdateNode(node);
+			updateNeighbours(node);
+		}
+	}
+}
+
+DStarLitePlanner::Key DStarLitePlanner::CalculateKey(int node) const {
+	float best = std::min(GetG(node), GetRHS(node));
+	return { best + Heuristic(start, node) + keyModifier, best };
+}
+
+float DStarLitePlanner::GetG(int node) const {
+	const NodeRecord& r = records[node];
+	return (r.stamp == stamp) ? r.g : INFINITE_COST;
+}
+
+float DStarLitePlanner::GetRHS(int node) const {
+	const NodeRecord& r = records[node];
+	return (r.stamp == stamp) ? r.rhs : INFINITE_COST;
+}
+
+void DStarLitePlanner::SetG(int node, float g) {
+	NodeRecord& r = records[node];
+	if (r.stamp != stamp) {
+		r.stamp	= stamp;
+		r.rhs	= INFINITE_COST;
+	}
+	r.g = g;
+}
+
+void DStarLitePlanner::SetRHS(int node, float rhs) {
+	NodeRecord& r = records[node];
+	if (r.stamp != stamp) {
+		r.stamp	= stamp;
+		r.g		= INFINITE_COST;
+	}
+	r.rhs = rhs;
+}
+
+//Same rules as the grid's own searches - no walls, and no cutting corners
+float DStarLitePlanner::StepCost(int from, int to) const {
+	int width	= grid.GetWidth();
+	int fromX	= from % width;
+	int fromZ	= from / width;
+	int toX		= to % width;
+	int toZ		= to / width;
+
+	if (!grid.IsWalkable(fromX, fromZ) || !grid.IsWalkable(toX, toZ)) {
+		return INFINITE_COST;
+	}
+	if (fromX == toX || fromZ == toZ) {
+		return 1.0f;
+	}
+	if (!diagonals || !grid.IsWalkable(toX, fromZ) || !grid.IsWalkable(fromX, toZ)) {
+		return INFINITE_COST;
+	}
+	return DIAGONAL_COST;
+}
+
+float DStarLitePlanner::Heuristic(int from, int to) const {
+	int width = grid.GetWidth();
+	int dx = std::abs((from % width) - (to % width));
+	int dz = std::abs((from / width) - (to / width));
+	if (!diagonals) {
+		return (float)(dx + dz);
+	}
+	int diagonal = std::min(dx, dz);
+	return (float)(dx + dz - 2 * diagonal) + (diagonal * DIAGONAL_COST);
+}
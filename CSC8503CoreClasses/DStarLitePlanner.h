@@ -0,0 +1,104 @@
+#pragma once
+#include "NavigationMap.h"
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		class NavigationGrid;
+
+		/*
+		D* Lite - a search that keeps its results between calls, for agents
+		that keep asking for paths to the same goal while the grid changes
+		around them (crates being pushed into corridors, say).
+
+		The search runs backwards, out from the goal, so when the agent moves
+		nothing it has found so far is wrong. When nodes are blocked or
+		opened up, only the nodes whose distance to the goal those changes
+		affect are searched again, rather than starting over - a crate moving
+		across a corridor is usually a few dozen nodes of work.
+
+		Keep one per agent. The changes are picked up from the grid's change
+		log, so FindPath must be called from the same place obstacles are
+		moved from, not alongside it. A new goal, or falling behind the
+		change log, starts the search over.
+		*/
+		class DStarLitePlanner : public NavigationMap {
+		public:
+			DStarLitePlanner(const NavigationGrid& grid);
+			~DStarLitePlanner();
+
+			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) override;
+
+			//Starts over on the next FindPath, even if the goal is the same
+			void Reset();
+
+			//How many nodes the last FindPath had to process - small when it only repaired the last path
+			int GetLastExpandedCount() const {
+				return expanded;
+			}
+
+		protected:
+			struct Key {
+				float primary;
+				float secondary;
+
+				bool operator<(const Key& other) const {
+					return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+				}
+			};
+
+			/*
+			Entries aren't removed or updated when a node's key changes - a
+			new one is pushed instead, and out of date ones are skipped as
+			they come off the top.
+			*/
+			struct QueueEntry {
+				Key	key;
+				int	node;
+
+				bool operator>(const QueueEntry& other) const {
+					return other.key < key;
+				}
+			};
+
+			//g is the cost to the goal found so far, rhs what its neighbours say it should be
+			struct NodeRecord {
+				uint32_t	stamp	= 0;
+				float		g		= 0.0f;
+				float		rhs		= 0.0f;
+			};
+
+			void	StartOver(int newGoal);
+			void	UpdateNode(int node);
+			void	ComputeShortestPath();
+
+			Key		CalculateKey(int node) const;
+			float	GetG(int node) const;
+			float	GetRHS(int node) const;
+			void	SetG(int node, float g);
+			void	SetRHS(int node, float rhs);
+
+			//Infinite if the step isn't possible
+			float	StepCost(int from, int to) const;
+			float	Heuristic(int from, int to) const;
+
+			const NavigationGrid& grid;
+
+			std::vector<NodeRecord>	records;
+			uint32_t				stamp;
+
+			std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+			int			start;
+			int			lastStart;
+			int			goal;
+			float		keyModifier;	//km - how far the start has moved since the search began
+			uint64_t	seenChanges;
+			bool		diagonals;
+			int			expanded;
+		};
+	}
+}
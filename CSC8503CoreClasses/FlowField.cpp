@@ -0,0 +1,193 @@
+#include "FlowField.h"
+#include "NavigationGrid.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace NCL;
+using namespace CSC8503;
+
+const float DIAGONAL_COST = 1.41421356f;
+
+//The straight directions first, so 4-way fields can just stop after them
+const int NEIGHBOUR_OFFSETS[8][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+	{1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+FlowField::FlowField(const NavigationGrid& grid) : grid(grid) {
+	front		= 0;
+	building	= false;
+	maxDistance	= 0.0f;
+	goalPending	= false;
+}
+
+FlowField::~FlowField() {
+}
+
+void FlowField::SetGoal(const Vector3& goal) {
+	int x, z;
+	if (!grid.WorldToGrid(goal, x, z) || !grid.IsWalkable(x, z)) {
+		return;
+	}
+	int node = (z * grid.GetWidth()) + x;
+
+	Field& current	= fields[front];
+	Field& next		= fields[1 - front];
+
+	if (node == current.goal) { //back where the finished field leads, so whatever was being built isn't needed
+		current.goalPosition	= goal;
+		building				= false;
+		goalPending				= false;
+		return;
+	}
+	if (building) {
+		if (node == next.goal) {
+			next.goalPosition	= goal;
+			goalPending			= false;
+		}
+		else {
+			pendingGoal	= goal;
+			goalPending	= true;
+		}
+		return;
+	}
+	StartBuild(x, z, goal);
+}
+
+void FlowField::StartBuild(int x, int z, const Vector3& goal) {
+	Field& next = fields[1 - front];
+
+	//nothing further than maxDistance steps away can be within maxDistance of the goal
+	int reach = (maxDistance > 0.0f) ? (int)std::ceil(maxDistance) : INT_MAX / 2;
+	next.minX	= std::max(x - reach, 0);
+	next.minZ	= std::max(z - reach, 0);
+	next.width	= std::min(x + reach + 1, grid.GetWidth()) - next.minX;
+	next.depth	= std::min(z + reach + 1, grid.GetHeight()) - next.minZ;
+	next.goalX	= x;
+	next.goalZ	= z;
+	next.goal	= (z * grid.GetWidth()) + x;
+	next.goalPosition = goal;
+
+	next.search.Begin(next.width * next.depth);
+	next.search.Open(next.ToLocal(x, z), 0.0f, 0.0f, PathSearchState::NoNode);
+	building = true;
+}
+
+void FlowField::Update(int maxNodes) {
+	if (building) {
+		Expand(maxNodes);
+	}
+}
+
+void FlowField::Rebuild() {
+	//finishing one build can start the next, if the goal moved in the meantime
+	while (building) {
+		Expand(INT_MAX);
+	}
+}
+
+//Plain Dijkstra out from the goal, picking up where the last Update left off
+void FlowField::Expand(int maxNodes) {
+	Field& f		= fields[1 - front];
+	bool diagonals	= grid.GetDiagonalMovement();
+	int directions	= diagonals ? 8 : 4;
+
+	for (int i = 0; i < maxNodes && f.search.HasOpenNodes(); ++i) {
+		int current = f.search.PopBest();
+		int x = f.minX + (current % f.width);
+		int z = f.minZ + (current / f.width);
+		float g = f.search.GetCost(current);
+
+		for (int d = 0; d < directions; ++d) {
+			int dx = NEIGHBOUR_OFFSETS[d][0];
+			int dz = NEIGHBOUR_OFFSETS[d][1];
+			int neighbour = f.ToLocal(x + dx, z + dz);
+			if (neighbour < 0 || !grid.IsWalkable(x + dx, z + dz) || f.search.IsClosed(neighbour)) {
+				continue;
+			}
+			//no cutting corners, same as the grid's own searches
+			if (dx != 0 && dz != 0 && (!grid.IsWalkable(x + dx, z) || !grid.IsWalkable(x, z + dz))) {
+				continue;
+			}
+			float cost = g + ((dx != 0 && dz != 0) ? DIAGONAL_COST : 1.0f);
+			if (maxDistance > 0.0f && cost > maxDistance) {
+				continue;
+			}
+			f.search.Open(neighbour, cost, 0.0f, current);
+		}
+	}
+	if (!f.search.HasOpenNodes()) {
+		front		= 1 - front;
+		building	= false;
+		if (goalPending) {
+			goalPending = false;
+			SetGoal(pendingGoal);
+		}
+	}
+}
+
+/*
+Heads for the centre of the neighbouring node closest to the goal, rather
+than just along the grid, so agents that get knocked off centre drift back
+onto it instead of scraping along walls.
+*/
+bool FlowField::GetDirection(const Vector3& pos, Vector3& outDirection) const {
+	const Field& f = fields[front];
+	int x, z;
+	if (f.goal < 0 || !grid.WorldToGrid(pos, x, z)) {
+		return false;
+	}
+	int local = f.ToLocal(x, z);
+	if (local < 0 || !f.search.IsClosed(local)) {
+		return false;
+	}
+	Vector3 target = f.goalPosition;
+
+	if (local != f.ToLocal(f.goalX, f.goalZ)) {
+		bool diagonals	= grid.GetDiagonalMovement();
+		int directions	= diagonals ? 8 : 4;
+		float bestCost	= f.search.GetCost(local);
+		int best		= -1;
+
+		for (int d = 0; d < directions; ++d) {
+			int dx = NEIGHBOUR_OFFSETS[d][0];
+			int dz = NEIGHBOUR_OFFSETS[d][1];
+			int neighbour = f.ToLocal(x + dx, z + dz);
+			if (neighbour < 0 || !f.search.IsClosed(neighbour)) {
+				continue; //off the field, or a wall
+			}
+			if (dx != 0 && dz != 0 && (!grid.IsWalkable(x + dx, z) || !grid.IsWalkable(x, z + dz))) {
+				continue;
+			}
+			if (f.search.GetCost(neighbour) < bestCost) {
+				bestCost	= f.search.GetCost(neighbour);
+				best		= ((z + dz) * grid.GetWidth()) + (x + dx);
+			}
+		}
+		if (best < 0) {
+			return false;
+		}
+		float halfNode = grid.GetNodeSize() * 0.5f;
+		target = grid.GetNode(best).position + Vector3(halfNode, 0.0f, halfNode);
+	}
+	Vector3 offset = target - pos;
+	offset.y = 0.0f;
+
+	outDirection = (Vector::LengthSquared(offset) > 0.0f) ? Vector::Normalise(offset) : Vector3();
+	return true;
+}
+
+float FlowField::GetDistance(const Vector3& pos) const {
+	const Field& f = fields[front];
+	int x, z;
+	if (f.goal < 0 || !grid.WorldToGrid(pos, x, z)) {
+		return -1.0f;
+	}
+	int local = f.ToLocal(x, z);
+	if (local < 0 || !f.search.IsClosed(local)) {
+		return -1.0f;
+	}
+	return f.search.GetCost(local);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "PathSearchState.h"
+#include "Vector.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		using namespace NCL::Maths;
+
+		class NavigationGrid;
+
+		/*
+		For lots of agents all heading to the same place - rather than each
+		agent finding its own path, one Dijkstra search out from the goal
+		gives every node's distance to it, and an agent anywhere on the grid
+		just heads for whichever neighbouring node is closest. Looking that
+		up is a handful of reads, so the cost per frame is the same whether
+		one agent is chasing or a hundred are.
+
+		When the goal moves to another node, the new field is built a few
+		thousand nodes per Update, while agents keep following the last
+		finished one - they lead to where the goal was a moment ago, which
+		is near enough, and no single frame pays for the whole map. A goal
+		that moves again mid-build doesn't restart it, or one that never
+		stops would never get a field - the build finishes, and the next
+		one starts from wherever the goal is by then. A max distance stops
+		the search early, for maps much bigger than the area agents chase
+		across.
+
+		Holds a reference to the grid, so must not outlive it. Sampling only
+		reads the finished field, so any number of agents can sample at
+		once, but not while Update or Rebuild are running.
+		*/
+		class FlowField {
+		public:
+			FlowField(const NavigationGrid& grid);
+			~FlowField();
+
+			//Starts building a new field if the goal has moved to another node, once any build already going has finished
+			void SetGoal(const Vector3& goal);
+
+			//Carries on building, for up to maxNodes more nodes. Call once a frame
+			void Update(int maxNodes = 4096);
+
+			//Finishes building straight away
+			void Rebuild();
+
+			bool IsBuilding() const {
+				return building;
+			}
+
+			//False until the first field has finished
+			bool HasField() const {
+				return fields[front].goal >= 0;
+			}
+
+			//Nodes further than this from the goal (in nodes) are left out of the field - 0 for no limit
+			void SetMaxDistance(float distance) {
+				maxDistance = distance;
+			}
+
+			//Which way to go from pos to get to the goal. False if pos is off the grid, or can't reach the goal
+			bool GetDirection(const Vector3& pos, Vector3& outDirection) const;
+
+			//In nodes along the shortest path, or -1 if the goal can't be reached from pos
+			float GetDistance(const Vector3& pos) const;
+
+		protected:
+			/*
+			Nodes in the search are numbered within the rectangle of the grid
+			the field covers - the whole grid, or with a max distance, just the
+			part of it that could be that close to the goal.
+			*/
+			struct Field {
+				PathSearchState	search;
+				int				minX	= 0;
+				int				minZ	= 0;
+				int				width	= 0;
+				int				depth	= 0;
+				int				goalX	= 0;
+				int				goalZ	= 0;
+				int				goal	= -1; //grid node index, or -1 before it's been built
+				Vector3			goalPosition;
+
+				int ToLocal(int x, int z) const {
+					if (x < minX || x >= minX + width || z < minZ || z >= minZ + depth) {
+						return -1;
+					}
+					return ((z - minZ) * width) + (x - minX);
+				}
+			};
+
+			void	StartBuild(int x, int z, const Vector3& goal);
+			void	Expand(int maxNodes);
+
+			const NavigationGrid& grid;
+
+			//fields[front] is the finished one agents sample, the other is the one being built
+			Field	fields[2];
+			int		front;
+			bool	building;
+			float	maxDistance;
+
+			//Where the goal went while a field was building, to start on once that one's done
+			Vector3	pendingGoal;
+			bool	goalPending;
+		};
+	}
+}
@@ -3,18 +3,21 @@
 #include "PhysicsObject.h"
 #include "RenderObject.h"
 #include "NetworkObject.h"
+#include "GameWorld.h"
 
 using namespace NCL::CSC8503;
 
 GameObject::GameObject(const std::string& objectName)	
 {
 	name			= objectName;
+	nameID			= NameID(objectName);
 	worldID			= -1;
 	isActive		= true;
 	boundingVolume	= nullptr;
 	physicsObject	= nullptr;
 	renderObject	= nullptr;
 	networkObject	= nullptr;
+	world			= nullptr;
 }
 
 GameObject::~GameObject()	
@@ -25,6 +28,52 @@ GameObject::~GameObject()
 	delete networkObject;
 }
 
+void GameObject::SetRenderObject(RenderObject* newObject)
+{
+	renderObject = newObject;
+	if (world) {
+		world->RefreshComponents(this);
+	}
+}
+
+void GameObject::SetPhysicsObject(PhysicsObject* newObject)
+{
+	physicsObject = newObject;
+	if (world) {
+		world->RefreshComponents(this);
+	}
+}
+
+void GameObject::SetNetworkObject(NetworkObject* newObject)
+{
+	networkObject = newObject;
+	if (world) {
+		world->RefreshComponents(this);
+	}
+}
+
+void GameObject::AddTag(Tag t)
+{
+	if (!t.IsValid() || HasTag(t)) {
+		return;
+	}
+	tags.set(t.GetBit());
+	if (world) {
+		world->RefreshTag(this, t, true);
+	}
+}
+
+void GameObject::RemoveTag(Tag t)
+{
+	if (!HasTag(t)) {
+		return;
+	}
+	tags.reset(t.GetBit());
+	if (world) {
+		world->RefreshTag(this, t, false);
+	}
+}
+
 bool GameObject::GetBroadphaseAABB(Vector3&outSize) const 
 {
 	if (!boundingVolume) {
@@ -5,6 +5,11 @@
 #include "SphereVolume.h"
 #include "RenderObject.h"
 #include "PhysicsObject.h"
+#include "GameObjectHandle.h"
+#include "ObjectPool.h"
+#include "UpdatePhase.h"
+#include "Tag.h"
+#include "NameID.h"
 
 using std::vector;
 
@@ -13,11 +18,17 @@ namespace NCL::CSC8503 {
 	class RenderObject;
 	class PhysicsObject;
 	class NetworkObject;
-
-	class GameObject	{
+	class GameWorld;
+
+	/*
+	GameObjects and their parts all come from per-type pools, so the objects
+	of a level sit packed together in memory. Derived classes that add no
+	members share the GameObject pool, bigger ones fall back to the heap.
+	*/
+	class GameObject : public PoolAllocated<GameObject>	{
 	public:
 		GameObject(const std::string& name = "");
-		~GameObject();
+		virtual ~GameObject();
 
 		void SetBoundingVolume(CollisionVolume* vol) 
 		{
@@ -55,20 +66,10 @@ namespace NCL::CSC8503 {
 			return networkObject;
 		}
 
-		void SetRenderObject(RenderObject* newObject) 
-		{
-			renderObject = newObject;
-		}
-
-		void SetPhysicsObject(PhysicsObject* newObject) 
-		{
-			physicsObject = newObject;
-		}
-
-		void SetNetworkObject(NetworkObject* newObject)
-		{ 
-			networkObject = newObject;
-		}
+		//These keep the owning world's component arrays up to date
+		void SetRenderObject(RenderObject* newObject);
+		void SetPhysicsObject(PhysicsObject* newObject);
+		void SetNetworkObject(NetworkObject* newObject);
 
 		// New
 		void SetInitPosition(Vector3 position) {
@@ -84,6 +85,26 @@ namespace NCL::CSC8503 {
 			return name;
 		}
 
+		//Compare these rather than names - it's an integer compare rather than a string one
+		NameID GetNameID() const 
+		{
+			return nameID;
+		}
+
+		//Tagged objects can be found through GameWorld::GetObjectsWithTag
+		void AddTag(Tag t);
+		void RemoveTag(Tag t);
+
+		bool HasTag(Tag t) const 
+		{
+			return t.IsValid() && tags.test(t.GetBit());
+		}
+
+		const TagSet& GetTags() const 
+		{
+			return tags;
+		}
+
 		virtual void OnCollisionBegin(GameObject* otherObject) {
 			//std::cout << "OnCollisionBegin event occured!\n";
 		}
@@ -97,6 +118,20 @@ namespace NCL::CSC8503 {
 
 		}
 
+		//Which of the UpdateScheduler's phases this object takes part in - see UpdatePhase.h
+		virtual UpdatePhaseMask GetUpdatePhases() const 
+		{
+			return UpdatePhaseBit(UpdatePhase::Serial);
+		}
+
+		//Objects that declare parallel phases override this to split their update across them
+		virtual void RunUpdatePhase(UpdatePhase phase, float dt) 
+		{
+			if (phase == UpdatePhase::Serial) {
+				Update(dt);
+			}
+		}
+
 		bool GetBroadphaseAABB(Vector3&outsize) const;
 
 		void UpdateBroadphaseAABB();
@@ -110,6 +145,27 @@ namespace NCL::CSC8503 {
 		{
 			return worldID;
 		}
+
+		void SetHandle(const GameObjectHandle& newHandle) 
+		{
+			handle = newHandle;
+		}
+
+		//Null until the object has been added to a GameWorld
+		GameObjectHandle GetHandle() const 
+		{
+			return handle;
+		}
+
+		void SetWorld(GameWorld* newWorld) 
+		{
+			world = newWorld;
+		}
+
+		GameWorld* GetWorld() const 
+		{
+			return world;
+		}
 		
 
 	protected:
@@ -122,7 +178,11 @@ namespace NCL::CSC8503 {
 
 		bool				isActive;
 		int					worldID;
+		GameObjectHandle	handle;
+		GameWorld*			world;
 		std::string			name;
+		NameID				nameID;
+		TagSet				tags;
 
 		Vector3				broadphaseAABB;
 		Vector3 InitPosition; // New
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+namespace NCL::CSC8503 {
+	/*
+	A safe reference to an object in a GameWorld. The index picks a slot in
+	the world's slot map, and the generation is bumped every time that slot
+	is freed - so a handle to an object that has since been removed (and
+	perhaps had its slot reused) simply fails to resolve, rather than
+	dangling like a raw pointer would.
+
+	Hold these rather than GameObject pointers for anything that lives longer
+	than a frame, and resolve them through GameWorld::GetGameObject.
+	*/
+	struct GameObjectHandle {
+		static const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		uint32_t index		= InvalidIndex;
+		uint32_t generation	= 0;
+
+		bool IsNull() const {
+			return index == InvalidIndex;
+		}
+
+		bool operator==(const GameObjectHandle& other) const {
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const GameObjectHandle& other) const {
+			return !(*this == other);
+		}
+	};
+}
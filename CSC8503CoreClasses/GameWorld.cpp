@@ -4,12 +4,14 @@
 #include "CollisionDetection.h"
 #include "Camera.h"
 
-
+#include <algorithm>
 #include <random>
 
 #include "Ray.h"
 #include "CollisionDetection.h"
 #include "QuadTree.h"
+#include "WorldSnapshot.h"
+#include "JobSystem.h"
 
 using namespace NCL;
 using namespace NCL::CSC8503;
@@ -17,15 +19,35 @@ using namespace NCL::CSC8503;
 GameWorld::GameWorld()	{
 	shuffleConstraints	= false;
 	shuffleObjects		= false;
+	deterministic		= false;
 	worldIDCounter		= 0;
 	worldStateCounter	= 0;
+	removalListenerCounter = 0;
 }
 
 GameWorld::~GameWorld()	{
 }
 
 void GameWorld::Clear() {
+	//bump every live slot's generation, so no handle from before the clear resolves afterwards
+	for (uint32_t i = 0; i < objectSlots.size(); ++i) {
+		if (objectSlots[i].denseIndex >= 0) {
+			objectSlots[i].generation++;
+			objectSlots[i].denseIndex	= -1;
+			objectSlots[i].physicsIndex	= -1;
+			objectSlots[i].renderIndex	= -1;
+			objectSlots[i].networkIndex	= -1;
+			freeObjectSlots.push_back(i);
+		}
+	}
+	commandBuffer.Discard(false);
 	gameObjects.clear();
+	physicsComponents.Clear();
+	renderComponents.Clear();
+	networkComponents.Clear();
+	for (std::vector<GameObject*>& list : taggedObjects) {
+		list.clear();
+	}
 	constraints.clear();
 	worldIDCounter		= 0;
 	worldStateCounter	= 0;
@@ -38,23 +60,168 @@ void GameWorld::ClearAndErase() {
 	for (auto& i : constraints) {
 		delete i;
 	}
+	commandBuffer.Discard(true);
 	Clear();
 }
 
 void GameWorld::AddGameObject(GameObject* o) {
+	uint32_t slotIndex;
+	if (freeObjectSlots.empty()) {
+		slotIndex = (uint32_t)objectSlots.size();
+		objectSlots.emplace_back();
+	}
+	else {
+		slotIndex = freeObjectSlots.back();
+		freeObjectSlots.pop_back();
+	}
+	ObjectSlot& slot = objectSlots[slotIndex];
+	slot.denseIndex = (int)gameObjects.size();
+
+	GameObjectHandle h;
+	h.index			= slotIndex;
+	h.generation	= slot.generation;
+
 	gameObjects.emplace_back(o);
+	o->SetHandle(h);
+	o->SetWorld(this);
 	o->SetWorldID(worldIDCounter++);
+	RefreshComponents(o);
+
+	const TagSet& tags = o->GetTags();
+	for (int i = 0; i < MaxTags && tags.any(); ++i) {
+		if (tags.test(i)) {
+			taggedObjects[i].emplace_back(o);
+		}
+	}
 	worldStateCounter++;
 }
 
+//Tags change rarely, so finding the object in the list is fine - the order doesn't matter, so the last one fills the gap
+static void RemoveTagged(std::vector<GameObject*>& list, GameObject* o) {
+	auto found = std::find(list.begin(), list.end(), o);
+	if (found != list.end()) {
+		*found = list.back();
+		list.pop_back();
+	}
+}
+
 void GameWorld::RemoveGameObject(GameObject* o, bool andDelete) {
-	gameObjects.erase(std::remove(gameObjects.begin(), gameObjects.end(), o), gameObjects.end());
+	GameObjectHandle h = o->GetHandle();
+	if (GetGameObject(h) == o) {
+		for (const auto& listener : removalListeners) {
+			listener.second(o);
+		}
+
+		UpdateComponentEntry<PhysicsObject>(physicsComponents, &ObjectSlot::physicsIndex, o, nullptr);
+		UpdateComponentEntry<RenderObject>(renderComponents, &ObjectSlot::renderIndex, o, nullptr);
+		UpdateComponentEntry<NetworkObject>(networkComponents, &ObjectSlot::networkIndex, o, nullptr);
+
+		const TagSet& tags = o->GetTags();
+		for (int i = 0; i < MaxTags && tags.any(); ++i) {
+			if (tags.test(i)) {
+				RemoveTagged(taggedObjects[i], o);
+			}
+		}
+
+		//a constraint left pointing at a removed object would be solved against freed memory. Whoever
+		//made the constraint still owns it, so it's only taken out of the list here, not deleted
+		constraints.erase(std::remove_if(constraints.begin(), constraints.end(),
+			[o](const Constraint* c) { return c->Uses(o); }), constraints.end());
+
+		ObjectSlot& slot = objectSlots[h.index];
+
+		//swap the last object into the gap, and tell its slot where it went
+		GameObject* moved = gameObjects.back();
+		gameObjects[slot.denseIndex] = moved;
+		objectSlots[moved->GetHandle().index].denseIndex = slot.denseIndex;
+		gameObjects.pop_back();
+
+		slot.generation++;
+		slot.denseIndex = -1;
+		freeObjectSlots.push_back(h.index);
+		o->SetHandle(GameObjectHandle());
+		o->SetWorld(nullptr);
+	}
 	if (andDelete) {
 		delete o;
 	}
 	worldStateCounter++;
 }
 
+void GameWorld::RemoveGameObject(GameObjectHandle h, bool andDelete) {
+	if (GameObject* o = GetGameObject(h)) {
+		RemoveGameObject(o, andDelete);
+	}
+}
+
+int GameWorld::AddRemovalListener(const GameObjectFunc& f) {
+	int id = removalListenerCounter++;
+	removalListeners.emplace_back(id, f);
+	return id;
+}
+
+void GameWorld::RemoveRemovalListener(int id) {
+	removalListeners.erase(std::remove_if(removalListeners.begin(), removalListeners.end(),
+		[id](const std::pair<int, GameObjectFunc>& l) { return l.first == id; }), removalListeners.end());
+}
+
+void GameWorld::RefreshTag(GameObject* o, Tag t, bool hasTag) {
+	if (!t.IsValid() || GetGameObject(o->GetHandle()) != o) {
+		return;
+	}
+	if (hasTag) {
+		taggedObjects[t.GetBit()].emplace_back(o);
+	}
+	else {
+		RemoveTagged(taggedObjects[t.GetBit()], o);
+	}
+}
+
+const std::vector<GameObject*>& GameWorld::GetObjectsWithTag(Tag t) const {
+	static const std::vector<GameObject*> noObjects;
+	return t.IsValid() ? taggedObjects[t.GetBit()] : noObjects;
+}
+
+/*
+Adds, updates or removes the object's entry in one component array, so
+that it matches whatever component the object currently has.
+*/
+template <typename T>
+void GameWorld::UpdateComponentEntry(ComponentArray<T>& components, int ObjectSlot::* slotIndex, GameObject* o, T* component) {
+	int index = objectSlots[o->GetHandle().index].*slotIndex;
+
+	if (component) {
+		if (index < 0) {
+			objectSlots[o->GetHandle().index].*slotIndex = components.Add(o, component);
+		}
+		else {
+			components.Set(index, component);
+		}
+		return;
+	}
+	if (index >= 0) {
+		if (GameObject* moved = components.RemoveAt(index)) {
+			objectSlots[moved->GetHandle().index].*slotIndex = index;
+		}
+		objectSlots[o->GetHandle().index].*slotIndex = -1;
+	}
+}
+
+void GameWorld::RefreshComponents(GameObject* o) {
+	if (GetGameObject(o->GetHandle()) != o) {
+		return; //not in this world
+	}
+	UpdateComponentEntry(physicsComponents, &ObjectSlot::physicsIndex, o, o->GetPhysicsObject());
+	UpdateComponentEntry(renderComponents,	&ObjectSlot::renderIndex,	o, o->GetRenderObject());
+	UpdateComponentEntry(networkComponents, &ObjectSlot::networkIndex, o, o->GetNetworkObject());
+}
+
+void GameWorld::RefreshObjectSlots() {
+	for (int i = 0; i < (int)gameObjects.size(); ++i) {
+		objectSlots[gameObjects[i]->GetHandle().index].denseIndex = i;
+	}
+}
+
 void GameWorld::GetObjectIterators(
 	GameObjectIterator& first,
 	GameObjectIterator& last) const {
@@ -69,14 +236,36 @@ void GameWorld::OperateOnContents(GameObjectFunc f) {
 	}
 }
 
+void GameWorld::SetDeterministic(bool state) {
+	deterministic = state;
+	if (deterministic) {
+		//undo any earlier shuffling - world IDs are handed out in insertion order
+		std::sort(gameObjects.begin(), gameObjects.end(),
+			[](const GameObject* a, const GameObject* b) {
+				return a->GetWorldID() < b->GetWorldID();
+			}
+		);
+		RefreshObjectSlots();
+	}
+}
+
+void GameWorld::FlushCommands() {
+	commandBuffer.Apply(*this);
+}
+
 void GameWorld::UpdateWorld(float dt) {
-	auto rng = std::default_random_engine{};
+	FlushCommands();
+
+	if (deterministic) {
+		return; //the time-seeded shuffle would give a different order every run
+	}
 
 	unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
 	std::default_random_engine e(seed);
 
 	if (shuffleObjects) {
 		std::shuffle(gameObjects.begin(), gameObjects.end(), e);
+		RefreshObjectSlots();
 	}
 
 	if (shuffleConstraints) {
@@ -84,6 +273,24 @@ void GameWorld::UpdateWorld(float dt) {
 	}
 }
 
+/*
+Each root transform owns its whole hierarchy, and walks it parents first,
+so separate roots can be rebuilt on separate workers. Objects parented to
+something are skipped here - they're reached through their root.
+*/
+void GameWorld::UpdateTransforms() {
+	const int batchSize = 128;
+
+	JobSystem::Get().ParallelFor((int)gameObjects.size(), batchSize, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			const Transform& t = gameObjects[i]->GetTransform();
+			if (!t.GetParent()) {
+				t.UpdateHierarchy();
+			}
+		}
+	});
+}
+
 bool GameWorld::Raycast(Ray& r, RayCollision& closestCollision, bool closestObject, GameObject* ignoreThis) const {
 	//The simplest raycast just goes through each object and sees if there's a collision
 	RayCollision collision;
@@ -140,4 +347,110 @@ void GameWorld::GetConstraintIterators(
 	std::vector<Constraint*>::const_iterator& last) const {
 	first	= constraints.begin();
 	last	= constraints.end();
+}
+
+/*
+Snapshot Stuff
+
+Objects are written out as flat records tagged with their world ID. A
+snapshot can only be read back into the same world it was taken from - if
+anything has been added or removed since, the state counter won't match,
+and we refuse to restore rather than scattering state across the wrong
+objects. Constraint records are read back in list order, so shuffled
+constraints should only carry state that doesn't change at runtime.
+*/
+
+struct WorldSnapshotHeader {
+	int objectCount;
+	int constraintCount;
+	int worldStateCounter;
+};
+
+struct ObjectSnapshot {
+	int			worldID;
+	Vector3		position;
+	Quaternion	orientation;
+	Vector3		scale;
+
+	Vector3		linearVelocity;
+	Vector3		angularVelocity;
+	Vector3		force;
+	Vector3		torque;
+};
+
+void GameWorld::WriteSnapshot(WorldSnapshot& s) const {
+	WorldSnapshotHeader header;
+	header.objectCount			= (int)gameObjects.size();
+	header.constraintCount		= (int)constraints.size();
+	header.worldStateCounter	= worldStateCounter;
+	s.Write(header);
+
+	for (const GameObject* o : gameObjects) {
+		ObjectSnapshot os = {};
+		const Transform& t = o->GetTransform();
+		os.worldID		= o->GetWorldID();
+		os.position		= t.GetPosition();
+		os.orientation	= t.GetOrientation();
+		os.scale		= t.GetScale();
+
+		if (const PhysicsObject* p = o->GetPhysicsObject()) {
+			os.linearVelocity	= p->GetLinearVelocity();
+			os.angularVelocity	= p->GetAngularVelocity();
+			os.force			= p->GetForce();
+			os.torque			= p->GetTorque();
+		}
+		s.Write(os);
+	}
+	for (const Constraint* c : constraints) {
+		c->WriteSnapshot(s);
+	}
+}
+
+bool GameWorld::ReadSnapshot(const WorldSnapshot& s, size_t& offset) {
+	WorldSnapshotHeader header;
+	if (!s.Read(offset, header)) {
+		return false;
+	}
+	if (header.objectCount		!= (int)gameObjects.size() ||
+		header.constraintCount	!= (int)constraints.size() ||
+		header.worldStateCounter	!= worldStateCounter) {
+		return false; //world has changed shape since this snapshot was taken
+	}
+	//Objects may have been shuffled since the snapshot was written, so
+	//records are matched up by world ID rather than by position
+	snapshotLookup.assign(worldIDCounter, nullptr);
+	for (GameObject* o : gameObjects) {
+		if (o->GetWorldID() >= 0 && o->GetWorldID() < worldIDCounter) {
+			snapshotLookup[o->GetWorldID()] = o;
+		}
+	}
+	for (int i = 0; i < header.objectCount; ++i) {
+		ObjectSnapshot os;
+		if (!s.Read(offset, os) || os.worldID < 0 || os.worldID >= worldIDCounter) {
+			return false;
+		}
+		GameObject* o = snapshotLookup[os.worldID];
+		if (!o) {
+			return false;
+		}
+		o->GetTransform()
+			.SetScale(os.scale)
+			.SetOrientation(os.orientation)
+			.SetPosition(os.position);
+
+		if (PhysicsObject* p = o->GetPhysicsObject()) {
+			p->SetLinearVelocity(os.linearVelocity);
+			p->SetAngularVelocity(os.angularVelocity);
+			p->ClearForces();
+			p->AddForce(os.force);
+			p->AddTorque(os.torque);
+			p->UpdateInertiaTensor();
+		}
+	}
+	for (Constraint* c : constraints) {
+		if (!c->ReadSnapshot(s, offset)) {
+			return false;
+		}
+	}
+	return true;
 }
\ No newline at end of file
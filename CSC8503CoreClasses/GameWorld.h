@@ -1,5 +1,9 @@
 #pragma once
 #include "./Camera.h"
+#include "GameObjectHandle.h"
+#include "ComponentArray.h"
+#include "WorldCommandBuffer.h"
+#include "Tag.h"
 
 namespace NCL {
 		namespace Maths {
@@ -12,6 +16,10 @@ namespace NCL {
 	namespace CSC8503 {
 		class GameObject;
 		class Constraint;
+		class PhysicsObject;
+		class RenderObject;
+		class NetworkObject;
+		class WorldSnapshot;
 
 		typedef std::function<void(GameObject*)> GameObjectFunc;
 		typedef std::vector<GameObject*>::const_iterator GameObjectIterator;
@@ -27,15 +35,86 @@ namespace NCL {
 
 			void AddGameObject(GameObject* o);
 			void RemoveGameObject(GameObject* o, bool andDelete = false);
+			void RemoveGameObject(GameObjectHandle h, bool andDelete = false);
+
+			//Returns nullptr if the object has been removed since the handle was taken
+			GameObject* GetGameObject(GameObjectHandle h) const 
+			{
+				if (h.index >= objectSlots.size()) {
+					return nullptr;
+				}
+				const ObjectSlot& slot = objectSlots[h.index];
+				if (slot.generation != h.generation || slot.denseIndex < 0) {
+					return nullptr;
+				}
+				return gameObjects[slot.denseIndex];
+			}
+
+			bool IsValid(GameObjectHandle h) const 
+			{
+				return GetGameObject(h) != nullptr;
+			}
+
+			/*
+			Systems holding their own pointers to objects (the physics collision
+			list, say) are told as each object is removed, while it's still
+			alive, so they can let go of it before it might be deleted. Returns
+			an ID to stop listening with.
+			*/
+			int		AddRemovalListener(const GameObjectFunc& f);
+			void	RemoveRemovalListener(int id);
+
+			//Called by GameObject when one of its components is swapped out
+			void RefreshComponents(GameObject* o);
+
+			//Called by GameObject when it gains or loses a tag
+			void RefreshTag(GameObject* o, Tag t, bool hasTag);
+
+			//Every object in the world with this tag, in no particular order
+			const std::vector<GameObject*>& GetObjectsWithTag(Tag t) const;
+
+			const ComponentArray<PhysicsObject>& GetPhysicsComponents() const 
+			{
+				return physicsComponents;
+			}
+
+			const ComponentArray<RenderObject>& GetRenderComponents() const 
+			{
+				return renderComponents;
+			}
+
+			const ComponentArray<NetworkObject>& GetNetworkComponents() const 
+			{
+				return networkComponents;
+			}
 
 			void AddConstraint(Constraint* c);
 			void RemoveConstraint(Constraint* c, bool andDelete = false);
 
+			/*
+			Anything that might run while the object or constraint lists are
+			being iterated (collision callbacks, gameplay and dialogue logic,
+			parallel system updates) should record its adds and removes here
+			instead, to be applied at the next sync point.
+			*/
+			WorldCommandBuffer& GetCommandBuffer() 
+			{
+				return commandBuffer;
+			}
+
+			//The sync point - called at the start of UpdateWorld
+			void FlushCommands();
+
 			PerspectiveCamera& GetMainCamera()  
 			{
 				return mainCamera;
 			}
 
+			const PerspectiveCamera& GetMainCamera() const 
+			{
+				return mainCamera;
+			}
+
 			void ShuffleConstraints(bool state) 
 			{
 				shuffleConstraints = state;
@@ -46,10 +125,16 @@ namespace NCL {
 				shuffleObjects = state;
 			}
 
+			//Deterministic worlds start from world ID order and never shuffle
+			void SetDeterministic(bool state);
+
 			bool Raycast(Ray& r, RayCollision& closestCollision, bool closestObject = false, GameObject* ignore = nullptr) const;
 
 			virtual void UpdateWorld(float dt);
 
+			//Rebuilds every dirty world matrix, once, after the last thing to move objects this frame
+			void UpdateTransforms();
+
 			void OperateOnContents(GameObjectFunc f);
 
 			void GetObjectIterators(
@@ -65,6 +150,15 @@ namespace NCL {
 				return worldStateCounter;
 			}
 
+			void WriteSnapshot(WorldSnapshot& s) const;
+			bool ReadSnapshot(const WorldSnapshot& s, size_t& offset);
+
+			//Only valid after a successful ReadSnapshot, and until the world next changes
+			GameObject* GetSnapshotObject(int worldID) const 
+			{
+				return (worldID >= 0 && worldID < (int)snapshotLookup.size()) ? snapshotLookup[worldID] : nullptr;
+			}
+
 			void SetSunPosition(const Vector3& pos) 
 			{
 				sunPosition = pos;
@@ -86,13 +180,50 @@ namespace NCL {
 			}
 
 		protected:
+			void RefreshObjectSlots();
+
+			/*
+			Objects live in a slot map: gameObjects stays densely packed for
+			iteration, while each object's handle indexes a slot that tracks
+			where it currently sits in that array. Removal swaps the last
+			object into the gap, so adding, removing and lookups are all O(1).
+			*/
+			struct ObjectSlot {
+				uint32_t	generation	= 0;
+				int			denseIndex	= -1;
+
+				//where this object's entries sit in each component array
+				int			physicsIndex	= -1;
+				int			renderIndex		= -1;
+				int			networkIndex	= -1;
+			};
+
+			template <typename T>
+			void UpdateComponentEntry(ComponentArray<T>& components, int ObjectSlot::* slotIndex, GameObject* o, T* component);
+
 			std::vector<GameObject*> gameObjects;
+			std::vector<ObjectSlot>	 objectSlots;
+			std::vector<uint32_t>	 freeObjectSlots;
+
+			ComponentArray<PhysicsObject>	physicsComponents;
+			ComponentArray<RenderObject>	renderComponents;
+			ComponentArray<NetworkObject>	networkComponents;
 			std::vector<Constraint*> constraints;
 
+			std::vector<GameObject*>	taggedObjects[MaxTags];
+
+			WorldCommandBuffer	commandBuffer;
+
+			std::vector<GameObject*> snapshotLookup;
+
+			std::vector<std::pair<int, GameObjectFunc>> removalListeners;
+			int		removalListenerCounter;
+
 			PerspectiveCamera mainCamera;
 
 			bool	shuffleConstraints;
 			bool	shuffleObjects;
+			bool	deterministic;
 			int		worldIDCounter;
 			int		worldStateCounter;
 
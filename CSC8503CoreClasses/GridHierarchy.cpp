@@ -0,0 +1,448 @@
+#include "GridHierarchy.h"
+#include "NavigationGrid.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+using namespace NCL;
+using namespace CSC8503;
+
+const float DIAGONAL_COST = 1.41421356f;
+
+//Open runs along a cluster edge at least this long get an entrance at each end, rather than one in the middle
+const int LONG_ENTRANCE = 6;
+
+GridHierarchy::GridHierarchy(const NavigationGrid& grid, int clusterSize) : grid(grid) {
+	this->clusterSize	= std::max(clusterSize, 2);
+	diagonals			= grid.GetDiagonalMovement();
+
+	clustersX	= (grid.GetWidth() + this->clusterSize - 1) / this->clusterSize;
+	clustersZ	= (grid.GetHeight() + this->clusterSize - 1) / this->clusterSize;
+
+	std::vector<char> dirty(clustersX * clustersZ, 1);
+	Build(dirty);
+}
+
+GridHierarchy::~GridHierarchy() {
+}
+
+void GridHierarchy::UpdateCells(const std::vector<int>& changedCells) {
+	std::vector<char> dirty(clustersX * clustersZ, 0);
+	for (int cell : changedCells) {
+		dirty[ClusterOf(cell)] = 1;
+	}
+	Build(dirty);
+}
+
+/*
+Finding the entrances is one pass along the cluster edges, so it's always
+done in full - it's the searches between entrances inside each cluster
+that take the time, and a cluster whose cells and entrances are all as
+they were can keep the routes it had.
+*/
+void GridHierarchy::Build(std::vector<char>& dirtyClusters) {
+	int width	= grid.GetWidth();
+	int height	= grid.GetHeight();
+
+	std::vector<Entrance>	oldEntrances;
+	std::vector<Edge>		oldEdges;
+	std::vector<int>		oldStarts;
+	std::vector<int>		oldClusterEntrances;
+	oldEntrances.swap(entrances);
+	oldEdges.swap(edges);
+	oldStarts.swap(clusterStarts);
+	oldClusterEntrances.swap(clusterEntrances);
+
+	std::vector<std::vector<Edge>>	entranceEdges;
+	std::unordered_map<int, int>	cellEntrances;
+
+	auto getEntrance = [&](int cell) {
+		auto found = cellEntrances.find(cell);
+		if (found != cellEntrances.end()) {
+			return found->second;
+		}
+		Entrance e;
+		e.cell		= cell;
+		e.cluster	= ClusterOf(cell);
+		e.firstEdge	= 0;
+		e.edgeCount	= 0;
+		entrances.push_back(e);
+		entranceEdges.emplace_back();
+		cellEntrances.insert({ cell, (int)entrances.size() - 1 });
+		return (int)entrances.size() - 1;
+	};
+	//a and b are neighbouring cells either side of a cluster edge
+	auto addTransition = [&](int a, int b) {
+		int entranceA = getEntrance(a);
+		int entranceB = getEntrance(b);
+		entranceEdges[entranceA].push_back({ entranceB, 1.0f });
+		entranceEdges[entranceB].push_back({ entranceA, 1.0f });
+	};
+	//firstA / firstB are the first pair of cells of an open run, step moves along it
+	auto addRun = [&](int firstA, int firstB, int step, int length) {
+		if (length < LONG_ENTRANCE) {
+			int middle = (length / 2) * step;
+			addTransition(firstA + middle, firstB + middle);
+			return;
+		}
+		int last = (length - 1) * step;
+		addTransition(firstA, firstB);
+		addTransition(firstA + last, firstB + last);
+	};
+
+	//edges between clusters side by side along x
+	for (int cx = 1; cx < clustersX; ++cx) {
+		int x = cx * clusterSize;
+		for (int cz = 0; cz < clustersZ; ++cz) {
+			int zStart	= cz * clusterSize;
+			int zEnd	= std::min(zStart + clusterSize, height);
+			int runStart = -1;
+			for (int z = zStart; z <= zEnd; ++z) {
+				bool open = z < zEnd && grid.IsWalkable(x - 1, z) && grid.IsWalkable(x, z);
+				if (open && runStart < 0) {
+					runStart = z;
+				}
+				else if (!open && runStart >= 0) {
+					int first = (runStart * width) + x;
+					addRun(first - 1, first, width, z - runStart);
+					runStart = -1;
+				}
+			}
+		}
+	}
+	//and along z
+	for (int cz = 1; cz < clustersZ; ++cz) {
+		int z = cz * clusterSize;
+		for (int cx = 0; cx < clustersX; ++cx) {
+			int xStart	= cx * clusterSize;
+			int xEnd	= std::min(xStart + clusterSize, width);
+			int runStart = -1;
+			for (int x = xStart; x <= xEnd; ++x) {
+				bool open = x < xEnd && grid.IsWalkable(x, z - 1) && grid.IsWalkable(x, z);
+				if (open && runStart < 0) {
+					runStart = x;
+				}
+				else if (!open && runStart >= 0) {
+					int first = (z * width) + runStart;
+					addRun(first - width, first, 1, x - runStart);
+					runStart = -1;
+				}
+			}
+		}
+	}
+
+	int clusterCount = clustersX * clustersZ;
+	clusterStarts.assign(clusterCount + 1, 0);
+	for (const Entrance& e : entrances) {
+		clusterStarts[e.cluster + 1]++;
+	}
+	for (int c = 0; c < clusterCount; ++c) {
+		clusterStarts[c + 1] += clusterStarts[c];
+	}
+	clusterEntrances.resize(entrances.size());
+	std::vector<int> fill(clusterStarts.begin(), clusterStarts.end() - 1);
+	for (int i = 0; i < (int)entrances.size(); ++i) {
+		clusterEntrances[fill[entrances[i].cluster]++] = i;
+	}
+
+	//entrances are found in the same order every time, so a cluster's are unchanged if the same cells turn up in the same places
+	std::vector<int> oldPosition(oldEntrances.size());
+	for (int c = 0; c < clusterCount; ++c) {
+		if (oldStarts.empty()) {
+			break;
+		}
+		int count = clusterStarts[c + 1] - clusterStarts[c];
+		bool same = (count == oldStarts[c + 1] - oldStarts[c]);
+		for (int k = 0; k < oldStarts[c + 1] - oldStarts[c]; ++k) {
+			int oldEntrance = oldClusterEntrances[oldStarts[c] + k];
+			oldPosition[oldEntrance] = k;
+			if (same && oldEntrances[oldEntrance].cell != entrances[clusterEntrances[clusterStarts[c] + k]].cell) {
+				same = false;
+			}
+		}
+		if (!same) {
+			dirtyClusters[c] = 1;
+		}
+	}
+	//the routes inside a clean cluster are copied across in the order they were found, so it comes out as a full build would
+	auto copyIntraEdges = [&](int c) {
+		for (int k = 0; k < clusterStarts[c + 1] - clusterStarts[c]; ++k) {
+			const Entrance& old	= oldEntrances[oldClusterEntrances[oldStarts[c] + k]];
+			int entrance		= clusterEntrances[clusterStarts[c] + k];
+			for (int i = old.firstEdge; i < old.firstEdge + old.edgeCount; ++i) {
+				const Edge& e = oldEdges[i];
+				if (oldEntrances[e.to].cluster != c) {
+					continue; //a step to another cluster - those have just been found again
+				}
+				entranceEdges[entrance].push_back({ clusterEntrances[clusterStarts[c] + oldPosition[e.to]], e.cost });
+			}
+		}
+	};
+
+	//every cluster is independent of the others, and only adds edges to its own entrances
+	JobSystem::Get().ParallelFor(clusterCount, 16, [&](int start, int end) {
+		PathSearchState state;
+		for (int c = start; c < end; ++c) {
+			if (dirtyClusters[c]) {
+				BuildIntraEdges(c, entranceEdges, state);
+			}
+			else {
+				copyIntraEdges(c);
+			}
+		}
+	});
+
+	for (int i = 0; i < (int)entrances.size(); ++i) {
+		entrances[i].firstEdge = (int)edges.size();
+		entrances[i].edgeCount = (int)entranceEdges[i].size();
+		edges.insert(edges.end(), entranceEdges[i].begin(), entranceEdges[i].end());
+	}
+}
+
+//Routes inside a cluster are the same both ways, so each pair of entrances is only searched once
+void GridHierarchy::BuildIntraEdges(int cluster, std::vector<std::vector<Edge>>& entranceEdges, PathSearchState& state) const {
+	Region r	= ClusterRegion(cluster);
+	int first	= clusterStarts[cluster];
+	int last	= clusterStarts[cluster + 1];
+
+	for (int i = first; i < last - 1; ++i) {
+		int from = clusterEntrances[i];
+		SearchRegion(r, entrances[from].cell, PathSearchState::NoNode, state);
+
+		for (int j = i + 1; j < last; ++j) {
+			int to		= clusterEntrances[j];
+			int local	= ToLocal(r, entrances[to].cell);
+			if (!state.IsClosed(local)) {
+				continue; //walled off from each other within this cluster
+			}
+			float cost = state.GetCost(local);
+			entranceEdges[from].push_back({ to, cost });
+			entranceEdges[to].push_back({ from, cost });
+		}
+	}
+}
+
+bool GridHierarchy::FindPath(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const {
+	if (!grid.IsWalkable(endIndex % grid.GetWidth(), endIndex / grid.GetWidth())) {
+		return false;
+	}
+	int startCluster	= ClusterOf(startIndex);
+	int endCluster		= ClusterOf(endIndex);
+	Region startRegion	= ClusterRegion(startCluster);
+	Region endRegion	= ClusterRegion(endCluster);
+
+	//link the start and end into the graph, through whichever entrances of their clusters they can reach
+	std::vector<EntranceCost> startCosts;
+	std::vector<EntranceCost> endCosts;
+
+	SearchRegion(startRegion, startIndex, PathSearchState::NoNode, state);
+	for (int i = clusterStarts[startCluster]; i < clusterStarts[startCluster + 1]; ++i) {
+		int local = ToLocal(startRegion, entrances[clusterEntrances[i]].cell);
+		if (state.IsClosed(local)) {
+			startCosts.push_back({ clusterEntrances[i], state.GetCost(local) });
+		}
+	}
+	SearchRegion(endRegion, endIndex, PathSearchState::NoNode, state);
+	for (int i = clusterStarts[endCluster]; i < clusterStarts[endCluster + 1]; ++i) {
+		int local = ToLocal(endRegion, entrances[clusterEntrances[i]].cell);
+		if (state.IsClosed(local)) {
+			endCosts.push_back({ clusterEntrances[i], state.GetCost(local) });
+		}
+	}
+
+	//if the clusters touch, the direct route within the two of them is worth a look too
+	Region nearRegion;
+	nearRegion.minX = std::min(startRegion.minX, endRegion.minX);
+	nearRegion.minZ = std::min(startRegion.minZ, endRegion.minZ);
+	nearRegion.maxX = std::max(startRegion.maxX, endRegion.maxX);
+	nearRegion.maxZ = std::max(startRegion.maxZ, endRegion.maxZ);
+
+	float directCost = -1.0f;
+	if (nearRegion.GetWidth() <= clusterSize * 2 && nearRegion.maxZ - nearRegion.minZ <= clusterSize * 2) {
+		if (SearchRegion(nearRegion, startIndex, endIndex, state)) {
+			directCost = state.GetCost(ToLocal(nearRegion, endIndex));
+		}
+	}
+
+	//the start and end go in after the real entrances
+	int startNode	= (int)entrances.size();
+	int endNode		= startNode + 1;
+
+	state.Begin(endNode + 1);
+	state.Open(startNode, 0.0f, Heuristic(startIndex, endIndex), PathSearchState::NoNode);
+
+	bool found = false;
+	while (state.HasOpenNodes()) {
+		int current = state.PopBest();
+		if (current == endNode) {
+			found = true;
+			break;
+		}
+		float g = state.GetCost(current);
+
+		if (current == startNode) {
+			for (const EntranceCost& c : startCosts) {
+				state.Open(c.entrance, g + c.cost, Heuristic(entrances[c.entrance].cell, endIndex), current);
+			}
+			if (directCost >= 0.0f) {
+				state.Open(endNode, directCost, 0.0f, current);
+			}
+			continue;
+		}
+		const Entrance& e = entrances[current];
+		for (int i = e.firstEdge; i < e.firstEdge + e.edgeCount; ++i) {
+			const Edge& edge = edges[i];
+			if (state.IsClosed(edge.to)) {
+				continue;
+			}
+			state.Open(edge.to, g + edge.cost, Heuristic(entrances[edge.to].cell, endIndex), current);
+		}
+		if (e.cluster == endCluster) {
+			for (const EntranceCost& c : endCosts) {
+				if (c.entrance == current) {
+					state.Open(endNode, g + c.cost, 0.0f, current);
+				}
+			}
+		}
+	}
+	if (!found) {
+		return false;
+	}
+
+	std::vector<int> cells;
+	cells.push_back(startIndex);
+
+	if (state.GetParent(endNode) == startNode) { //went direct
+		RefineSegment(nearRegion, startIndex, endIndex, cells, state);
+	}
+	else {
+		std::vector<int> route;
+		for (int node = state.GetParent(endNode); node != startNode; node = state.GetParent(node)) {
+			route.push_back(entrances[node].cell);
+		}
+		route.push_back(startIndex);
+		std::reverse(route.begin(), route.end());
+		route.push_back(endIndex);
+
+		//now fill in the cells - steps between clusters are already next to each other
+		for (int i = 1; i < (int)route.size(); ++i) {
+			int fromCluster	= ClusterOf(route[i - 1]);
+			if (fromCluster == ClusterOf(route[i])) {
+				RefineSegment(ClusterRegion(fromCluster), route[i - 1], route[i], cells, state);
+			}
+			else {
+				cells.push_back(route[i]);
+			}
+		}
+	}
+	for (int i = (int)cells.size() - 1; i >= 0; --i) {
+		outPath.PushWaypoint(grid.GetNode(cells[i]).position);
+	}
+	return true;
+}
+
+int GridHierarchy::ClusterOf(int cell) const {
+	int x = cell % grid.GetWidth();
+	int z = cell / grid.GetWidth();
+	return ((z / clusterSize) * clustersX) + (x / clusterSize);
+}
+
+GridHierarchy::Region GridHierarchy::ClusterRegion(int cluster) const {
+	Region r;
+	r.minX = (cluster % clustersX) * clusterSize;
+	r.minZ = (cluster / clustersX) * clusterSize;
+	r.maxX = std::min(r.minX + clusterSize, grid.GetWidth());
+	r.maxZ = std::min(r.minZ + clusterSize, grid.GetHeight());
+	return r;
+}
+
+int GridHierarchy::ToLocal(const Region& r, int cell) const {
+	int x = (cell % grid.GetWidth()) - r.minX;
+	int z = (cell / grid.GetWidth()) - r.minZ;
+	return (z * r.GetWidth()) + x;
+}
+
+int GridHierarchy::ToCell(const Region& r, int local) const {
+	int x = r.minX + (local % r.GetWidth());
+	int z = r.minZ + (local / r.GetWidth());
+	return (z * grid.GetWidth()) + x;
+}
+
+/*
+A* (or Dijkstra, with no target) that never leaves the region. Nodes in the
+search state are local to the region, so it only ever needs a few clusters'
+worth of records, whatever the size of the map.
+*/
+bool GridHierarchy::SearchRegion(const Region& r, int source, int target, PathSearchState& state) const {
+	auto inside = [&](int x, int z) {
+		return x >= r.minX && x < r.maxX && z >= r.minZ && z < r.maxZ && grid.IsWalkable(x, z);
+	};
+	int localTarget = (target == PathSearchState::NoNode) ? PathSearchState::NoNode : ToLocal(r, target);
+
+	state.Begin(r.GetWidth() * (r.maxZ - r.minZ));
+	state.Open(ToLocal(r, source), 0.0f, 0.0f, PathSearchState::NoNode);
+
+	while (state.HasOpenNodes()) {
+		int current = state.PopBest();
+		if (current == localTarget) {
+			return true;
+		}
+		int x = r.minX + (current % r.GetWidth());
+		int z = r.minZ + (current / r.GetWidth());
+		float g = state.GetCost(current);
+
+		auto tryStep = [&](int nx, int nz, float cost) {
+			int local = ((nz - r.minZ) * r.GetWidth()) + (nx - r.minX);
+			if (state.IsClosed(local)) {
+				return;
+			}
+			float h = (localTarget == PathSearchState::NoNode) ? 0.0f : Heuristic((nz * grid.GetWidth()) + nx, target);
+			state.Open(local, g + cost, h, current);
+		};
+		const int straight[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+		for (int i = 0; i < 4; ++i) {
+			if (inside(x + straight[i][0], z + straight[i][1])) {
+				tryStep(x + straight[i][0], z + straight[i][1], 1.0f);
+			}
+		}
+		if (!diagonals) {
+			continue;
+		}
+		for (int dz = -1; dz <= 1; dz += 2) {
+			for (int dx = -1; dx <= 1; dx += 2) {
+				//no cutting corners, same as the full grid search
+				if (inside(x + dx, z + dz) && inside(x + dx, z) && inside(x, z + dz)) {
+					tryStep(x + dx, z + dz, DIAGONAL_COST);
+				}
+			}
+		}
+	}
+	return target == PathSearchState::NoNode;
+}
+
+void GridHierarchy::RefineSegment(const Region& r, int from, int to, std::vector<int>& cells, PathSearchState& state) const {
+	if (from == to) {
+		return;
+	}
+	SearchRegion(r, from, to, state);
+
+	size_t first = cells.size();
+	int localFrom = ToLocal(r, from);
+	for (int node = ToLocal(r, to); node != localFrom; node = state.GetParent(node)) {
+		cells.push_back(ToCell(r, node));
+	}
+	std::reverse(cells.begin() + first, cells.end());
+}
+
+//Same estimate as the grid's own searches
+float GridHierarchy::Heuristic(int fromCell, int toCell) const {
+	int dx = std::abs((fromCell % grid.GetWidth()) - (toCell % grid.GetWidth()));
+	int dz = std::abs((fromCell / grid.GetWidth()) - (toCell / grid.GetWidth()));
+	if (!diagonals) {
+		return (float)(dx + dz);
+	}
+	int diagonal = std::min(dx, dz);
+	return (float)(dx + dz - 2 * diagonal) + (diagonal * DIAGONAL_COST);
+}
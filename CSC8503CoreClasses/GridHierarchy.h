@@ -0,0 +1,129 @@
+#pragma once
+#include "NavigationPath.h"
+#include "PathSearchState.h"
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		class NavigationGrid;
+
+		/*
+		HPA* - the grid is cut up into square clusters, and wherever two
+		neighbouring clusters have open floor along their shared edge, an
+		entrance is put on each side of it. Within each cluster the shortest
+		routes between its entrances are found once, at build time, so the
+		entrances and those routes make a much smaller graph that covers the
+		whole map.
+
+		A query links its start and end into the graph by searching just
+		their own clusters, searches the small graph, and then only fills in
+		the cells of the clusters that route actually passes through - each
+		of those is a search bounded to one cluster. Only the costs of the
+		routes inside clusters are kept, not their cells, so memory grows
+		with the number of entrances rather than with path lengths.
+
+		Paths are within a few percent of the shortest (they have to pass
+		through entrances), and a query never touches more than a few
+		clusters' worth of cells at a time, however big the map is. Queries
+		between neighbouring clusters also try the direct route, as going via
+		an entrance can be a long way round over short distances.
+
+		Built for the grid's diagonal setting at the time - rebuild it if that
+		changes. When cells open up or get blocked, UpdateCells only searches
+		the routes of the clusters they're in (and any whose entrances moved)
+		again. Holds a reference to the grid, so must not outlive it.
+		*/
+		class GridHierarchy {
+		public:
+			GridHierarchy(const NavigationGrid& grid, int clusterSize);
+			~GridHierarchy();
+
+			//Node indices are the grid's. Only reads the hierarchy, so any number of these can run at once
+			bool FindPath(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const;
+
+			//Call once the grid has changed whether these cells are walkable. Not thread safe
+			void UpdateCells(const std::vector<int>& changedCells);
+
+			int GetClusterSize() const {
+				return clusterSize;
+			}
+
+			bool GetDiagonalMovement() const {
+				return diagonals;
+			}
+
+			int GetClusterCount() const {
+				return clustersX * clustersZ;
+			}
+
+			int GetEntranceCount() const {
+				return (int)entrances.size();
+			}
+
+			int GetEdgeCount() const {
+				return (int)edges.size();
+			}
+
+		protected:
+			struct Entrance {
+				int cell;
+				int cluster;
+				int firstEdge;
+				int edgeCount;
+			};
+
+			struct Edge {
+				int		to;
+				float	cost;
+			};
+
+			//How far a query's start or end is from an entrance of its cluster
+			struct EntranceCost {
+				int		entrance;
+				float	cost;
+			};
+
+			//A rectangle of cells searches are kept inside - max is exclusive
+			struct Region {
+				int minX;
+				int minZ;
+				int maxX;
+				int maxZ;
+
+				int GetWidth() const {
+					return maxX - minX;
+				}
+			};
+
+			//Finds the entrances again, and the routes inside every cluster flagged dirty - the rest are copied from before
+			void	Build(std::vector<char>& dirtyClusters);
+
+			int		ClusterOf(int cell) const;
+			Region	ClusterRegion(int cluster) const;
+			void	BuildIntraEdges(int cluster, std::vector<std::vector<Edge>>& entranceEdges, PathSearchState& state) const;
+
+			//Search within a region from source - to target, or to everything reachable if target is NoNode
+			bool	SearchRegion(const Region& r, int source, int target, PathSearchState& state) const;
+			//Appends the cells after 'from', up to and including 'to', along a shortest route inside the region
+			void	RefineSegment(const Region& r, int from, int to, std::vector<int>& cells, PathSearchState& state) const;
+
+			int		ToLocal(const Region& r, int cell) const;
+			int		ToCell(const Region& r, int local) const;
+			float	Heuristic(int fromCell, int toCell) const;
+
+			const NavigationGrid& grid;
+
+			int		clusterSize;
+			int		clustersX;
+			int		clustersZ;
+			bool	diagonals;
+
+			std::vector<Entrance>	entrances;
+			std::vector<Edge>		edges;
+
+			//entrances of cluster c are clusterEntrances[clusterStarts[c]] to clusterEntrances[clusterStarts[c + 1] - 1]
+			std::vector<int>		clusterStarts;
+			std::vector<int>		clusterEntrances;
+		};
+	}
+}
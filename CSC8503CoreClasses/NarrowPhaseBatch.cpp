@@ -0,0 +1,259 @@
+#include "NarrowPhaseBatch.h"
+#include "GameObject.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NARROWPHASE_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace NCL;
+using namespace CSC8503;
+
+/*
+The kernels only decide which pairs are worth the full test, so they're
+allowed to let a few extra through - sizes are scaled up slightly so that
+float rounding can never cull a pair the scalar test would have accepted.
+*/
+const float cullSlack = 1.001f;
+
+void NarrowPhaseBatch::PairBucket::Clear() {
+	a.clear();
+	b.clear();
+	candidates.clear();
+}
+
+void NarrowPhaseBatch::PairBucket::Gather(BucketType type) {
+	size_t count	= a.size();
+	size_t padded	= (count + 3) & ~3;
+
+	//Padding lanes are all zeroes, which every kernel rejects (0 < 0 is false)
+	for (std::vector<float>* v : { &ax, &ay, &az, &bx, &by, &bz, &aSizeX, &aSizeY, &aSizeZ, &bSizeX, &bSizeY, &bSizeZ }) {
+		v->assign(padded, 0.0f);
+	}
+	for (size_t i = 0; i < count; ++i) {
+		Vector3 posA = a[i]->GetTransform().GetPosition();
+		Vector3 posB = b[i]->GetTransform().GetPosition();
+		ax[i] = posA.x; ay[i] = posA.y; az[i] = posA.z;
+		bx[i] = posB.x; by[i] = posB.y; bz[i] = posB.z;
+
+		const CollisionVolume* volA = a[i]->GetBoundingVolume();
+		const CollisionVolume* volB = b[i]->GetBoundingVolume();
+
+		if (type == SphereSphere) {
+			aSizeX[i] = ((const SphereVolume*)volA)->GetRadius() * cullSlack;
+			bSizeX[i] = ((const SphereVolume*)volB)->GetRadius() * cullSlack;
+			continue;
+		}
+		Vector3 halfA = ((const AABBVolume*)volA)->GetHalfDimensions() * cullSlack;
+		aSizeX[i] = halfA.x; aSizeY[i] = halfA.y; aSizeZ[i] = halfA.z;
+
+		if (type == AABBAABB) {
+			Vector3 halfB = ((const AABBVolume*)volB)->GetHalfDimensions() * cullSlack;
+			bSizeX[i] = halfB.x; bSizeY[i] = halfB.y; bSizeZ[i] = halfB.z;
+		}
+		else {
+			bSizeX[i] = ((const SphereVolume*)volB)->GetRadius() * cullSlack;
+		}
+	}
+}
+
+void NarrowPhaseBatch::Clear() {
+	for (PairBucket& b : buckets) {
+		b.Clear();
+	}
+}
+
+void NarrowPhaseBatch::AddPair(GameObject* a, GameObject* b) {
+	const CollisionVolume* volA = a->GetBoundingVolume();
+	const CollisionVolume* volB = b->GetBoundingVolume();
+	if (!volA || !volB) {
+		return;
+	}
+	BucketType type = Other;
+
+	if (volA->type == VolumeType::Sphere && volB->type == VolumeType::Sphere) {
+		type = SphereSphere;
+	}
+	else if (volA->type == VolumeType::AABB && volB->type == VolumeType::AABB) {
+		type = AABBAABB;
+	}
+	else if (volA->type == VolumeType::AABB && volB->type == VolumeType::Sphere) {
+		type = AABBSphere;
+	}
+	else if (volA->type == VolumeType::Sphere && volB->type == VolumeType::AABB) {
+		type = AABBSphere;
+		std::swap(a, b);
+	}
+	buckets[type].a.push_back(a);
+	buckets[type].b.push_back(b);
+}
+
+void NarrowPhaseBatch::Cull() {
+	for (int b = 0; b < MaxBuckets; ++b) {
+		PairBucket& bucket = buckets[b];
+		bucket.candidates.clear();
+		if (bucket.a.empty()) {
+			continue;
+		}
+		if (b == Other) { //no kernel for these, everything goes through to the exact test
+			for (int i = 0; i < (int)bucket.a.size(); ++i) {
+				bucket.candidates.push_back(i);
+			}
+			continue;
+		}
+		bucket.Gather((BucketType)b);
+
+		switch (b) {
+			case SphereSphere:	SphereSphereKernel(bucket);	break;
+			case AABBAABB:		AABBAABBKernel(bucket);		break;
+			case AABBSphere:	AABBSphereKernel(bucket);	break;
+		}
+	}
+}
+
+int NarrowPhaseBatch::GetPairsTested() const {
+	int count = 0;
+	for (const PairBucket& b : buckets) {
+		count += (int)b.a.size();
+	}
+	return count;
+}
+
+int NarrowPhaseBatch::GetCandidateCount() const {
+	int count = 0;
+	for (const PairBucket& b : buckets) {
+		count += (int)b.candidates.size();
+	}
+	return count;
+}
+
+bool NarrowPhaseBatch::ExactTest(BucketType type, GameObject* a, GameObject* b, CollisionDetection::CollisionInfo& info) {
+	info.a = a;
+	info.b = b;
+	const CollisionVolume* volA = a->GetBoundingVolume();
+	const CollisionVolume* volB = b->GetBoundingVolume();
+
+	switch (type) {
+		case SphereSphere:
+			return CollisionDetection::SphereIntersection((const SphereVolume&)*volA, a->GetTransform(), (const SphereVolume&)*volB, b->GetTransform(), info);
+		case AABBAABB:
+			return CollisionDetection::AABBIntersection((const AABBVolume&)*volA, a->GetTransform(), (const AABBVolume&)*volB, b->GetTransform(), info);
+		case AABBSphere:
+			return CollisionDetection::AABBSphereIntersection((const AABBVolume&)*volA, a->GetTransform(), (const SphereVolume&)*volB, b->GetTransform(), info);
+		default: {
+			if (!axisCache || !CollisionDetection::UsesSATAxis(*volA, *volB)) {
+				return CollisionDetection::ObjectIntersection(a, b, info);
+			}
+			info.satAxis = axisCache->GetAxis(a->GetWorldID(), b->GetWorldID());
+			bool collided = CollisionDetection::ObjectIntersection(a, b, info);
+			axisCache->StoreAxis(a->GetWorldID(), b->GetWorldID(), info.satAxis);
+			return collided;
+		}
+	}
+}
+
+#ifdef NARROWPHASE_USE_SSE
+static inline __m128 Abs4(__m128 v) {
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+static inline void PushCandidates(std::vector<int>& candidates, int first, int mask, int count) {
+	for (int lane = 0; lane < 4; ++lane) {
+		if ((mask & (1 << lane)) && first + lane < count) {
+			candidates.push_back(first + lane);
+		}
+	}
+}
+
+void NarrowPhaseBatch::SphereSphereKernel(PairBucket& bucket) {
+	int count = (int)bucket.a.size();
+	for (int i = 0; i < count; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&bucket.bx[i]), _mm_loadu_ps(&bucket.ax[i]));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&bucket.by[i]), _mm_loadu_ps(&bucket.ay[i]));
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(&bucket.bz[i]), _mm_loadu_ps(&bucket.az[i]));
+
+		__m128 distSq	= _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		__m128 radii	= _mm_add_ps(_mm_loadu_ps(&bucket.aSizeX[i]), _mm_loadu_ps(&bucket.bSizeX[i]));
+
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(radii, radii)));
+		PushCandidates(bucket.candidates, i, mask, count);
+	}
+}
+
+void NarrowPhaseBatch::AABBAABBKernel(PairBucket& bucket) {
+	int count = (int)bucket.a.size();
+	for (int i = 0; i < count; i += 4) {
+		__m128 dx = Abs4(_mm_sub_ps(_mm_loadu_ps(&bucket.bx[i]), _mm_loadu_ps(&bucket.ax[i])));
+		__m128 dy = Abs4(_mm_sub_ps(_mm_loadu_ps(&bucket.by[i]), _mm_loadu_ps(&bucket.ay[i])));
+		__m128 dz = Abs4(_mm_sub_ps(_mm_loadu_ps(&bucket.bz[i]), _mm_loadu_ps(&bucket.az[i])));
+
+		__m128 sx = _mm_add_ps(_mm_loadu_ps(&bucket.aSizeX[i]), _mm_loadu_ps(&bucket.bSizeX[i]));
+		__m128 sy = _mm_add_ps(_mm_loadu_ps(&bucket.aSizeY[i]), _mm_loadu_ps(&bucket.bSizeY[i]));
+		__m128 sz = _mm_add_ps(_mm_loadu_ps(&bucket.aSizeZ[i]), _mm_loadu_ps(&bucket.bSizeZ[i]));
+
+		__m128 overlap = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(dx, sx), _mm_cmplt_ps(dy, sy)), _mm_cmplt_ps(dz, sz));
+		PushCandidates(bucket.candidates, i, _mm_movemask_ps(overlap), count);
+	}
+}
+
+void NarrowPhaseBatch::AABBSphereKernel(PairBucket& bucket) {
+	int count = (int)bucket.a.size();
+	for (int i = 0; i < count; i += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&bucket.bx[i]), _mm_loadu_ps(&bucket.ax[i]));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&bucket.by[i]), _mm_loadu_ps(&bucket.ay[i]));
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(&bucket.bz[i]), _mm_loadu_ps(&bucket.az[i]));
+
+		__m128 hx = _mm_loadu_ps(&bucket.aSizeX[i]);
+		__m128 hy = _mm_loadu_ps(&bucket.aSizeY[i]);
+		__m128 hz = _mm_loadu_ps(&bucket.aSizeZ[i]);
+
+		//distance from the sphere centre to the closest point on the box
+		__m128 ox = _mm_sub_ps(dx, _mm_max_ps(_mm_min_ps(dx, hx), _mm_sub_ps(_mm_setzero_ps(), hx)));
+		__m128 oy = _mm_sub_ps(dy, _mm_max_ps(_mm_min_ps(dy, hy), _mm_sub_ps(_mm_setzero_ps(), hy)));
+		__m128 oz = _mm_sub_ps(dz, _mm_max_ps(_mm_min_ps(dz, hz), _mm_sub_ps(_mm_setzero_ps(), hz)));
+
+		__m128 distSq	= _mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), _mm_mul_ps(oz, oz));
+		__m128 radius	= _mm_loadu_ps(&bucket.bSizeX[i]);
+
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(radius, radius)));
+		PushCandidates(bucket.candidates, i, mask, count);
+	}
+}
+#else
+//Scalar fallbacks for targets without SSE - same maths, one pair at a time
+void NarrowPhaseBatch::SphereSphereKernel(PairBucket& bucket) {
+	for (int i = 0; i < (int)bucket.a.size(); ++i) {
+		float dx = bucket.bx[i] - bucket.ax[i];
+		float dy = bucket.by[i] - bucket.ay[i];
+		float dz = bucket.bz[i] - bucket.az[i];
+		float radii = bucket.aSizeX[i] + bucket.bSizeX[i];
+		if (dx * dx + dy * dy + dz * dz < radii * radii) {
+			bucket.candidates.push_back(i);
+		}
+	}
+}
+
+void NarrowPhaseBatch::AABBAABBKernel(PairBucket& bucket) {
+	for (int i = 0; i < (int)bucket.a.size(); ++i) {
+		if (std::abs(bucket.bx[i] - bucket.ax[i]) < bucket.aSizeX[i] + bucket.bSizeX[i] &&
+			std::abs(bucket.by[i] - bucket.ay[i]) < bucket.aSizeY[i] + bucket.bSizeY[i] &&
+			std::abs(bucket.bz[i] - bucket.az[i]) < bucket.aSizeZ[i] + bucket.bSizeZ[i]) {
+			bucket.candidates.push_back(i);
+		}
+	}
+}
+
+void NarrowPhaseBatch::AABBSphereKernel(PairBucket& bucket) {
+	for (int i = 0; i < (int)bucket.a.size(); ++i) {
+		Vector3 delta(bucket.bx[i] - bucket.ax[i], bucket.by[i] - bucket.ay[i], bucket.bz[i] - bucket.az[i]);
+		Vector3 half(bucket.aSizeX[i], bucket.aSizeY[i], bucket.aSizeZ[i]);
+		Vector3 offset = delta - Vector::Clamp(delta, -half, half);
+		float radius = bucket.bSizeX[i];
+		if (Vector::Dot(offset, offset) < radius * radius) {
+			bucket.candidates.push_back(i);
+		}
+	}
+}
+#endif
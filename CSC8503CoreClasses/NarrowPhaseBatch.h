@@ -0,0 +1,94 @@
+#pragma once
+#include "CollisionDetection.h"
+#include "SATAxisCache.h"
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameObject;
+
+		/*
+		The narrowphase used to push every broadphase pair through
+		CollisionDetection::ObjectIntersection one at a time. Most of those
+		pairs don't actually touch, so instead we sort them into buckets by
+		volume type pair, gather each bucket's positions and sizes into flat
+		arrays, and run a 4-wide SIMD overlap test across the whole bucket.
+		Only pairs that survive this cull go on to the full scalar test that
+		generates a contact point.
+
+		The cull runs on the positions at the start of the narrowphase, and
+		the exact test on whatever they are by the time the pair is resolved,
+		so a pair pushed into contact by an earlier resolution this substep
+		will be picked up on the next one.
+		*/
+		class NarrowPhaseBatch
+		{
+		public:
+			NarrowPhaseBatch()	= default;
+			~NarrowPhaseBatch() = default;
+
+			void Clear();
+
+			//OBB pairs in the fallback bucket will use and update this, if set
+			void SetAxisCache(SATAxisCache* cache) {
+				axisCache = cache;
+			}
+
+			void AddPair(GameObject* a, GameObject* b);
+
+			//Runs the SIMD cull over every bucket, leaving only candidate pairs
+			void Cull();
+
+			//Runs the exact test on each candidate, and calls onContact for each real collision
+			template <typename T>
+			void OperateOnContacts(T&& onContact) {
+				for (int b = 0; b < MaxBuckets; ++b) {
+					PairBucket& bucket = buckets[b];
+					for (int i : bucket.candidates) {
+						CollisionDetection::CollisionInfo info;
+						if (ExactTest((BucketType)b, bucket.a[i], bucket.b[i], info)) {
+							onContact(info);
+						}
+					}
+				}
+			}
+
+			int GetPairsTested() const;
+			int GetCandidateCount() const;
+
+		protected:
+			enum BucketType {
+				SphereSphere,
+				AABBAABB,
+				AABBSphere, //a is always the AABB
+				Other,
+				MaxBuckets
+			};
+
+			struct PairBucket {
+				std::vector<GameObject*> a;
+				std::vector<GameObject*> b;
+
+				//SoA copies of the data each kernel needs, padded to a multiple of 4
+				std::vector<float> ax, ay, az;
+				std::vector<float> bx, by, bz;
+				std::vector<float> aSizeX, aSizeY, aSizeZ; //AABB half sizes, or sphere radius in X
+				std::vector<float> bSizeX, bSizeY, bSizeZ;
+
+				std::vector<int> candidates;
+
+				void Clear();
+				void Gather(BucketType type);
+			};
+
+			bool ExactTest(BucketType type, GameObject* a, GameObject* b, CollisionDetection::CollisionInfo& info);
+
+			static void SphereSphereKernel(PairBucket& bucket);
+			static void AABBAABBKernel(PairBucket& bucket);
+			static void AABBSphereKernel(PairBucket& bucket);
+
+			PairBucket buckets[MaxBuckets];
+			SATAxisCache* axisCache = nullptr;
+		};
+	}
+}
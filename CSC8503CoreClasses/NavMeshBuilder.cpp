@@ -0,0 +1,1353 @@
+#include "NavMeshBuilder.h"
+#include "Assets.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using namespace NCL;
+using namespace CSC8503;
+
+/*
+Tiles are built in cell units - x and z in cells, y in steps of the cell
+height - with each tile's heightfield starting a border's width before its
+own first cell. The direction order is -x, +z, +x, -z, so turning clockwise
+(seen from above) is going to the next one.
+*/
+namespace {
+	const int DirX[4] = { -1, 0, 1,  0 };
+	const int DirZ[4] = {  0, 1, 0, -1 };
+
+	const int NoConnection	= -1;
+	const int OpenSky		= 1 << 29;	//the ceiling of a span with nothing above it
+	const int BorderRegion	= 1 << 30;	//flags spans in the border, which belong to the neighbouring tiles
+	const int MaxPolyVerts	= 12;
+
+	struct Cells {
+		float	cellSize;
+		float	cellHeight;
+		int		walkableHeight;
+		int		walkableClimb;
+		int		walkableRadius;
+		float	walkableSlope;	//the least a unit normal's y can be
+		int		border;
+		int		tileSize;
+		int		width;			//of the whole heightfield, border included
+		int		minRegionArea;
+	};
+
+	Cells ToCells(const NavMeshBuildSettings& s) {
+		Cells c;
+		c.cellSize			= s.cellSize;
+		c.cellHeight		= s.cellHeight;
+		c.walkableHeight	= (int)std::ceil(s.agentHeight / s.cellHeight);
+		c.walkableClimb		= (int)std::floor(s.agentMaxClimb / s.cellHeight);
+		c.walkableRadius	= (int)std::ceil(s.agentRadius / s.cellSize);
+		c.walkableSlope		= std::cos(s.agentMaxSlope * 3.14159265f / 180.0f);
+		c.border			= c.walkableRadius + 3;
+		c.tileSize			= s.tileSize;
+		c.width				= s.tileSize + (c.border * 2);
+		c.minRegionArea		= s.minRegionArea;
+		return c;
+	}
+
+	struct SolidSpan {
+		int		bottom;
+		int		top;
+		bool	walkable;
+		int		next;	//the next span up the column
+	};
+
+	//Where a column goes into something solid (change 1), or back out of it (change -1), going up
+	struct Crossing {
+		int column;
+		int y;
+		int change;
+	};
+
+	//Spans come from one pool, with each column a list of them from the bottom up, as there's nothing in most columns
+	struct Heightfield {
+		std::vector<int>		columns;	//each column's first span
+		std::vector<SolidSpan>	spans;
+		int						freeSpans;	//merged spans, for reuse
+		std::vector<Crossing>	crossings;
+	};
+
+	struct OpenSpan {
+		int		floor;
+		int		ceiling;
+		int		con[4];	//the connected span in each direction, if any
+		int		region;
+		bool	walkable;
+	};
+
+	//The open space above each walkable solid span, with each cell's spans next to each other
+	struct OpenField {
+		int						width;
+		std::vector<int>		cellStarts;
+		std::vector<OpenSpan>	spans;
+	};
+
+	struct ContourVert {
+		int x;
+		int y;
+		int z;
+		int r;		//the region on the other side of the edge this vertex starts
+		int raw;	//index into the raw contour, once simplified
+	};
+
+	/*
+	Rasterising
+	*/
+	//Splits a convex polygon along a line of constant x (axis 0) or z (axis 2), into the parts below and above it
+	void DividePoly(const Vector3* in, int n, Vector3* below, int& nBelow, Vector3* above, int& nAbove, float at, int axis) {
+		float d[MaxPolyVerts];
+		for (int i = 0; i < n; ++i) {
+			d[i] = at - in[i][axis];
+		}
+		nBelow = 0;
+		nAbove = 0;
+		for (int i = 0, j = n - 1; i < n; j = i, ++i) {
+			bool inA = d[j] >= 0.0f;
+			bool inB = d[i] >= 0.0f;
+			if (inA != inB) {
+				float s = d[j] / (d[j] - d[i]);
+				Vector3 p = in[j] + ((in[i] - in[j]) * s);
+				below[nBelow++] = p;
+				above[nAbove++] = p;
+				if (d[i] > 0.0f) {
+					below[nBelow++] = in[i];
+				}
+				else if (d[i] < 0.0f) {
+					above[nAbove++] = in[i];
+				}
+				continue;
+			}
+			if (d[i] >= 0.0f) {
+				below[nBelow++] = in[i];
+				if (d[i] != 0.0f) {
+					continue;
+				}
+			}
+			above[nAbove++] = in[i];
+		}
+	}
+
+	//Spans that touch or overlap are merged - the new top decides if it's walkable, unless the two tops are within a step
+	void AddSpan(Heightfield& heightfield, int column, SolidSpan s, int climb) {
+		std::vector<SolidSpan>& spans = heightfield.spans;
+		int previous	= -1;
+		int i			= heightfield.columns[column];
+		while (i >= 0) {
+			SolidSpan& other = spans[i];
+			if (other.bottom > s.top) {
+				break;
+			}
+			int next = other.next;
+			if (other.top < s.bottom) {
+				previous	= i;
+				i			= next;
+				continue;
+			}
+			if (other.top > s.top + climb) {
+				s.walkable = other.walkable;
+			}
+			else if (other.top >= s.top - climb) {
+				s.walkable = s.walkable || other.walkable;
+			}
+			s.bottom	= std::min(s.bottom, other.bottom);
+			s.top		= std::max(s.top, other.top);
+
+			other.next				= heightfield.freeSpans;
+			heightfield.freeSpans	= i;
+			i						= next;
+		}
+		s.next = i;
+		int added = heightfield.freeSpans;
+		if (added >= 0) {
+			heightfield.freeSpans = spans[added].next;
+			spans[added] = s;
+		}
+		else {
+			added = (int)spans.size();
+			spans.push_back(s);
+		}
+		if (previous >= 0) {
+			spans[previous].next = added;
+		}
+		else {
+			heightfield.columns[column] = added;
+		}
+	}
+
+	//Facing is 1 for triangles facing up, -1 for those facing down, and 0 for walls
+	void RasterizeTri(const Vector3& a, const Vector3& b, const Vector3& c, bool walkable, int facing, const Vector3& origin, const Cells& cells, Heightfield& heightfield) {
+		float cs		= cells.cellSize;
+		float fieldSize	= cells.width * cs;
+
+		Vector3 triMin = a;
+		Vector3 triMax = a;
+		for (const Vector3& p : { b, c }) {
+			for (int i = 0; i < 3; ++i) {
+				triMin[i] = std::min(triMin[i], p[i]);
+				triMax[i] = std::max(triMax[i], p[i]);
+			}
+		}
+		if (triMax.x < origin.x || triMin.x > origin.x + fieldSize || triMax.z < origin.z || triMin.z > origin.z + fieldSize) {
+			return;
+		}
+		int z0 = std::clamp((int)std::floor((triMin.z - origin.z) / cs), 0, cells.width - 1);
+		int z1 = std::clamp((int)std::floor((triMax.z - origin.z) / cs), 0, cells.width - 1);
+
+		Vector3 buffers[4][MaxPolyVerts];
+		Vector3* in		= buffers[0];
+		Vector3* row	= buffers[1];
+		Vector3* cell	= buffers[2];
+		Vector3* rest	= buffers[3];
+		int nIn = 3;
+		in[0] = a;
+		in[1] = b;
+		in[2] = c;
+
+		int nRow;
+		int nRest;
+		DividePoly(in, nIn, row, nRow, rest, nRest, origin.z + (z0 * cs), 2); //drop anything before the first row
+		std::swap(in, rest);
+		nIn = nRest;
+
+		for (int z = z0; z <= z1 && nIn >= 3; ++z) {
+			DividePoly(in, nIn, row, nRow, rest, nRest, origin.z + ((z + 1) * cs), 2);
+			std::swap(in, rest);
+			nIn = nRest;
+			if (nRow < 3) {
+				continue;
+			}
+			float minX = row[0].x;
+			float maxX = row[0].x;
+			for (int i = 1; i < nRow; ++i) {
+				minX = std::min(minX, row[i].x);
+				maxX = std::max(maxX, row[i].x);
+			}
+			int x0 = (int)std::floor((minX - origin.x) / cs);
+			int x1 = (int)std::floor((maxX - origin.x) / cs);
+			if (x1 < 0 || x0 >= cells.width) {
+				continue;
+			}
+			x0 = std::max(x0, 0);
+			x1 = std::min(x1, cells.width - 1);
+
+			int nCell;
+			DividePoly(row, nRow, cell, nCell, rest, nRest, origin.x + (x0 * cs), 0);
+			std::swap(row, rest);
+			nRow = nRest;
+
+			for (int x = x0; x <= x1 && nRow >= 3; ++x) {
+				DividePoly(row, nRow, cell, nCell, rest, nRest, origin.x + ((x + 1) * cs), 0);
+				std::swap(row, rest);
+				nRow = nRest;
+				if (nCell < 3) {
+					continue;
+				}
+				float minY = cell[0].y;
+				float maxY = cell[0].y;
+				for (int i = 1; i < nCell; ++i) {
+					minY = std::min(minY, cell[i].y);
+					maxY = std::max(maxY, cell[i].y);
+				}
+				SolidSpan s;
+				s.next		= -1;
+				s.bottom	= (int)std::floor(minY / cells.cellHeight);
+				s.top		= (int)std::ceil(maxY / cells.cellHeight);
+				s.walkable	= walkable;
+				if (s.top == s.bottom) {
+					s.bottom--; //flat, and exactly on a step - keep the top where the surface is
+				}
+				int column = (z * cells.width) + x;
+				AddSpan(heightfield, column, s, cells.walkableClimb);
+				if (facing < 0) {
+					heightfield.crossings.push_back({ column, s.bottom, 1 });
+				}
+				else if (facing > 0) {
+					heightfield.crossings.push_back({ column, s.top, -1 });
+				}
+			}
+		}
+	}
+
+	/*
+	Only surfaces are rasterised, which leaves the inside of anything solid
+	looking like open space - so the floor under a box would still be
+	walkable. Going up each column, everything from where it goes in
+	through a downward facing surface to where it comes out of an upward
+	facing one is filled in. A lone surface, like a plane for the ground,
+	fills nothing.
+	*/
+	void FillSolids(Heightfield& heightfield, const Cells& cells) {
+		//gathered by column first, as there are only ever a few in each
+		int columnCount = (int)heightfield.columns.size();
+		std::vector<int> starts(columnCount + 1, 0);
+		for (const Crossing& c : heightfield.crossings) {
+			starts[c.column + 1]++;
+		}
+		for (int i = 0; i < columnCount; ++i) {
+			starts[i + 1] += starts[i];
+		}
+		std::vector<Crossing> byColumn(heightfield.crossings.size());
+		std::vector<int> counts(starts.begin(), starts.end() - 1);
+		for (const Crossing& c : heightfield.crossings) {
+			byColumn[counts[c.column]++] = c;
+		}
+
+		for (int i = 0; i < columnCount; ++i) {
+			auto first	= byColumn.begin() + starts[i];
+			auto last	= byColumn.begin() + starts[i + 1];
+			std::sort(first, last, [](const Crossing& a, const Crossing& b) {
+				return a.y < b.y || (a.y == b.y && a.change > b.change);
+			});
+			int depth = 0;
+			int start = 0;
+			for (auto c = first; c != last; ++c) {
+				if (c->change > 0) {
+					if (depth == 0) {
+						start = c->y;
+					}
+					depth++;
+				}
+				else if (depth > 0 && --depth == 0) {
+					AddSpan(heightfield, i, { start, c->y, false, -1 }, cells.walkableClimb); //the top surface decides if it's walkable
+				}
+			}
+		}
+	}
+
+	/*
+	Open spans
+	*/
+	void BuildOpenField(const Heightfield& heightfield, const Cells& cells, OpenField& field) {
+		int w = cells.width;
+		field.width = w;
+		field.cellStarts.assign((w * w) + 1, 0);
+		field.spans.clear();
+
+		for (int i = 0; i < w * w; ++i) {
+			field.cellStarts[i] = (int)field.spans.size();
+			for (int j = heightfield.columns[i]; j >= 0; j = heightfield.spans[j].next) {
+				const SolidSpan& solid = heightfield.spans[j];
+				int ceiling = (solid.next >= 0) ? heightfield.spans[solid.next].bottom : OpenSky;
+				if (!solid.walkable || ceiling - solid.top < cells.walkableHeight) {
+					continue; //too steep, or not enough headroom
+				}
+				OpenSpan s;
+				s.floor		= solid.top;
+				s.ceiling	= ceiling;
+				s.region	= 0;
+				s.walkable	= true;
+				for (int d = 0; d < 4; ++d) {
+					s.con[d] = NoConnection;
+				}
+				field.spans.push_back(s);
+			}
+		}
+		field.cellStarts[w * w] = (int)field.spans.size();
+
+		for (int z = 0; z < w; ++z) {
+			for (int x = 0; x < w; ++x) {
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					OpenSpan& s = field.spans[i];
+					for (int d = 0; d < 4; ++d) {
+						int nx = x + DirX[d];
+						int nz = z + DirZ[d];
+						if (nx < 0 || nz < 0 || nx >= w || nz >= w) {
+							continue;
+						}
+						int neighbourCell = (nz * w) + nx;
+						for (int j = field.cellStarts[neighbourCell]; j < field.cellStarts[neighbourCell + 1]; ++j) {
+							const OpenSpan& n = field.spans[j];
+							int gap = std::min(s.ceiling, n.ceiling) - std::max(s.floor, n.floor);
+							if (gap >= cells.walkableHeight && std::abs(n.floor - s.floor) <= cells.walkableClimb) {
+								s.con[d] = j;
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	Removes the floor within the agent's radius of anything it can't walk
+	onto. Distances are worked out in two sweeps, in units of half a cell,
+	with diagonals a little longer, so the edges come out roughly round.
+	*/
+	void Erode(OpenField& field, const Cells& cells) {
+		int w = field.width;
+		std::vector<OpenSpan>& spans = field.spans;
+		std::vector<int> dist(spans.size(), INT_MAX);
+
+		for (size_t i = 0; i < spans.size(); ++i) {
+			for (int d = 0; d < 4; ++d) {
+				if (spans[i].con[d] == NoConnection) {
+					dist[i] = 0;
+					break;
+				}
+			}
+		}
+		auto relax = [&](int i, int dir, int diagonalDir) {
+			int a = spans[i].con[dir];
+			if (a == NoConnection) {
+				return;
+			}
+			dist[i] = std::min(dist[i], dist[a] + 2);
+			int b = spans[a].con[diagonalDir];
+			if (b != NoConnection) {
+				dist[i] = std::min(dist[i], dist[b] + 3);
+			}
+		};
+		for (int z = 0; z < w; ++z) {
+			for (int x = 0; x < w; ++x) {
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					relax(i, 0, 3);
+					relax(i, 3, 2);
+				}
+			}
+		}
+		for (int z = w - 1; z >= 0; --z) {
+			for (int x = w - 1; x >= 0; --x) {
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					relax(i, 2, 1);
+					relax(i, 1, 0);
+				}
+			}
+		}
+		int threshold = cells.walkableRadius * 2;
+		for (size_t i = 0; i < spans.size(); ++i) {
+			if (dist[i] < threshold) {
+				spans[i].walkable = false;
+			}
+		}
+		for (OpenSpan& s : spans) {
+			for (int d = 0; d < 4; ++d) {
+				if (!s.walkable || (s.con[d] != NoConnection && !spans[s.con[d]].walkable)) {
+					s.con[d] = NoConnection;
+				}
+			}
+		}
+	}
+
+	/*
+	Regions
+	*/
+	bool IsOwnRegion(int region) {
+		return region > 0 && !(region & BorderRegion);
+	}
+
+	int RegionOf(const OpenField& field, int span, int dir) {
+		int n = field.spans[span].con[dir];
+		return n == NoConnection ? 0 : field.spans[n].region;
+	}
+
+	/*
+	Splits the floor into monotone regions - sweeping along each row, a run
+	of connected spans joins the region behind it if that region continues
+	into this row through this run alone, and starts a new one otherwise.
+	Every region then has one run per row, so none of them have holes, and
+	each can be outlined with a single contour. Each side of the border is
+	a region of its own, so contours keep the corners of the tile.
+	*/
+	void BuildRegions(OpenField& field, const Cells& cells) {
+		int w = field.width;
+		std::vector<OpenSpan>& spans = field.spans;
+
+		for (int z = 0; z < w; ++z) {
+			for (int x = 0; x < w; ++x) {
+				int side = 0;
+				if (x < cells.border) {
+					side = 1;
+				}
+				else if (x >= cells.border + cells.tileSize) {
+					side = 2;
+				}
+				else if (z < cells.border) {
+					side = 3;
+				}
+				else if (z >= cells.border + cells.tileSize) {
+					side = 4;
+				}
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					spans[i].region = (spans[i].walkable && side > 0) ? (BorderRegion | side) : 0;
+				}
+			}
+		}
+		struct Sweep {
+			int neighbour;	//the region in the row behind, or -1 if it touches more than one
+			int spanCount;	//how many of its spans touch that region
+			int id;
+		};
+		std::vector<Sweep>	sweeps;
+		std::vector<int>	touching; //per region, how many spans in this row touch it
+		std::vector<int>	rowIDs(spans.size(), 0);
+		int nextID = 1;
+
+		for (int z = cells.border; z < cells.border + cells.tileSize; ++z) {
+			sweeps.assign(1, Sweep());
+			touching.assign(nextID, 0);
+
+			for (int x = cells.border; x < cells.border + cells.tileSize; ++x) {
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					if (!spans[i].walkable) {
+						continue;
+					}
+					int sweep = 0;
+					int left = spans[i].con[0];
+					if (left != NoConnection && !(spans[left].region & BorderRegion)) {
+						sweep = rowIDs[left];
+					}
+					if (sweep == 0) {
+						sweep = (int)sweeps.size();
+						sweeps.push_back({ 0, 0, 0 });
+					}
+					int behind = spans[i].con[3];
+					if (behind != NoConnection && IsOwnRegion(spans[behind].region)) {
+						int r = spans[behind].region;
+						Sweep& s = sweeps[sweep];
+						if (s.neighbour == 0 || s.neighbour == r) {
+							s.neighbour = r;
+							s.spanCount++;
+							touching[r]++;
+						}
+						else {
+							s.neighbour = -1;
+						}
+					}
+					rowIDs[i] = sweep;
+				}
+			}
+			for (size_t i = 1; i < sweeps.size(); ++i) {
+				Sweep& s = sweeps[i];
+				if (s.neighbour > 0 && touching[s.neighbour] == s.spanCount) {
+					s.id = s.neighbour;
+				}
+				else {
+					s.id = nextID++;
+				}
+			}
+			for (int x = cells.border; x < cells.border + cells.tileSize; ++x) {
+				int cell = (z * w) + x;
+				for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+					if (spans[i].walkable) {
+						spans[i].region = sweeps[rowIDs[i]].id;
+					}
+				}
+			}
+		}
+
+		/*
+		Drops patches of floor too small to be worth walking on - groups of
+		connected regions that add up to fewer cells than the minimum. Those
+		reaching the border are kept, as they carry on into the next tile.
+		*/
+		std::vector<int>				cellCounts(nextID, 0);
+		std::vector<bool>				reachesBorder(nextID, false);
+		std::vector<std::vector<int>>	links(nextID);
+		for (size_t i = 0; i < spans.size(); ++i) {
+			int r = spans[i].region;
+			if (!IsOwnRegion(r)) {
+				continue;
+			}
+			cellCounts[r]++;
+			for (int d = 0; d < 4; ++d) {
+				int nr = RegionOf(field, (int)i, d);
+				if (nr & BorderRegion) {
+					reachesBorder[r] = true;
+				}
+				else if (nr > 0 && nr != r && std::find(links[r].begin(), links[r].end(), nr) == links[r].end()) {
+					links[r].push_back(nr);
+				}
+			}
+		}
+		std::vector<bool>	visited(nextID, false);
+		std::vector<bool>	removed(nextID, false);
+		std::vector<int>	group;
+		for (int r = 1; r < nextID; ++r) {
+			if (visited[r] || cellCounts[r] == 0) {
+				continue;
+			}
+			group.assign(1, r);
+			visited[r] = true;
+			int		total	= 0;
+			bool	keep	= false;
+			for (size_t i = 0; i < group.size(); ++i) {
+				total	+= cellCounts[group[i]];
+				keep	= keep || reachesBorder[group[i]];
+				for (int n : links[group[i]]) {
+					if (!visited[n]) {
+						visited[n] = true;
+						group.push_back(n);
+					}
+				}
+			}
+			for (int g : group) {
+				removed[g] = !keep && total < cells.minRegionArea;
+			}
+		}
+		for (OpenSpan& s : spans) {
+			if (IsOwnRegion(s.region) && removed[s.region]) {
+				s.region = 0;
+			}
+		}
+	}
+
+	/*
+	Contours
+	*/
+	//The height of a corner is the highest floor around it, so every contour meeting there agrees on it
+	int CornerHeight(const OpenField& field, int span, int dir) {
+		const std::vector<OpenSpan>& spans = field.spans;
+		int nextDir	= (dir + 1) & 3;
+		int height	= spans[span].floor;
+
+		for (int first : { dir, nextDir }) {
+			int second = (first == dir) ? nextDir : dir;
+			int a = spans[span].con[first];
+			if (a == NoConnection) {
+				continue;
+			}
+			height = std::max(height, spans[a].floor);
+			int b = spans[a].con[second];
+			if (b != NoConnection) {
+				height = std::max(height, spans[b].floor);
+			}
+		}
+		return height;
+	}
+
+	/*
+	Follows the edge of a region round, keeping it on the left - at an edge
+	of the region, the corner ahead becomes a vertex and it turns right,
+	otherwise it steps into the next cell and turns left.
+	*/
+	void WalkContour(const OpenField& field, int x, int z, int span, std::vector<unsigned char>& edges, std::vector<ContourVert>& out) {
+		const std::vector<OpenSpan>& spans = field.spans;
+
+		int dir = 0;
+		while (!(edges[span] & (1 << dir))) {
+			dir++;
+		}
+		int startSpan	= span;
+		int startDir	= dir;
+
+		for (int iterations = 0; iterations < 100000; ++iterations) {
+			if (edges[span] & (1 << dir)) {
+				ContourVert v;
+				v.x		= x + ((dir == 1 || dir == 2) ? 1 : 0);
+				v.y		= CornerHeight(field, span, dir);
+				v.z		= z + ((dir == 0 || dir == 1) ? 1 : 0);
+				v.r		= RegionOf(field, span, dir);
+				v.raw	= (int)out.size();
+				out.push_back(v);
+
+				edges[span] &= ~(1 << dir);
+				dir = (dir + 1) & 3;
+			}
+			else {
+				span = spans[span].con[dir];
+				x += DirX[dir];
+				z += DirZ[dir];
+				dir = (dir + 3) & 3;
+			}
+			if (span == startSpan && dir == startDir) {
+				break;
+			}
+		}
+	}
+
+	float DistanceToSegmentSquared(int x, int z, int ax, int az, int bx, int bz) {
+		float segX	= (float)(bx - ax);
+		float segZ	= (float)(bz - az);
+		float dx	= (float)(x - ax);
+		float dz	= (float)(z - az);
+		float lengthSquared = (segX * segX) + (segZ * segZ);
+		float t = (segX * dx) + (segZ * dz);
+		if (lengthSquared > 0.0f) {
+			t /= lengthSquared;
+		}
+		t = std::clamp(t, 0.0f, 1.0f);
+		dx = ax + (t * segX) - x;
+		dz = az + (t * segZ) - z;
+		return (dx * dx) + (dz * dz);
+	}
+
+	/*
+	Keeps the vertices where the region on the other side changes, which
+	neighbouring regions' contours keep too, so they share their edges.
+	Walls are then simplified by adding back whichever vertex strays the
+	furthest from the simplified line, until none stray too far. Each
+	segment is always walked in the same direction, whichever contour it's
+	part of, so the same vertices come out.
+	*/
+	void SimplifyContour(const std::vector<ContourVert>& raw, float maxError, std::vector<ContourVert>& out) {
+		out.clear();
+		int rawCount = (int)raw.size();
+
+		for (int i = 0; i < rawCount; ++i) {
+			if (raw[i].r != raw[(i + 1) % rawCount].r) {
+				out.push_back(raw[i]);
+			}
+		}
+		if (out.empty()) { //an island, so start from its lower left and upper right corners
+			int lowerLeft	= 0;
+			int upperRight	= 0;
+			for (int i = 1; i < rawCount; ++i) {
+				const ContourVert& v = raw[i];
+				if (v.x < raw[lowerLeft].x || (v.x == raw[lowerLeft].x && v.z < raw[lowerLeft].z)) {
+					lowerLeft = i;
+				}
+				if (v.x > raw[upperRight].x || (v.x == raw[upperRight].x && v.z > raw[upperRight].z)) {
+					upperRight = i;
+				}
+			}
+			out.push_back(raw[lowerLeft]);
+			out.push_back(raw[upperRight]);
+		}
+
+		float maxErrorSquared = maxError * maxError;
+		for (size_t i = 0; i < out.size(); ) {
+			const ContourVert& a = out[i];
+			const ContourVert& b = out[(i + 1) % out.size()];
+
+			int ax = a.x;
+			int az = a.z;
+			int bx = b.x;
+			int bz = b.z;
+			int step;
+			int current;
+			int end;
+			if (bx > ax || (bx == ax && bz > az)) {
+				step	= 1;
+				current	= (a.raw + step) % rawCount;
+				end		= b.raw;
+			}
+			else {
+				step	= rawCount - 1;
+				current	= (b.raw + step) % rawCount;
+				end		= a.raw;
+				std::swap(ax, bx);
+				std::swap(az, bz);
+			}
+			float	furthest	= 0.0f;
+			int		furthestRaw	= -1;
+			if (raw[current].r == 0) { //only walls - the edges shared with other regions stay as they are
+				for (; current != end; current = (current + step) % rawCount) {
+					float d = DistanceToSegmentSquared(raw[current].x, raw[current].z, ax, az, bx, bz);
+					if (d > furthest) {
+						furthest	= d;
+						furthestRaw	= current;
+					}
+				}
+			}
+			if (furthestRaw >= 0 && furthest > maxErrorSquared) {
+				out.insert(out.begin() + i + 1, raw[furthestRaw]);
+			}
+			else {
+				++i;
+			}
+		}
+
+		for (size_t i = 0; i < out.size() && out.size() > 3; ) { //drop any zero length edges
+			const ContourVert& a = out[i];
+			const ContourVert& b = out[(i + 1) % out.size()];
+			if (a.x == b.x && a.z == b.z) {
+				out.erase(out.begin() + ((i + 1) % out.size()));
+			}
+			else {
+				++i;
+			}
+		}
+	}
+
+	//Twice the signed area, on the XZ plane - outlines come out positive, and holes negative
+	int ContourArea2(const std::vector<ContourVert>& verts) {
+		int area = 0;
+		for (size_t i = 0, j = verts.size() - 1; i < verts.size(); j = i++) {
+			area += (verts[i].x * verts[j].z) - (verts[j].x * verts[i].z);
+		}
+		return area;
+	}
+
+	/*
+	Triangulating - ear clipping, always cutting off the ear with the
+	shortest new edge, so the triangles stay reasonably even. All the tests
+	are in whole cells, so they're exact.
+	*/
+	const uint32_t EarFlag		= 0x80000000;
+	const uint32_t IndexMask	= 0x0fffffff;
+
+	int Prev(int i, int n) {
+		return i - 1 >= 0 ? i - 1 : n - 1;
+	}
+
+	int Next(int i, int n) {
+		return i + 1 < n ? i + 1 : 0;
+	}
+
+	int Area2(const ContourVert& a, const ContourVert& b, const ContourVert& c) {
+		return ((b.x - a.x) * (c.z - a.z)) - ((c.x - a.x) * (b.z - a.z));
+	}
+
+	bool Left(const ContourVert& a, const ContourVert& b, const ContourVert& c) {
+		return Area2(a, b, c) < 0;
+	}
+
+	bool LeftOn(const ContourVert& a, const ContourVert& b, const ContourVert& c) {
+		return Area2(a, b, c) <= 0;
+	}
+
+	bool Collinear(const ContourVert& a, const ContourVert& b, const ContourVert& c) {
+		return Area2(a, b, c) == 0;
+	}
+
+	bool SameXZ(const ContourVert& a, const ContourVert& b) {
+		return a.x == b.x && a.z == b.z;
+	}
+
+	//Whether ab and cd cross properly, rather than just touching
+	bool IntersectProper(const ContourVert& a, const ContourVert& b, const ContourVert& c, const ContourVert& d) {
+		if (Collinear(a, b, c) || Collinear(a, b, d) || Collinear(c, d, a) || Collinear(c, d, b)) {
+			return false;
+		}
+		return (Left(a, b, c) != Left(a, b, d)) && (Left(c, d, a) != Left(c, d, b));
+	}
+
+	//Whether c is on the segment ab
+	bool Between(const ContourVert& a, const ContourVert& b, const ContourVert& c) {
+		if (!Collinear(a, b, c)) {
+			return false;
+		}
+		if (a.x != b.x) {
+			return (a.x <= c.x && c.x <= b.x) || (a.x >= c.x && c.x >= b.x);
+		}
+		return (a.z <= c.z && c.z <= b.z) || (a.z >= c.z && c.z >= b.z);
+	}
+
+	bool Intersect(const ContourVert& a, const ContourVert& b, const ContourVert& c, const ContourVert& d) {
+		return IntersectProper(a, b, c, d) || Between(a, b, c) || Between(a, b, d) || Between(c, d, a) || Between(c, d, b);
+	}
+
+	struct Polygon {
+		const std::vector<ContourVert>&	verts;
+		std::vector<uint32_t>&			indices;
+		int								count;
+
+		const ContourVert& operator[](int i) const {
+			return verts[indices[i] & IndexMask];
+		}
+	};
+
+	//Whether the diagonal from i to j crosses none of the polygon's edges
+	bool DiagonalClear(const Polygon& p, int i, int j, bool loose) {
+		const ContourVert& d0 = p[i];
+		const ContourVert& d1 = p[j];
+		for (int k = 0; k < p.count; ++k) {
+			int k1 = Next(k, p.count);
+			if (k == i || k1 == i || k == j || k1 == j) {
+				continue;
+			}
+			const ContourVert& p0 = p[k];
+			const ContourVert& p1 = p[k1];
+			if (SameXZ(d0, p0) || SameXZ(d1, p0) || SameXZ(d0, p1) || SameXZ(d1, p1)) {
+				continue;
+			}
+			if (loose ? IntersectProper(d0, d1, p0, p1) : Intersect(d0, d1, p0, p1)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//Whether the diagonal from i to j starts off inside the polygon
+	bool InCone(const Polygon& p, int i, int j, bool loose) {
+		const ContourVert& pi		= p[i];
+		const ContourVert& pj		= p[j];
+		const ContourVert& pNext	= p[Next(i, p.count)];
+		const ContourVert& pPrev	= p[Prev(i, p.count)];
+
+		if (LeftOn(pPrev, pi, pNext)) { //convex corner
+			if (loose) {
+				return LeftOn(pi, pj, pPrev) && LeftOn(pj, pi, pNext);
+			}
+			return Left(pi, pj, pPrev) && Left(pj, pi, pNext);
+		}
+		return !(LeftOn(pi, pj, pNext) && LeftOn(pj, pi, pPrev));
+	}
+
+	bool Diagonal(const Polygon& p, int i, int j, bool loose = false) {
+		return InCone(p, i, j, loose) && DiagonalClear(p, i, j, loose);
+	}
+
+	//Adds the triangles to outTris as indices into verts. Anything that can't be cut up cleanly is left out
+	void Triangulate(const std::vector<ContourVert>& verts, std::vector<int>& outTris) {
+		std::vector<uint32_t> indices(verts.size());
+		for (size_t i = 0; i < verts.size(); ++i) {
+			indices[i] = (uint32_t)i;
+		}
+		Polygon p = { verts, indices, (int)verts.size() };
+
+		//vertices that can be cut off as an ear are flagged
+		for (int i = 0; i < p.count; ++i) {
+			int i1 = Next(i, p.count);
+			if (Diagonal(p, i, Next(i1, p.count))) {
+				indices[i1] |= EarFlag;
+			}
+		}
+		while (p.count > 3) {
+			int shortest	= -1;
+			int best		= -1;
+			for (int i = 0; i < p.count; ++i) {
+				int i1 = Next(i, p.count);
+				if (indices[i1] & EarFlag) {
+					const ContourVert& a = p[i];
+					const ContourVert& c = p[Next(i1, p.count)];
+					int length = ((c.x - a.x) * (c.x - a.x)) + ((c.z - a.z) * (c.z - a.z));
+					if (best < 0 || length < shortest) {
+						shortest	= length;
+						best		= i;
+					}
+				}
+			}
+			if (best < 0) { //no clean ears, which happens if simplifying made the outline touch itself
+				for (int i = 0; i < p.count; ++i) {
+					int i2 = Next(Next(i, p.count), p.count);
+					if (Diagonal(p, i, i2, true)) {
+						const ContourVert& a = p[i];
+						const ContourVert& c = p[i2];
+						int length = ((c.x - a.x) * (c.x - a.x)) + ((c.z - a.z) * (c.z - a.z));
+						if (best < 0 || length < shortest) {
+							shortest	= length;
+							best		= i;
+						}
+					}
+				}
+				if (best < 0) {
+					return;
+				}
+			}
+			int i	= best;
+			int i1	= Next(i, p.count);
+			int i2	= Next(i1, p.count);
+			outTris.push_back(indices[i] & IndexMask);
+			outTris.push_back(indices[i1] & IndexMask);
+			outTris.push_back(indices[i2] & IndexMask);
+
+			p.count--;
+			indices.erase(indices.begin() + i1);
+			if (i1 >= p.count) {
+				i1 = 0;
+			}
+			i = Prev(i1, p.count);
+			if (Diagonal(p, Prev(i, p.count), i1)) {
+				indices[i] |= EarFlag;
+			}
+			else {
+				indices[i] &= IndexMask;
+			}
+			if (Diagonal(p, i, Next(i1, p.count))) {
+				indices[i1] |= EarFlag;
+			}
+			else {
+				indices[i1] &= IndexMask;
+			}
+		}
+		outTris.push_back(indices[0] & IndexMask);
+		outTris.push_back(indices[1] & IndexMask);
+		outTris.push_back(indices[2] & IndexMask);
+	}
+}
+
+NavMeshBuilder::NavMeshBuilder(const NavMeshBuildSettings& settings) : settings(settings) {
+	nextVersion		= 0;
+	runningTiles	= 0;
+}
+
+NavMeshBuilder::~NavMeshBuilder() {
+	JobSystem::Get().Wait(tileJobs); //the jobs write into this
+}
+
+int64_t NavMeshBuilder::TileKey(int x, int z) {
+	return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)z);
+}
+
+void NavMeshBuilder::SetGeometry(const NavMeshGeometry& newGeometry) {
+	geometry = std::make_shared<const NavMeshGeometry>(newGeometry);
+}
+
+bool NavMeshBuilder::GetTileRange(const Vector3& boundsMin, const Vector3& boundsMax, int& minX, int& minZ, int& maxX, int& maxZ) const {
+	float tileWorldSize = settings.tileSize * settings.cellSize;
+	if (tileWorldSize <= 0.0f || boundsMax.x < boundsMin.x || boundsMax.z < boundsMin.z) {
+		return false;
+	}
+	minX = (int)std::floor(boundsMin.x / tileWorldSize);
+	minZ = (int)std::floor(boundsMin.z / tileWorldSize);
+	maxX = (int)std::floor(boundsMax.x / tileWorldSize);
+	maxZ = (int)std::floor(boundsMax.z / tileWorldSize);
+	return true;
+}
+
+void NavMeshBuilder::BuildAllTiles() {
+	//anything still building in the background would be out of date, so it's thrown away
+	JobSystem::Get().Wait(tileJobs);
+	{
+		std::lock_guard<std::mutex> lock(finishedLock);
+		finished.clear();
+	}
+	runningTiles = 0;
+	tiles.clear();
+
+	Vector3 boundsMin;
+	Vector3 boundsMax;
+	int minX, minZ, maxX, maxZ;
+	if (!geometry || !geometry->GetBounds(boundsMin, boundsMax) || !GetTileRange(boundsMin, boundsMax, minX, minZ, maxX, maxZ)) {
+		return;
+	}
+	int tilesX = (maxX - minX) + 1;
+	int tileCount = tilesX * ((maxZ - minZ) + 1);
+
+	std::vector<TileMesh> built(tileCount);
+	JobSystem::Get().ParallelFor(tileCount, 1, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			BuildTile(*geometry, settings, minX + (i % tilesX), minZ + (i / tilesX), built[i]);
+		}
+	});
+	for (int i = 0; i < tileCount; ++i) {
+		Tile& t = tiles[TileKey(minX + (i % tilesX), minZ + (i / tilesX))];
+		t.mesh			= std::move(built[i]);
+		t.builtVersion	= ++nextVersion;
+		t.wantedVersion	= t.builtVersion;
+	}
+}
+
+void NavMeshBuilder::RebuildTiles(const Vector3& boundsMin, const Vector3& boundsMax) {
+	//tiles also see a border of their neighbours' cells, so changes there affect them too
+	float border = ToCells(settings).border * settings.cellSize;
+	Vector3 grow(border, 0.0f, border);
+
+	int minX, minZ, maxX, maxZ;
+	if (!geometry || !GetTileRange(boundsMin - grow, boundsMax + grow, minX, minZ, maxX, maxZ)) {
+		return;
+	}
+	for (int z = minZ; z <= maxZ; ++z) {
+		for (int x = minX; x <= maxX; ++x) {
+			int64_t key = TileKey(x, z);
+			Tile& t = tiles[key];
+			t.wantedVersion = ++nextVersion;
+			if (!t.building) { //otherwise it starts again once the build it's on now finishes
+				StartTile(key, t);
+			}
+		}
+	}
+}
+
+//Each build has the geometry as it was when it started, which lives on for as long as a build is using it
+void NavMeshBuilder::StartTile(int64_t key, Tile& tile) {
+	tile.building = true;
+	runningTiles++;
+
+	std::shared_ptr<const NavMeshGeometry>	source		= geometry;
+	NavMeshBuildSettings					tileSettings = settings;
+	uint32_t								version		= tile.wantedVersion;
+
+	JobSystem::Get().Run([this, source, tileSettings, key, version]() {
+		FinishedTile result;
+		result.key		= key;
+		result.version	= version;
+		BuildTile(*source, tileSettings, (int)(key >> 32), (int)(int32_t)(key & 0xffffffff), result.mesh);
+
+		std::lock_guard<std::mutex> lock(finishedLock);
+		finished.push_back(std::move(result));
+	}, &tileJobs);
+}
+
+bool NavMeshBuilder::Update() {
+	std::vector<FinishedTile> done;
+	{
+		std::lock_guard<std::mutex> lock(finishedLock);
+		done.swap(finished);
+	}
+	bool changed = false;
+	for (FinishedTile& f : done) {
+		runningTiles--;
+		Tile& t = tiles[f.key];
+		t.building = false;
+		if (f.version > t.builtVersion) {
+			t.mesh			= std::move(f.mesh);
+			t.builtVersion	= f.version;
+			changed			= true;
+		}
+		if (t.wantedVersion > t.builtVersion) {
+			StartTile(f.key, t); //the level changed again while it was building
+		}
+	}
+	return changed;
+}
+
+void NavMeshBuilder::BuildTile(const NavMeshGeometry& geometry, const NavMeshBuildSettings& settings, int tileX, int tileZ, TileMesh& out) {
+	out.verts.clear();
+	out.tris.clear();
+
+	Cells cells = ToCells(settings);
+	int originX = (tileX * cells.tileSize) - cells.border;
+	int originZ = (tileZ * cells.tileSize) - cells.border;
+	Vector3 origin(originX * cells.cellSize, 0.0f, originZ * cells.cellSize);
+
+	Heightfield heightfield;
+	heightfield.columns.assign(cells.width * cells.width, -1);
+	heightfield.freeSpans = -1;
+	const std::vector<Vector3>&	verts	= geometry.GetVertices();
+	const std::vector<int>&		indices	= geometry.GetIndices();
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const Vector3& a = verts[indices[i]];
+		const Vector3& b = verts[indices[i + 1]];
+		const Vector3& c = verts[indices[i + 2]];
+		Vector3 normal	= Vector::Cross(b - a, c - a);
+		float length	= Vector::Length(normal);
+		float up		= length > 0.0f ? normal.y / length : 0.0f;
+		int facing		= up > 0.01f ? 1 : (up < -0.01f ? -1 : 0);
+		RasterizeTri(a, b, c, up >= cells.walkableSlope, facing, origin, cells, heightfield);
+	}
+	FillSolids(heightfield, cells);
+
+	OpenField field;
+	BuildOpenField(heightfield, cells, field);
+	Erode(field, cells);
+	BuildRegions(field, cells);
+
+	//each span's edges that face out of its region
+	std::vector<unsigned char> edges(field.spans.size(), 0);
+	for (size_t i = 0; i < field.spans.size(); ++i) {
+		int r = field.spans[i].region;
+		if (!IsOwnRegion(r)) {
+			continue;
+		}
+		for (int d = 0; d < 4; ++d) {
+			if (RegionOf(field, (int)i, d) != r) {
+				edges[i] |= 1 << d;
+			}
+		}
+	}
+
+	std::vector<ContourVert>	raw;
+	std::vector<ContourVert>	simple;
+	std::vector<int>			tris;
+	for (int z = 0; z < cells.width; ++z) {
+		for (int x = 0; x < cells.width; ++x) {
+			int cell = (z * cells.width) + x;
+			for (int i = field.cellStarts[cell]; i < field.cellStarts[cell + 1]; ++i) {
+				if (edges[i] == 0) {
+					continue;
+				}
+				raw.clear();
+				WalkContour(field, x, z, i, edges, raw);
+				SimplifyContour(raw, settings.maxEdgeError, simple);
+				if (simple.size() < 3 || ContourArea2(simple) <= 0) {
+					continue;
+				}
+				tris.clear();
+				Triangulate(simple, tris);
+
+				int first = (int)out.verts.size() / 3;
+				for (const ContourVert& v : simple) {
+					out.verts.push_back(v.x + originX);
+					out.verts.push_back(v.y);
+					out.verts.push_back(v.z + originZ);
+				}
+				for (int t : tris) {
+					out.tris.push_back(first + t);
+				}
+			}
+		}
+	}
+}
+
+/*
+Joins the tiles into one mesh. Vertices in the same place are welded - a
+little difference in height is allowed, as regions can disagree by a step
+about the height of a corner. Tiles can split their shared edges at
+different places, so triangle edges along tile boundaries are split again
+wherever the other side has a vertex, leaving every edge shared exactly.
+*/
+void NavMeshBuilder::GetMesh(std::vector<Vector3>& outVerts, std::vector<int>& outIndices, std::vector<int>& outNeighbours) const {
+	outVerts.clear();
+	outIndices.clear();
+	outNeighbours.clear();
+
+	Cells cells			= ToCells(settings);
+	int heightTolerance	= std::max(cells.walkableHeight / 2, cells.walkableClimb);
+
+	std::vector<int> verts; //x, y, z
+	std::unordered_map<int64_t, std::vector<int>> columns;
+	auto weld = [&](const int* v) {
+		std::vector<int>& column = columns[TileKey(v[0], v[2])];
+		for (int i : column) {
+			if (std::abs(verts[(i * 3) + 1] - v[1]) <= cells.walkableClimb) {
+				return i;
+			}
+		}
+		int i = (int)verts.size() / 3;
+		verts.insert(verts.end(), v, v + 3);
+		column.push_back(i);
+		return i;
+	};
+	std::vector<int> tris;
+	for (const auto& tile : tiles) {
+		const TileMesh& mesh = tile.second.mesh;
+		for (size_t i = 0; i + 2 < mesh.tris.size(); i += 3) {
+			int a = weld(&mesh.verts[mesh.tris[i] * 3]);
+			int b = weld(&mesh.verts[mesh.tris[i + 1] * 3]);
+			int c = weld(&mesh.verts[mesh.tris[i + 2] * 3]);
+			if (a != b && b != c && a != c) {
+				tris.insert(tris.end(), { a, b, c });
+			}
+		}
+	}
+
+	//the vertices on each tile boundary line, in order along it
+	auto onBoundary = [&](int coord) {
+		return ((coord % cells.tileSize) + cells.tileSize) % cells.tileSize == 0;
+	};
+	std::unordered_map<int, std::vector<int>> boundaries[2]; //lines of constant x, then of constant z
+	for (int i = 0; i < (int)verts.size() / 3; ++i) {
+		for (int axis = 0; axis < 2; ++axis) {
+			int coord = verts[(i * 3) + (axis * 2)];
+			if (onBoundary(coord)) {
+				boundaries[axis][coord].push_back(i);
+			}
+		}
+	}
+	for (int axis = 0; axis < 2; ++axis) {
+		int along = axis == 0 ? 2 : 0;
+		for (auto& line : boundaries[axis]) {
+			std::sort(line.second.begin(), line.second.end(), [&](int a, int b) {
+				return verts[(a * 3) + along] < verts[(b * 3) + along];
+			});
+		}
+	}
+
+	std::vector<int> pending;
+	std::vector<int> splitPoints;
+	while (!tris.empty()) {
+		int tri[3] = { tris[tris.size() - 3], tris[tris.size() - 2], tris[tris.size() - 1] };
+		tris.resize(tris.size() - 3);
+
+		bool split = false;
+		for (int e = 0; e < 3 && !split; ++e) {
+			const int* u = &verts[tri[e] * 3];
+			const int* v = &verts[tri[(e + 1) % 3] * 3];
+			int axis;
+			if (u[0] == v[0] && onBoundary(u[0])) {
+				axis = 0;
+			}
+			else if (u[2] == v[2] && onBoundary(u[2])) {
+				axis = 1;
+			}
+			else {
+				continue;
+			}
+			int along	= axis == 0 ? 2 : 0;
+			int from	= std::min(u[along], v[along]);
+			int to		= std::max(u[along], v[along]);
+
+			splitPoints.clear();
+			for (int p : boundaries[axis][u[axis * 2]]) {
+				const int* pv = &verts[p * 3];
+				if (pv[along] <= from || pv[along] >= to) {
+					continue;
+				}
+				float t = (float)(pv[along] - u[along]) / (float)(v[along] - u[along]);
+				float y = u[1] + ((v[1] - u[1]) * t);
+				if (std::abs(pv[1] - y) <= heightTolerance) {
+					splitPoints.push_back(p);
+				}
+			}
+			if (splitPoints.empty()) {
+				continue;
+			}
+			if (u[along] > v[along]) {
+				std::reverse(splitPoints.begin(), splitPoints.end());
+			}
+			int previous	= tri[e];
+			int opposite	= tri[(e + 2) % 3];
+			splitPoints.push_back(tri[(e + 1) % 3]);
+			for (int p : splitPoints) {
+				tris.insert(tris.end(), { previous, p, opposite }); //these may need splitting along another boundary
+				previous = p;
+			}
+			split = true;
+		}
+		if (!split) {
+			pending.insert(pending.end(), tri, tri + 3);
+		}
+	}
+
+	for (int i = 0; i < (int)verts.size() / 3; ++i) {
+		outVerts.emplace_back(verts[i * 3] * cells.cellSize, verts[(i * 3) + 1] * cells.cellHeight, verts[(i * 3) + 2] * cells.cellSize);
+	}
+	outIndices = std::move(pending);
+
+	//triangles sharing an edge are neighbours
+	int triCount = (int)outIndices.size() / 3;
+	outNeighbours.assign(triCount * 3, -1);
+	std::vector<int> linkCounts(triCount, 0);
+	std::unordered_map<int64_t, int> edgeOwners;
+	for (int t = 0; t < triCount; ++t) {
+		for (int e = 0; e < 3; ++e) {
+			int a = outIndices[(t * 3) + e];
+			int b = outIndices[(t * 3) + ((e + 1) % 3)];
+			int64_t key = TileKey(std::min(a, b), std::max(a, b));
+			auto owner = edgeOwners.find(key);
+			if (owner == edgeOwners.end()) {
+				edgeOwners.insert({ key, t });
+				continue;
+			}
+			int other = owner->second;
+			if (other >= 0 && linkCounts[t] < 3 && linkCounts[other] < 3) {
+				outNeighbours[(t * 3) + linkCounts[t]++]			= other;
+				outNeighbours[(other * 3) + linkCounts[other]++]	= t;
+			}
+			owner->second = -1; //any more triangles on this edge aren't linked
+		}
+	}
+}
+
+bool NavMeshBuilder::SaveMesh(const std::string& filename) const {
+	std::vector<Vector3>	verts;
+	std::vector<int>		indices;
+	std::vector<int>		neighbours;
+	GetMesh(verts, indices, neighbours);
+
+	std::string filepath = Assets::DATADIR + filename;
+	std::ofstream file(filepath);
+	file << verts.size() << "\n";
+	file << indices.size() << "\n";
+	for (const Vector3& v : verts) {
+		file << v.x << " " << v.y << " " << v.z << "\n";
+	}
+	for (int i : indices) {
+		file << i << "\n";
+	}
+	for (size_t i = 0; i < neighbours.size(); i += 3) {
+		file << neighbours[i] << " " << neighbours[i + 1] << " " << neighbours[i + 2] << "\n";
+	}
+	if (!file) {
+		std::cout << __FUNCTION__ << " can't write " << filepath << "\n";
+		return false;
+	}
+	return true;
+}
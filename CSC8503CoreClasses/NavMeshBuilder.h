@@ -0,0 +1,123 @@
+#pragma once
+#include "NavMeshGeometry.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		struct NavMeshBuildSettings {
+			float	cellSize		= 0.3f;	//across the XZ plane
+			float	cellHeight		= 0.2f;
+			float	agentHeight		= 2.0f;
+			float	agentRadius		= 0.6f;
+			float	agentMaxClimb	= 0.9f;	//the tallest step that can be walked up
+			float	agentMaxSlope	= 45.0f;	//in degrees
+			float	maxEdgeError	= 1.3f;	//how far, in cells, walls may stray from the voxels when simplified
+			int		minRegionArea	= 64;	//in cells - any smaller separate patches of floor are dropped
+			int		tileSize		= 64;	//in cells
+		};
+
+		/*
+		Builds a navmesh from level geometry, much as Recast does - the
+		triangles are voxelised into columns of solid spans, and the tops of
+		the spans with enough headroom become floor. The floor is eroded away
+		from walls and edges by the agent's radius, split into regions that
+		have no holes in them, and the outline of each region is traced,
+		simplified, and triangulated. The result is the same data a .navmesh
+		file holds, for NavigationMesh to load.
+
+		The world is split into square tiles, each built on its own, so that
+		when part of a level changes only the tiles near it need building
+		again. Each tile voxelises a border of its neighbours' cells along with
+		its own, so the floor matches up across tiles, and the edges where
+		tiles meet are split up to match each other when they're joined into
+		one mesh.
+
+		BuildAllTiles does everything at once. RebuildTiles builds the tiles
+		over part of the world on the job system's workers instead, and
+		Update hands back finished tiles - when it returns true, call GetMesh
+		again for a mesh with them in. Everything apart from the tile builds
+		themselves happens on the thread calling these, so they should all be
+		called from the same one.
+		*/
+		class NavMeshBuilder {
+		public:
+			NavMeshBuilder(const NavMeshBuildSettings& settings = NavMeshBuildSettings());
+			~NavMeshBuilder();
+
+			NavMeshBuilder(const NavMeshBuilder&) = delete;
+			NavMeshBuilder& operator=(const NavMeshBuilder&) = delete;
+
+			//Copied, so the level can carry on changing while tiles are built from it
+			void SetGeometry(const NavMeshGeometry& geometry);
+
+			//Builds every tile the geometry covers, across the job system's workers, and waits for them
+			void BuildAllTiles();
+
+			//Builds the tiles near this region of the XZ plane again in the background, from the current geometry
+			void RebuildTiles(const Vector3& boundsMin, const Vector3& boundsMax);
+
+			//True if any finished tiles were taken in, so the mesh has changed
+			bool Update();
+
+			bool IsBuilding() const {
+				return runningTiles > 0;
+			}
+
+			int GetTileCount() const {
+				return (int)tiles.size();
+			}
+
+			//The whole mesh, in the .navmesh layout - ready for NavigationMesh, or for SaveMesh
+			void GetMesh(std::vector<Vector3>& outVerts, std::vector<int>& outIndices, std::vector<int>& outNeighbours) const;
+
+			//Writes the mesh as a .navmesh text file in Assets::DATADIR, which NavigationBaker can then bake
+			bool SaveMesh(const std::string& filename) const;
+
+		protected:
+			//Vertices are kept as whole cells and height steps, so those on shared edges match exactly
+			struct TileMesh {
+				std::vector<int> verts; //x, y, z
+				std::vector<int> tris;
+			};
+
+			struct Tile {
+				TileMesh	mesh;
+				uint32_t	builtVersion	= 0;
+				uint32_t	wantedVersion	= 0;
+				bool		building		= false;
+			};
+
+			struct FinishedTile {
+				int64_t		key;
+				uint32_t	version;
+				TileMesh	mesh;
+			};
+
+			static int64_t	TileKey(int x, int z);
+			static void		BuildTile(const NavMeshGeometry& geometry, const NavMeshBuildSettings& settings, int tileX, int tileZ, TileMesh& out);
+
+			bool	GetTileRange(const Vector3& boundsMin, const Vector3& boundsMax, int& minX, int& minZ, int& maxX, int& maxZ) const;
+			void	StartTile(int64_t key, Tile& tile);
+
+			NavMeshBuildSettings settings;
+
+			std::shared_ptr<const NavMeshGeometry> geometry;
+
+			std::map<int64_t, Tile> tiles;
+			uint32_t				nextVersion;
+			int						runningTiles;
+
+			//Filled in by the workers, emptied by Update
+			std::mutex					finishedLock;
+			std::vector<FinishedTile>	finished;
+			JobCounter					tileJobs;
+		};
+	}
+}
@@ -0,0 +1,126 @@
+#include "NavMeshGeometry.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "PhysicsObject.h"
+#include "RenderObject.h"
+#include "AABBVolume.h"
+#include "OBBVolume.h"
+#include "Mesh.h"
+
+#include <algorithm>
+
+using namespace NCL;
+using namespace CSC8503;
+
+NavMeshGeometry::NavMeshGeometry() {
+}
+
+void NavMeshGeometry::Clear() {
+	verts.clear();
+	indices.clear();
+}
+
+void NavMeshGeometry::AddTriangle(const Vector3& a, const Vector3& b, const Vector3& c) {
+	for (const Vector3& p : { a, b, c }) {
+		if (verts.empty()) {
+			boundsMin = p;
+			boundsMax = p;
+		}
+		for (int i = 0; i < 3; ++i) {
+			boundsMin[i] = std::min(boundsMin[i], p[i]);
+			boundsMax[i] = std::max(boundsMax[i], p[i]);
+		}
+		indices.push_back((int)verts.size());
+		verts.push_back(p);
+	}
+}
+
+void NavMeshGeometry::AddTriangles(const std::vector<Vector3>& meshVerts, const std::vector<unsigned int>& meshIndices, const Matrix4& transform) {
+	auto toWorld = [&](unsigned int i) {
+		Vector4 p = transform * Vector4(meshVerts[i], 1.0f);
+		return Vector3(p.x, p.y, p.z);
+	};
+	size_t count = meshIndices.empty() ? meshVerts.size() : meshIndices.size();
+	for (size_t i = 0; i + 2 < count; i += 3) {
+		if (meshIndices.empty()) {
+			AddTriangle(toWorld((unsigned int)i), toWorld((unsigned int)i + 1), toWorld((unsigned int)i + 2));
+		}
+		else {
+			AddTriangle(toWorld(meshIndices[i]), toWorld(meshIndices[i + 1]), toWorld(meshIndices[i + 2]));
+		}
+	}
+}
+
+void NavMeshGeometry::AddBox(const Vector3& centre, const Quaternion& orientation, const Vector3& halfDims) {
+	for (int axis = 0; axis < 3; ++axis) {
+		for (float side : { -1.0f, 1.0f }) {
+			Vector3 normal;
+			Vector3 u;
+			Vector3 v;
+			normal[axis]		= side * halfDims[axis];
+			u[(axis + 1) % 3]	= halfDims[(axis + 1) % 3];
+			v[(axis + 2) % 3]	= halfDims[(axis + 2) % 3];
+
+			Vector3 corners[4] = {
+				centre + orientation * (normal - u - v),
+				centre + orientation * (normal + u - v),
+				centre + orientation * (normal + u + v),
+				centre + orientation * (normal - u + v)
+			};
+			//the tangents are always the same way round, so the negative faces need flipping to face out
+			if (side > 0.0f) {
+				AddTriangle(corners[0], corners[1], corners[2]);
+				AddTriangle(corners[0], corners[2], corners[3]);
+			}
+			else {
+				AddTriangle(corners[0], corners[2], corners[1]);
+				AddTriangle(corners[0], corners[3], corners[2]);
+			}
+		}
+	}
+}
+
+void NavMeshGeometry::AddWorld(const GameWorld& world) {
+	GameObjectIterator first;
+	GameObjectIterator last;
+	world.GetObjectIterators(first, last);
+
+	for (auto i = first; i != last; ++i) {
+		const GameObject* o = *i;
+		const CollisionVolume* volume = o->GetBoundingVolume();
+		if (!volume) {
+			continue;
+		}
+		const PhysicsObject* physics = o->GetPhysicsObject();
+		if (physics && physics->GetInverseMass() > 0.0f) {
+			continue; //it can be pushed around, so can't be relied on to stand on or to stay in the way
+		}
+		const Transform& transform = o->GetTransform();
+
+		switch (volume->type) {
+			case VolumeType::AABB: {
+				AddBox(transform.GetWorldPosition(), Quaternion(), ((const AABBVolume*)volume)->GetHalfDimensions());
+			}break;
+			case VolumeType::OBB: {
+				AddBox(transform.GetWorldPosition(), transform.GetWorldOrientation(), ((const OBBVolume*)volume)->GetHalfDimensions());
+			}break;
+			case VolumeType::Mesh: {
+				const RenderObject* render = o->GetRenderObject();
+				const Rendering::Mesh* mesh = render ? render->GetMesh() : nullptr;
+				if (mesh && mesh->GetPrimitiveType() == Rendering::GeometryPrimitive::Triangles) {
+					AddTriangles(mesh->GetPositionData(), mesh->GetIndexData(), transform.GetMatrix());
+				}
+			}break;
+			default: break;
+		}
+	}
+}
+
+bool NavMeshGeometry::GetBounds(Vector3& outMin, Vector3& outMax) const {
+	if (verts.empty()) {
+		return false;
+	}
+	outMin = boundsMin;
+	outMax = boundsMax;
+	return true;
+}
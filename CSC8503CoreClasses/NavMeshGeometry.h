@@ -0,0 +1,66 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		using namespace NCL::Maths;
+
+		class GameWorld;
+
+		/*
+		The level geometry a navmesh is built from, as one big soup of
+		triangles in world space.
+
+		Winding matters - a triangle can only be walked on if it faces up,
+		which is anticlockwise seen from above, and isn't too steep. Anything
+		else only blocks. Boxes are added facing outwards.
+		*/
+		class NavMeshGeometry {
+		public:
+			NavMeshGeometry();
+
+			void Clear();
+
+			void AddTriangle(const Vector3& a, const Vector3& b, const Vector3& c);
+
+			//With no indices, every three vertices make a triangle
+			void AddTriangles(const std::vector<Vector3>& verts, const std::vector<unsigned int>& indices, const Matrix4& transform = Matrix4());
+
+			void AddBox(const Vector3& centre, const Quaternion& orientation, const Vector3& halfDims);
+
+			/*
+			Adds the collision volumes of everything in the world that can't
+			move - objects without physics, or with an inverse mass of zero.
+			AABBs and OBBs become boxes, and Mesh volumes use the triangles of
+			the object's render mesh. Spheres and capsules are left out.
+			*/
+			void AddWorld(const GameWorld& world);
+
+			const std::vector<Vector3>& GetVertices() const {
+				return verts;
+			}
+
+			const std::vector<int>& GetIndices() const {
+				return indices;
+			}
+
+			int GetTriCount() const {
+				return (int)indices.size() / 3;
+			}
+
+			//False if there's nothing in it
+			bool GetBounds(Vector3& outMin, Vector3& outMax) const;
+
+		protected:
+			std::vector<Vector3>	verts;
+			std::vector<int>		indices;
+
+			Vector3 boundsMin;
+			Vector3 boundsMax;
+		};
+	}
+}
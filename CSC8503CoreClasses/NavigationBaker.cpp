@@ -0,0 +1,111 @@
+#include "NavigationBaker.h"
+#include "NavigationData.h"
+#include "NavigationGrid.h"
+#include "NavigationMesh.h"
+#include "Assets.h"
+
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+using namespace NCL;
+using namespace CSC8503;
+using namespace NavigationData;
+
+static_assert(std::is_trivially_copyable<GridNode>::value, "Baked grid nodes are used straight from the file!");
+
+namespace {
+	//Places each section after the last, aligned
+	Section AddSection(uint64_t& fileSize, uint64_t bytes) {
+		Section s;
+		s.offset	= AlignOffset(fileSize);
+		s.size		= bytes;
+		fileSize	= s.offset + bytes;
+		return s;
+	}
+
+	void WriteSection(std::ofstream& file, const Section& s, const void* data) {
+		static const char zeroes[SectionAlignment] = { 0 };
+		std::streamoff padding = (std::streamoff)s.offset - file.tellp();
+		file.write(zeroes, padding);
+		file.write((const char*)data, (std::streamsize)s.size);
+	}
+
+	bool Finish(std::ofstream& file, const std::string& filepath) {
+		if (!file) {
+			std::cout << __FUNCTION__ << " can't write " << filepath << "\n";
+			return false;
+		}
+		return true;
+	}
+}
+
+bool NavigationBaker::BakeGrid(const std::string& textFile, const std::string& bakedFile, bool withJumpTable) {
+	NavigationGrid grid(textFile, withJumpTable);
+	if (grid.gridWidth <= 0 || grid.gridHeight <= 0) {
+		std::cout << __FUNCTION__ << " can't load grid " << textFile << "\n";
+		return false;
+	}
+	uint64_t nodeCount = (uint64_t)grid.gridWidth * grid.gridHeight;
+
+	GridHeader header = {};
+	header.file.magic	= Magic;
+	header.file.version	= Version;
+	header.file.kind	= (uint32_t)Kind::Grid;
+	header.nodeSize		= grid.nodeSize;
+	header.width		= grid.gridWidth;
+	header.height		= grid.gridHeight;
+	header.nodeStride	= sizeof(GridNode);
+	header.jumpStride	= sizeof(NavigationGrid::JumpDistances);
+
+	uint64_t fileSize = sizeof(GridHeader);
+	header.nodes		= AddSection(fileSize, nodeCount * sizeof(GridNode));
+	header.jumpTable	= AddSection(fileSize, grid.jumpTable.size() * sizeof(NavigationGrid::JumpDistances));
+
+	std::string filepath = Assets::DATADIR + bakedFile;
+	std::ofstream file(filepath, std::ios::binary);
+	file.write((const char*)&header, sizeof(header));
+	WriteSection(file, header.nodes, grid.allNodes);
+	WriteSection(file, header.jumpTable, grid.jumpTable.data());
+
+	return Finish(file, filepath);
+}
+
+bool NavigationBaker::BakeMesh(const std::string& textFile, const std::string& bakedFile) {
+	NavigationMesh mesh(textFile);
+	if (mesh.triCount == 0) {
+		std::cout << __FUNCTION__ << " can't load mesh " << textFile << "\n";
+		return false;
+	}
+	uint64_t cellCount = (uint64_t)mesh.indexWidth * mesh.indexDepth;
+
+	MeshHeader header = {};
+	header.file.magic		= Magic;
+	header.file.version		= Version;
+	header.file.kind		= (uint32_t)Kind::Mesh;
+	header.vertCount		= mesh.vertCount;
+	header.triCount			= mesh.triCount;
+	header.triStride		= sizeof(NavigationMesh::NavTri);
+	header.indexOrigin[0]	= mesh.indexOrigin.x;
+	header.indexOrigin[1]	= mesh.indexOrigin.y;
+	header.indexOrigin[2]	= mesh.indexOrigin.z;
+	header.indexCellSize	= mesh.indexCellSize;
+	header.indexWidth		= mesh.indexWidth;
+	header.indexDepth		= mesh.indexDepth;
+
+	uint64_t fileSize = sizeof(MeshHeader);
+	header.verts		= AddSection(fileSize, (uint64_t)mesh.vertCount * sizeof(Vector3));
+	header.tris			= AddSection(fileSize, (uint64_t)mesh.triCount * sizeof(NavigationMesh::NavTri));
+	header.cellStarts	= AddSection(fileSize, (cellCount + 1) * sizeof(int));
+	header.cellTris		= AddSection(fileSize, (uint64_t)mesh.cellStarts[cellCount] * sizeof(int));
+
+	std::string filepath = Assets::DATADIR + bakedFile;
+	std::ofstream file(filepath, std::ios::binary);
+	file.write((const char*)&header, sizeof(header));
+	WriteSection(file, header.verts, mesh.allVerts);
+	WriteSection(file, header.tris, mesh.allTris);
+	WriteSection(file, header.cellStarts, mesh.cellStarts);
+	WriteSection(file, header.cellTris, mesh.cellTris);
+
+	return Finish(file, filepath);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Turns text navigation assets into the binary format in NavigationData.h,
+		for loading levels without any parsing. Meant to be run offline, as
+		part of building assets, rather than by the game - it loads the text
+		file the normal way, so baking takes as long as a text load does.
+
+		Both files are in Assets::DATADIR, like the ones the grid and mesh
+		constructors load. The baked files can then be loaded by name, in
+		place of the text ones.
+		*/
+		class NavigationBaker {
+		public:
+			//Bakes the JumpPointPlus jump table in too, if asked to, so loading doesn't have to build it
+			static bool BakeGrid(const std::string& textFile, const std::string& bakedFile, bool withJumpTable = true);
+			static bool BakeMesh(const std::string& textFile, const std::string& bakedFile);
+		};
+	}
+}
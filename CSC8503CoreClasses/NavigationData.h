@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace NCL::CSC8503::NavigationData {
+	/*
+	The layout of baked navigation files, as written by NavigationBaker and
+	mapped straight into memory by NavigationGrid and NavigationMesh.
+
+	A file is one of these headers, then its sections. The sections are
+	the grid's or mesh's own arrays, byte for byte, with neighbours stored
+	as indices rather than pointers - so once the file is mapped they can
+	be used where they are, with nothing to parse or fix up. Offsets are
+	from the start of the file, and aligned so that every array is too.
+
+	Since the arrays are just memory, a file only loads on a build with the
+	same byte order and struct layouts as the one that baked it - the magic
+	number reads backwards with the wrong byte order, and the headers store
+	the struct sizes to check against. Anything that changes what's in the
+	files must bump Version.
+	*/
+	const uint32_t Magic	= 0x4256414E; //'NAVB' in memory on little endian machines
+	const uint32_t Version	= 1;
+
+	const size_t SectionAlignment = 16;
+
+	enum class Kind : uint32_t {
+		Grid = 1,
+		Mesh = 2
+	};
+
+	struct Section {
+		uint64_t offset;
+		uint64_t size; //in bytes
+	};
+
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t kind;
+		uint32_t padding;
+	};
+
+	struct GridHeader {
+		FileHeader	file;
+		int32_t		nodeSize;
+		int32_t		width;
+		int32_t		height;
+		uint32_t	nodeStride;		//sizeof(GridNode)
+		uint32_t	jumpStride;		//sizeof the jump table entries
+		uint32_t	padding;
+		Section		nodes;
+		Section		jumpTable;		//empty if it wasn't baked
+	};
+
+	struct MeshHeader {
+		FileHeader	file;
+		int32_t		vertCount;
+		int32_t		triCount;
+		uint32_t	triStride;		//sizeof(NavTri)
+		float		indexOrigin[3];
+		float		indexCellSize;
+		int32_t		indexWidth;
+		int32_t		indexDepth;
+		uint32_t	padding;
+		Section		verts;
+		Section		tris;
+		Section		cellStarts;
+		Section		cellTris;
+	};
+
+	//Rounds a file offset up to where the next section can start
+	inline uint64_t AlignOffset(uint64_t offset) {
+		return (offset + SectionAlignment - 1) & ~(uint64_t)(SectionAlignment - 1);
+	}
+
+	inline bool SectionFits(const Section& s, size_t fileSize) {
+		return (s.offset % SectionAlignment) == 0 && s.offset <= fileSize && s.size <= fileSize - s.offset;
+	}
+
+	//Just checks the magic number - a text asset never starts with it
+	inline bool IsBaked(const char* data, size_t size) {
+		return size >= sizeof(FileHeader) && ((const FileHeader*)data)->magic == Magic;
+	}
+}
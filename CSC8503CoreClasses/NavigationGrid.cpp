@@ -1,7 +1,13 @@
 #include "NavigationGrid.h"
+#include "NavigationData.h"
 #include "Assets.h"
 
 #include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include <climits>
 
 using namespace NCL;
 using namespace CSC8503;
@@ -14,15 +20,66 @@ const int BOTTOM_NODE	= 3;
 const char WALL_NODE	= 'x';
 const char FLOOR_NODE	= '.';
 
+const float DIAGONAL_COST = 1.41421356f;
+
+//How many blocked/unblocked changes are remembered for planners that haven't caught up yet
+const size_t MAX_LOGGED_CHANGES = 65536;
+
+/*
+What a jump needs to know about the search it's part of - jumps always stop
+on the goal, wherever it is.
+*/
+struct NavigationGrid::JumpContext {
+	int		goalX;
+	int		goalZ;
+	int		goalIndex;
+	bool	useTable;
+};
+
 NavigationGrid::NavigationGrid()	{
 	nodeSize	= 0;
 	gridWidth	= 0;
 	gridHeight	= 0;
 	allNodes	= nullptr;
+	hierarchy	= nullptr;
+	changeLogStart	= 0;
+	searchMode		= GridSearchMode::AStar;
+	allowDiagonals	= false;
 }
 
-NavigationGrid::NavigationGrid(const std::string&filename) : NavigationGrid() {
-	std::ifstream infile(Assets::DATADIR + filename);
+NavigationGrid::NavigationGrid(const std::string&filename, bool buildJumpTable, int clusterSize) : NavigationGrid() {
+	std::string filepath = Assets::DATADIR + filename;
+
+	//copy on write, so obstacles can still relink the nodes they change
+	if (bakedFile.Open(filepath, true) && NavigationData::IsBaked(bakedFile.GetData(), bakedFile.GetSize())) {
+		if (!LoadBaked()) {
+			std::cout << __FUNCTION__ << " can't use baked grid " << filepath << ", it needs baking again\n";
+			bakedFile.Close();
+			return;
+		}
+	}
+	else {
+		bakedFile.Close();
+		LoadText(filepath);
+	}
+
+	if (buildJumpTable && jumpTable.empty()) {
+		BuildJumpTable();
+	}
+	if (clusterSize > 0) {
+		BuildHierarchy(clusterSize);
+	}
+}
+
+NavigationGrid::~NavigationGrid()	{
+	delete hierarchy;
+	if (!bakedFile.IsOpen()) {
+		delete[] allNodes;
+	}
+}
+
+void NavigationGrid::LoadText(const std::string& filepath) {
+	std::ifstream infile(filepath);
 
 	infile >> nodeSize;
 	infile >> gridWidth;
@@ -33,6 +90,7 @@ NavigationGrid::NavigationGrid(const std::string&filename) : NavigationGrid() {
 	gridOffset.z = -(gridHeight * nodeSize) / 2.0f;
 
 	allNodes = new GridNode[gridWidth * gridHeight];
+	walkable.resize(gridWidth * gridHeight);
 
 	for (int y = 0; y < gridHeight; ++y) {
 		for (int x = 0; x < gridWidth; ++x) {
@@ -40,6 +98,7 @@ NavigationGrid::NavigationGrid(const std::string&filename) : NavigationGrid() {
 			char type = 0;
 			infile >> type;
 			n.type = type;
+			walkable[(gridWidth * y) + x] = (type != WALL_NODE);
 
 			n.position = Vector3((float)(x * nodeSize), 0, (float)(y * nodeSize)) + gridOffset;
 		}
@@ -48,134 +107,741 @@ NavigationGrid::NavigationGrid(const std::string&filename) : NavigationGrid() {
 	//now to build the connectivity between the nodes
 	for (int y = 0; y < gridHeight; ++y) {
 		for (int x = 0; x < gridWidth; ++x) {
-			GridNode&n = allNodes[(gridWidth * y) + x];		
+			ConnectNode(x, y);
+		}	
+	}
+}
 
-			if (y > 0) { //get the above node
-				n.connected[0] = &allNodes[(gridWidth * (y - 1)) + x];
-			}
-			if (y < gridHeight - 1) { //get the below node
-				n.connected[1] = &allNodes[(gridWidth * (y + 1)) + x];
-			}
-			if (x > 0) { //get left node
-				n.connected[2] = &allNodes[(gridWidth * (y)) + (x - 1)];
-			}
-			if (x < gridWidth - 1) { //get right node
-				n.connected[3] = &allNodes[(gridWidth * (y)) + (x + 1)];
+/*
+The nodes are used straight out of the mapped file, already linked up -
+only the walkable flags are rebuilt from them, and the jump table copied
+out, as obstacles change both.
+*/
+bool NavigationGrid::LoadBaked() {
+	using namespace NavigationData;
+	const char* data	= bakedFile.GetData();
+	size_t size			= bakedFile.GetSize();
+
+	if (size < sizeof(GridHeader)) {
+		return false;
+	}
+	const GridHeader& header = *(const GridHeader*)data;
+	if (header.file.version != Version || header.file.kind != (uint32_t)Kind::Grid ||
+		header.nodeStride != sizeof(GridNode) || header.jumpStride != sizeof(JumpDistances)) {
+		return false;
+	}
+	uint64_t nodeCount = (uint64_t)header.width * header.height;
+	if (header.nodeSize <= 0 || header.width <= 0 || header.height <= 0 || !SectionFits(header.nodes, size) || header.nodes.size != nodeCount * sizeof(GridNode)) {
+		return false;
+	}
+	bool hasJumpTable = header.jumpTable.size > 0;
+	if (hasJumpTable && (!SectionFits(header.jumpTable, size) || header.jumpTable.size != nodeCount * sizeof(JumpDistances))) {
+		return false;
+	}
+	nodeSize	= header.nodeSize;
+	gridWidth	= header.width;
+	gridHeight	= header.height;
+
+	gridOffset.x = -(gridWidth * nodeSize) / 2.0f;
+	gridOffset.z = -(gridHeight * nodeSize) / 2.0f;
+
+	allNodes = (GridNode*)(bakedFile.GetWritableData() + header.nodes.offset);
+
+	walkable.resize(gridWidth * gridHeight);
+	for (int i = 0; i < gridWidth * gridHeight; ++i) {
+		walkable[i] = (allNodes[i].type != WALL_NODE);
+	}
+	if (hasJumpTable) {
+		const JumpDistances* table = (const JumpDistances*)(data + header.jumpTable.offset);
+		jumpTable.assign(table, table + nodeCount);
+	}
+	return true;
+}
+
+//Links a node to its open neighbours - done at load, and again whenever obstacles change what's open
+void NavigationGrid::ConnectNode(int x, int y) {
+	GridNode&n = allNodes[(gridWidth * y) + x];
+
+	const int offsets[4][2] = {
+		{0, -1},	//the above node
+		{0, 1},		//the below node
+		{-1, 0},	//left node
+		{1, 0}		//right node
+	};
+	for (int i = 0; i < 4; ++i) {
+		n.connected[i]	= -1;
+		n.costs[i]		= 0;
+
+		int nx = x + offsets[i][0];
+		int ny = y + offsets[i][1];
+		if (!IsWalkable(nx, ny)) {
+			continue; //off the grid, a wall, or blocked - disconnect!
+		}
+		n.connected[i] = (gridWidth * ny) + nx;
+		if (allNodes[n.connected[i]].type == FLOOR_NODE) {
+			n.costs[i] = 1;
+		}
+	}
+}
+
+/*
+Obstacle changes only touch wantedObstacles - the nodes stay as they are
+until ApplyPendingChanges, so searches running on other threads never see
+them change underneath them. A slot freed by RemoveObstacle can be handed
+straight back out, as applying only ever compares what each slot covers
+now with what it should cover.
+*/
+int NavigationGrid::AddObstacle(const Vector3& boxMin, const Vector3& boxMax) {
+	int index = 0;
+	if (!freeObstacles.empty()) {
+		index = freeObstacles.back();
+		freeObstacles.pop_back();
+	}
+	else {
+		index = (int)obstacles.size();
+		obstacles.emplace_back();
+		obstacles[index].active = false;
+		wantedObstacles.emplace_back();
+	}
+	Obstacle& w = wantedObstacles[index];
+	GetObstacleNodes(boxMin, boxMax, w);
+	w.active = true;
+	changedObstacles.push_back(index);
+	return index;
+}
+
+void NavigationGrid::MoveObstacle(int obstacle, const Vector3& boxMin, const Vector3& boxMax) {
+	Obstacle& w = wantedObstacles[obstacle];
+	if (!w.active) {
+		return;
+	}
+	Obstacle moved;
+	GetObstacleNodes(boxMin, boxMax, moved);
+	if (moved.minX == w.minX && moved.minZ == w.minZ && moved.maxX == w.maxX && moved.maxZ == w.maxZ) {
+		return;
+	}
+	moved.active = true;
+	w = moved;
+	changedObstacles.push_back(obstacle);
+}
+
+void NavigationGrid::RemoveObstacle(int obstacle) {
+	Obstacle& w = wantedObstacles[obstacle];
+	if (!w.active) {
+		return;
+	}
+	w.active = false;
+	changedObstacles.push_back(obstacle);
+	freeObstacles.push_back(obstacle);
+}
+
+void NavigationGrid::ApplyPendingChanges() {
+	if (changedObstacles.empty()) {
+		return;
+	}
+	if (blockedCounts.empty()) {
+		blockedCounts.resize(gridWidth * gridHeight);
+	}
+	uint64_t firstChange = GetChangeCount();
+
+	for (int i : changedObstacles) {
+		Obstacle& o			= obstacles[i];
+		const Obstacle& w	= wantedObstacles[i];
+		if (o.active == w.active && (!o.active ||
+			(o.minX == w.minX && o.minZ == w.minZ && o.maxX == w.maxX && o.maxZ == w.maxZ))) {
+			continue; //already there, or moved more than once
+		}
+		//block the new nodes first, so nodes under both never flicker open in the log
+		if (w.active) {
+			BlockNodes(w, 1);
+		}
+		if (o.active) {
+			BlockNodes(o, -1);
+		}
+		o = w;
+	}
+	changedObstacles.clear();
+
+	RepairSearchData(firstChange);
+}
+
+/*
+Only the nodes around the ones that changed can have different jumps or
+entrances, so the jump table and hierarchy are patched up from the change
+log - unless so much has changed that the log no longer goes back far
+enough, when they're built again from scratch.
+*/
+void NavigationGrid::RepairSearchData(uint64_t firstChange) {
+	std::vector<int> changed;
+	if (!GetChangesSince(firstChange, changed)) {
+		if (!jumpTable.empty()) {
+			BuildJumpTable();
+		}
+		if (hierarchy) {
+			BuildHierarchy(hierarchy->GetClusterSize());
+		}
+		return;
+	}
+	if (changed.empty()) {
+		return;
+	}
+	if (!jumpTable.empty()) {
+		UpdateJumpTable(changed);
+	}
+	if (hierarchy) {
+		hierarchy->UpdateCells(changed);
+	}
+}
+
+bool NavigationGrid::GetChangesSince(uint64_t since, std::vector<int>& outNodes) const {
+	if (since < changeLogStart) {
+		return false;
+	}
+	for (uint64_t i = since; i < GetChangeCount(); ++i) {
+		outNodes.push_back(changeLog[(size_t)(i - changeLogStart)]);
+	}
+	return true;
+}
+
+//Boxes just touching the edge of a node don't block it
+void NavigationGrid::GetObstacleNodes(const Vector3& boxMin, const Vector3& boxMax, Obstacle& o) const {
+	const float edgeSlack = 0.001f;
+	o.minX = std::max((int)std::floor((boxMin.x - gridOffset.x) / nodeSize + edgeSlack), 0);
+	o.minZ = std::max((int)std::floor((boxMin.z - gridOffset.z) / nodeSize + edgeSlack), 0);
+	o.maxX = std::min((int)std::floor((boxMax.x - gridOffset.x) / nodeSize - edgeSlack), gridWidth - 1);
+	o.maxZ = std::min((int)std::floor((boxMax.z - gridOffset.z) / nodeSize - edgeSlack), gridHeight - 1);
+	o.active = false;
+}
+
+void NavigationGrid::BlockNodes(const Obstacle& o, int change) {
+	for (int z = o.minZ; z <= o.maxZ; ++z) {
+		for (int x = o.minX; x <= o.maxX; ++x) {
+			int index = (z * gridWidth) + x;
+			blockedCounts[index] += change;
+
+			bool open = (allNodes[index].type != WALL_NODE) && blockedCounts[index] == 0;
+			if (open == (bool)walkable[index]) {
+				continue;
 			}
-			for (int i = 0; i < 4; ++i) {
-				if (n.connected[i]) {
-					if (n.connected[i]->type == '.') {
-						n.costs[i]		= 1;
-					}
-					if (n.connected[i]->type == 'x') {
-						n.connected[i] = nullptr; //actually a wall, disconnect!
-					}
-				}
+			walkable[index] = open;
+
+			ConnectNode(x, z);
+			if (x > 0)				{ ConnectNode(x - 1, z); }
+			if (x < gridWidth - 1)	{ ConnectNode(x + 1, z); }
+			if (z > 0)				{ ConnectNode(x, z - 1); }
+			if (z < gridHeight - 1)	{ ConnectNode(x, z + 1); }
+
+			changeLog.push_back(index);
+			if (changeLog.size() > MAX_LOGGED_CHANGES) {
+				changeLog.pop_front();
+				changeLogStart++;
 			}
-		}	
+		}
 	}
 }
 
-NavigationGrid::~NavigationGrid()	{
-	delete[] allNodes;
+bool NavigationGrid::WorldToGrid(const Vector3& pos, int& x, int& z) const {
+	if (!allNodes) {
+		return false; //nothing loaded
+	}
+	x = ((int)(pos.x - gridOffset.x) / nodeSize);
+	z = ((int)(pos.z - gridOffset.z) / nodeSize);
+
+	return x >= 0 && x < gridWidth && z >= 0 && z < gridHeight;
 }
 
 bool NavigationGrid::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) {
+	static thread_local PathSearchState state;
+	return FindPath(from, to, outPath, state);
+}
+
+bool NavigationGrid::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) const {
 	//need to work out which node 'from' sits in, and 'to' sits in
-	int fromX = ((int)(from.x - gridOffset.x) / nodeSize);
-	int fromZ = ((int)(from.z - gridOffset.z) / nodeSize);
+	int fromX, fromZ, toX, toZ;
+	if (!WorldToGrid(from, fromX, fromZ) || !WorldToGrid(to, toX, toZ)) {
+		return false; //outside of map region!
+	}
 
-	int toX = ((int)(to.x - gridOffset.x) / nodeSize);
-	int toZ = ((int)(to.z - gridOffset.z) / nodeSize);
+	int startIndex	= (fromZ * gridWidth) + fromX;
+	int endIndex	= (toZ * gridWidth) + toX;
 
-	if (fromX < 0 || fromX > gridWidth - 1 ||
-		fromZ < 0 || fromZ > gridHeight - 1) {
-		return false; //outside of map region!
+	if (searchMode == GridSearchMode::Hierarchical && hierarchy) {
+		return hierarchy->FindPath(startIndex, endIndex, outPath, state);
 	}
+	if (searchMode == GridSearchMode::AStar || searchMode == GridSearchMode::Hierarchical) {
+		return AStarSearch(startIndex, endIndex, outPath, state);
+	}
+	return JumpPointSearch(startIndex, endIndex, outPath, state);
+}
 
-	if (toX < 0 || toX > gridWidth - 1 ||
-		toZ < 0 || toZ > gridHeight - 1) {
-		return false; //outside of map region!
+void NavigationGrid::SetSearchMode(GridSearchMode mode) {
+	searchMode = mode;
+	if (mode == GridSearchMode::JumpPointPlus && jumpTable.empty()) {
+		BuildJumpTable();
+	}
+	if (mode == GridSearchMode::Hierarchical && !hierarchy) {
+		BuildHierarchy();
+	}
+}
+
+void NavigationGrid::SetDiagonalMovement(bool allow) {
+	allowDiagonals = allow;
+	if (hierarchy && hierarchy->GetDiagonalMovement() != allow) {
+		BuildHierarchy(hierarchy->GetClusterSize());
 	}
+}
+
+void NavigationGrid::BuildHierarchy(int clusterSize) {
+	delete hierarchy;
+	hierarchy = new GridHierarchy(*this, clusterSize);
+}
 
-	GridNode* startNode = &allNodes[(fromZ * gridWidth) + fromX];
-	GridNode* endNode	= &allNodes[(toZ * gridWidth) + toX];
+PathSearchStatus NavigationGrid::StartPathSearch(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) {
+	int fromX, fromZ, toX, toZ;
+	if (!WorldToGrid(from, fromX, fromZ) || !WorldToGrid(to, toX, toZ)) {
+		return PathSearchStatus::NotFound;
+	}
+	int startIndex	= (fromZ * gridWidth) + fromX;
+	int endIndex	= (toZ * gridWidth) + toX;
+
+	if (searchMode == GridSearchMode::Hierarchical && hierarchy) {
+		bool found = hierarchy->FindPath(startIndex, endIndex, outPath, state);
+		return found ? PathSearchStatus::Found : PathSearchStatus::NotFound;
+	}
+	state.Begin(gridWidth * gridHeight);
+	state.SetGoal(endIndex);
+	state.Open(startIndex, 0.0f, Heuristic(startIndex, endIndex), PathSearchState::NoNode);
+	return PathSearchStatus::Searching;
+}
+
+PathSearchStatus NavigationGrid::ContinuePathSearch(NavigationPath& outPath, PathSearchState& state, int maxNodes) {
+	if (searchMode == GridSearchMode::AStar || searchMode == GridSearchMode::Hierarchical) {
+		return AStarExpand(outPath, state, maxNodes);
+	}
+	return JumpPointExpand(outPath, state, maxNodes);
+}
+
+void NavigationGrid::PushPath(int endIndex, NavigationPath& outPath, const PathSearchState& state) const {
+	for (int node = endIndex; node != PathSearchState::NoNode; node = state.GetParent(node)) {
+		outPath.PushWaypoint(allNodes[node].position);
+	}
+}
 
-	std::vector<GridNode*>  openList;
-	std::vector<GridNode*>  closedList;
+bool NavigationGrid::AStarSearch(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const {
+	state.Begin(gridWidth * gridHeight);
+	state.SetGoal(endIndex);
+	state.Open(startIndex, 0.0f, Heuristic(startIndex, endIndex), PathSearchState::NoNode);
 
-	openList.push_back(startNode);
+	return AStarExpand(outPath, state, INT_MAX) == PathSearchStatus::Found;
+}
 
-	startNode->f = 0;
-	startNode->g = 0;
-	startNode->parent = nullptr;
+PathSearchStatus NavigationGrid::AStarExpand(NavigationPath& outPath, PathSearchState& state, int maxNodes) const {
+	int endIndex = state.GetGoal();
 
-	GridNode* currentBestNode = nullptr;
+	for (int n = 0; n < maxNodes; ++n) {
+		if (!state.HasOpenNodes()) {
+			return PathSearchStatus::NotFound; //open list emptied out with no path!
+		}
+		int current = state.PopBest();
 
-	while (!openList.empty()) {
-		currentBestNode = RemoveBestNode(openList);
+		if (current == endIndex) { //we've found the path!
+			PushPath(endIndex, outPath, state);
+			return PathSearchStatus::Found;
+		}
+		const GridNode& currentNode = allNodes[current];
 
-		if (currentBestNode == endNode) {			//we've found the path!
-			GridNode* node = endNode;
-			while (node != nullptr) {
-				outPath.PushWaypoint(node->position);
-				node = node->parent;
+		for (int i = 0; i < 4; ++i) {
+			int neighbourIndex = currentNode.connected[i];
+			if (neighbourIndex < 0) { //might not be connected...
+				continue;
 			}
-			return true;
+			if (state.IsClosed(neighbourIndex)) {
+				continue; //already discarded this neighbour...
+			}
+			float g = state.GetCost(current) + currentNode.costs[i];
+			state.Open(neighbourIndex, g, Heuristic(neighbourIndex, endIndex), current);
 		}
-		else {
-			for (int i = 0; i < 4; ++i) {
-				GridNode* neighbour = currentBestNode->connected[i];
-				if (!neighbour) { //might not be connected...
+		if (!allowDiagonals) {
+			continue;
+		}
+		int x = current % gridWidth;
+		int z = current / gridWidth;
+		for (int dz = -1; dz <= 1; dz += 2) {
+			for (int dx = -1; dx <= 1; dx += 2) {
+				//no cutting corners - both of the straight neighbours need to be open too
+				if (!IsWalkable(x + dx, z + dz) || !IsWalkable(x + dx, z) || !IsWalkable(x, z + dz)) {
 					continue;
-				}	
-				bool inClosed	= NodeInList(neighbour, closedList);
-				if (inClosed) {
-					continue; //already discarded this neighbour...
 				}
+				int neighbourIndex = ((z + dz) * gridWidth) + (x + dx);
+				if (state.IsClosed(neighbourIndex)) {
+					continue;
+				}
+				float g = state.GetCost(current) + DIAGONAL_COST;
+				state.Open(neighbourIndex, g, Heuristic(neighbourIndex, endIndex), current);
+			}
+		}
+	}
+	return state.HasOpenNodes() ? PathSearchStatus::Searching : PathSearchStatus::NotFound;
+}
 
-				float h = Heuristic(neighbour, endNode);				
-				float g = currentBestNode->g + currentBestNode->costs[i];
-				float f = h + g;
+/*
+Jump Point Search - rather than adding every neighbour to the open list,
+each direction worth trying from a node is followed in a straight line
+until it reaches somewhere that a shortest path might have to turn (a
+'jump point'), a wall, or the goal. Only jump points go on the open list,
+so on open floor a search touches a tiny fraction of the nodes.
+*/
+bool NavigationGrid::JumpPointSearch(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const {
+	state.Begin(gridWidth * gridHeight);
+	state.SetGoal(endIndex);
+	state.Open(startIndex, 0.0f, Heuristic(startIndex, endIndex), PathSearchState::NoNode);
+
+	return JumpPointExpand(outPath, state, INT_MAX) == PathSearchStatus::Found;
+}
 
-				bool inOpen		= NodeInList(neighbour, openList);
+PathSearchStatus NavigationGrid::JumpPointExpand(NavigationPath& outPath, PathSearchState& state, int maxNodes) const {
+	int endIndex = state.GetGoal();
 
-				if (!inOpen) { //first time we've seen this neighbour
-					openList.emplace_back(neighbour);
-				}
-				if (!inOpen || f < neighbour->f) {//might be a better route to this neighbour
-					neighbour->parent = currentBestNode;
-					neighbour->f = f;
-					neighbour->g = g;
-				}
+	JumpContext c;
+	c.goalX		= endIndex % gridWidth;
+	c.goalZ		= endIndex / gridWidth;
+	c.goalIndex	= endIndex;
+	c.useTable	= (searchMode == GridSearchMode::JumpPointPlus) && !jumpTable.empty();
+
+	for (int n = 0; n < maxNodes; ++n) {
+		if (!state.HasOpenNodes()) {
+			return PathSearchStatus::NotFound;
+		}
+		int current = state.PopBest();
+
+		if (current == endIndex) {
+			PushPath(endIndex, outPath, state);
+			return PathSearchStatus::Found;
+		}
+		AddJumpSuccessors(c, current, state);
+	}
+	return state.HasOpenNodes() ? PathSearchStatus::Searching : PathSearchStatus::NotFound;
+}
+
+/*
+Which directions are worth following from a node depends on the way it was
+reached - anything else is reached at least as cheaply by a path that
+doesn't go through this node. The jumps themselves check the walls, and
+pick up the 'forced' neighbours that walls create.
+*/
+void NavigationGrid::AddJumpSuccessors(const JumpContext& c, int node, PathSearchState& state) const {
+	int x = node % gridWidth;
+	int z = node / gridWidth;
+
+	int dirs[8][2];
+	int dirCount = 0;
+	auto addDir = [&](int dx, int dz) {
+		dirs[dirCount][0] = dx;
+		dirs[dirCount][1] = dz;
+		dirCount++;
+	};
+
+	int parent = state.GetParent(node);
+	if (parent == PathSearchState::NoNode) {
+		addDir(1, 0); addDir(-1, 0); addDir(0, 1); addDir(0, -1);
+		if (allowDiagonals) {
+			addDir(1, 1); addDir(-1, 1); addDir(1, -1); addDir(-1, -1);
+		}
+	}
+	else {
+		int dx = (x > parent % gridWidth) - (x < parent % gridWidth);
+		int dz = (z > parent / gridWidth) - (z < parent / gridWidth);
+
+		if (dx != 0 && dz != 0) {
+			addDir(dx, dz); addDir(dx, 0); addDir(0, dz);
+		}
+		else if (dx != 0) {
+			addDir(dx, 0); addDir(0, 1); addDir(0, -1);
+			if (allowDiagonals) {
+				addDir(dx, 1); addDir(dx, -1);
+			}
+		}
+		else {
+			addDir(0, dz); addDir(1, 0); addDir(-1, 0);
+			if (allowDiagonals) {
+				addDir(1, dz); addDir(-1, dz);
 			}
-			closedList.emplace_back(currentBestNode);
 		}
 	}
-	return false; //open list emptied out with no path!
+
+	for (int i = 0; i < dirCount; ++i) {
+		int jumpPoint = Jump(c, x, z, dirs[i][0], dirs[i][1]);
+		if (jumpPoint == PathSearchState::NoNode || state.IsClosed(jumpPoint)) {
+			continue;
+		}
+		float g = state.GetCost(node) + StepCost(node, jumpPoint);
+		state.Open(jumpPoint, g, Heuristic(jumpPoint, c.goalIndex), node);
+	}
 }
 
-bool NavigationGrid::NodeInList(GridNode* n, std::vector<GridNode*>& list) const {
-	std::vector<GridNode*>::iterator i = std::find(list.begin(), list.end(), n);
-	return i == list.end() ? false : true;
+//All of the jumps start from (x, z), and look at the nodes after it in the given direction
+int NavigationGrid::Jump(const JumpContext& c, int x, int z, int dx, int dz) const {
+	if (dx != 0 && dz != 0) {
+		return JumpDiagonal(c, x, z, dx, dz);
+	}
+	if (!allowDiagonals && dz != 0) {
+		return c.useTable ? TableJumpVertical4(c, x, z, dz) : JumpVertical4(c, x, z, dz);
+	}
+	return c.useTable ? TableJumpStraight(c, x, z, dx, dz) : JumpStraight(c, x, z, dx, dz);
 }
 
-GridNode*  NavigationGrid::RemoveBestNode(std::vector<GridNode*>& list) const {
-	std::vector<GridNode*>::iterator bestI = list.begin();
+/*
+A wall beside the line that ends partway along opens up a node that could
+only be reached cheaply by turning here - so this is a jump point.
+*/
+bool NavigationGrid::HasForcedNeighbour(int x, int z, int dx, int dz) const {
+	if (dx != 0) {
+		return (IsWalkable(x, z - 1) && !IsWalkable(x - dx, z - 1)) ||
+			   (IsWalkable(x, z + 1) && !IsWalkable(x - dx, z + 1));
+	}
+	return (IsWalkable(x - 1, z) && !IsWalkable(x - 1, z - dz)) ||
+		   (IsWalkable(x + 1, z) && !IsWalkable(x + 1, z - dz));
+}
 
-	GridNode* bestNode = *list.begin();
+int NavigationGrid::JumpStraight(const JumpContext& c, int x, int z, int dx, int dz) const {
+	while (true) {
+		x += dx;
+		z += dz;
+		if (!IsWalkable(x, z)) {
+			return PathSearchState::NoNode;
+		}
+		int index = (z * gridWidth) + x;
+		if (index == c.goalIndex || HasForcedNeighbour(x, z, dx, dz)) {
+			return index;
+		}
+	}
+}
 
-	for (auto i = list.begin(); i != list.end(); ++i) {
-		if ((*i)->f < bestNode->f) {
-			bestNode	= (*i);
-			bestI		= i;
+/*
+Without diagonals, vertical runs play the part that diagonal ones do in
+8-way JPS - every node along them also looks sideways, and stops if
+there's anything to find that way.
+*/
+int NavigationGrid::JumpVertical4(const JumpContext& c, int x, int z, int dz) const {
+	while (true) {
+		z += dz;
+		if (!IsWalkable(x, z)) {
+			return PathSearchState::NoNode;
+		}
+		int index = (z * gridWidth) + x;
+		if (index == c.goalIndex || HasForcedNeighbour(x, z, 0, dz)) {
+			return index;
+		}
+		if (JumpStraight(c, x, z, 1, 0) != PathSearchState::NoNode ||
+			JumpStraight(c, x, z, -1, 0) != PathSearchState::NoNode) {
+			return index;
 		}
 	}
-	list.erase(bestI);
+}
 
-	return bestNode;
+int NavigationGrid::JumpDiagonal(const JumpContext& c, int x, int z, int dx, int dz) const {
+	while (true) {
+		if (!IsWalkable(x + dx, z) || !IsWalkable(x, z + dz)) {
+			return PathSearchState::NoNode; //would cut a corner
+		}
+		x += dx;
+		z += dz;
+		if (!IsWalkable(x, z)) {
+			return PathSearchState::NoNode;
+		}
+		int index = (z * gridWidth) + x;
+		if (index == c.goalIndex) {
+			return index;
+		}
+		int alongX = c.useTable ? TableJumpStraight(c, x, z, dx, 0) : JumpStraight(c, x, z, dx, 0);
+		if (alongX != PathSearchState::NoNode) {
+			return index;
+		}
+		int alongZ = c.useTable ? TableJumpStraight(c, x, z, 0, dz) : JumpStraight(c, x, z, 0, dz);
+		if (alongZ != PathSearchState::NoNode) {
+			return index;
+		}
+	}
 }
 
-float NavigationGrid::Heuristic(GridNode* hNode, GridNode* endNode) const {
-	return Vector::Length(hNode->position - endNode->position);
-}
\ No newline at end of file
+/*
+JPS+ - the straight jumps don't depend on the search, apart from stopping at
+the goal, so how far each one goes can be worked out for every node up
+front. A jump is then a table lookup, plus a check for the goal being on
+the way.
+*/
+void NavigationGrid::BuildJumpTable() {
+	jumpTable.resize(gridWidth * gridHeight);
+
+	//the vertical jumps look at the sideways ones, so every row has to be done first
+	for (int z = 0; z < gridHeight; ++z) {
+		BuildJumpRow(z);
+	}
+	for (int x = 0; x < gridWidth; ++x) {
+		BuildJumpColumn(x);
+	}
+}
+
+//steps to the next jump point if there is one, otherwise minus the steps to the wall
+static int NextJump(int v) {
+	return v > 0 ? v + 1 : v - 1;
+}
+
+void NavigationGrid::BuildJumpRow(int z) {
+	for (int x = gridWidth - 1; x >= 0; --x) {
+		int& v = jumpTable[(z * gridWidth) + x].straight[JumpPosX];
+		if (!IsWalkable(x + 1, z)) {
+			v = 0;
+		}
+		else {
+			v = HasForcedNeighbour(x + 1, z, 1, 0) ? 1 : NextJump(jumpTable[(z * gridWidth) + x + 1].straight[JumpPosX]);
+		}
+	}
+	for (int x = 0; x < gridWidth; ++x) {
+		int& v = jumpTable[(z * gridWidth) + x].straight[JumpNegX];
+		if (!IsWalkable(x - 1, z)) {
+			v = 0;
+		}
+		else {
+			v = HasForcedNeighbour(x - 1, z, -1, 0) ? 1 : NextJump(jumpTable[(z * gridWidth) + x - 1].straight[JumpNegX]);
+		}
+	}
+}
+
+void NavigationGrid::BuildJumpColumn(int x) {
+	for (int z = gridHeight - 1; z >= 0; --z) {
+		JumpDistances& d = jumpTable[(z * gridWidth) + x];
+		if (!IsWalkable(x, z + 1)) {
+			d.straight[JumpPosZ]	= 0;
+			d.vertical[0]			= 0;
+			continue;
+		}
+		const JumpDistances& n = jumpTable[((z + 1) * gridWidth) + x];
+		bool forced		= HasForcedNeighbour(x, z + 1, 0, 1);
+		bool sideways	= n.straight[JumpPosX] > 0 || n.straight[JumpNegX] > 0;
+
+		d.straight[JumpPosZ]	= forced ? 1 : NextJump(n.straight[JumpPosZ]);
+		d.vertical[0]			= (forced || sideways) ? 1 : NextJump(n.vertical[0]);
+	}
+	for (int z = 0; z < gridHeight; ++z) {
+		JumpDistances& d = jumpTable[(z * gridWidth) + x];
+		if (!IsWalkable(x, z - 1)) {
+			d.straight[JumpNegZ]	= 0;
+			d.vertical[1]			= 0;
+			continue;
+		}
+		const JumpDistances& n = jumpTable[((z - 1) * gridWidth) + x];
+		bool forced		= HasForcedNeighbour(x, z - 1, 0, -1);
+		bool sideways	= n.straight[JumpPosX] > 0 || n.straight[JumpNegX] > 0;
+
+		d.straight[JumpNegZ]	= forced ? 1 : NextJump(n.straight[JumpNegZ]);
+		d.vertical[1]			= (forced || sideways) ? 1 : NextJump(n.vertical[1]);
+	}
+}
+
+/*
+A node's walkability feeds into the sideways jumps of its own row and the
+rows either side (through the forced neighbour checks), and the vertical
+jumps of its own column and the columns either side. The vertical jumps
+also stop wherever a sideways one finds a jump point, so any column where
+that changed in the rebuilt rows needs doing again too.
+*/
+void NavigationGrid::UpdateJumpTable(const std::vector<int>& changedNodes) {
+	std::vector<char> rows(gridHeight, 0);
+	std::vector<char> columns(gridWidth, 0);
+	for (int index : changedNodes) {
+		int x = index % gridWidth;
+		int z = index / gridWidth;
+		for (int i = std::max(z - 1, 0); i <= std::min(z + 1, gridHeight - 1); ++i) {
+			rows[i] = 1;
+		}
+		for (int i = std::max(x - 1, 0); i <= std::min(x + 1, gridWidth - 1); ++i) {
+			columns[i] = 1;
+		}
+	}
+	auto sideways = [&](int index) {
+		return jumpTable[index].straight[JumpPosX] > 0 || jumpTable[index].straight[JumpNegX] > 0;
+	};
+	std::vector<char> stopped(gridWidth);
+	for (int z = 0; z < gridHeight; ++z) {
+		if (!rows[z]) {
+			continue;
+		}
+		for (int x = 0; x < gridWidth; ++x) {
+			stopped[x] = sideways((z * gridWidth) + x);
+		}
+		BuildJumpRow(z);
+		for (int x = 0; x < gridWidth; ++x) {
+			if (stopped[x] != (char)sideways((z * gridWidth) + x)) {
+				columns[x] = 1;
+			}
+		}
+	}
+	for (int x = 0; x < gridWidth; ++x) {
+		if (columns[x]) {
+			BuildJumpColumn(x);
+		}
+	}
+}
+
+int NavigationGrid::TableJumpStraight(const JumpContext& c, int fromX, int fromZ, int dx, int dz) const {
+	int dir = dx > 0 ? JumpPosX : (dx < 0 ? JumpNegX : (dz > 0 ? JumpPosZ : JumpNegZ));
+	int v		= jumpTable[(fromZ * gridWidth) + fromX].straight[dir];
+	int steps	= v > 0 ? v : -v;
+
+	if (dz == 0 && c.goalZ == fromZ) {
+		int toGoal = (c.goalX - fromX) * dx;
+		if (toGoal > 0 && toGoal <= steps) {
+			return c.goalIndex;
+		}
+	}
+	if (dx == 0 && c.goalX == fromX) {
+		int toGoal = (c.goalZ - fromZ) * dz;
+		if (toGoal > 0 && toGoal <= steps) {
+			return c.goalIndex;
+		}
+	}
+	return v > 0 ? ((fromZ + (dz * v)) * gridWidth) + fromX + (dx * v) : PathSearchState::NoNode;
+}
+
+int NavigationGrid::TableJumpVertical4(const JumpContext& c, int fromX, int fromZ, int dz) const {
+	int v		= jumpTable[(fromZ * gridWidth) + fromX].vertical[dz > 0 ? 0 : 1];
+	int steps	= v > 0 ? v : -v;
+
+	int toGoalRow = (c.goalZ - fromZ) * dz;
+	if (toGoalRow > 0 && toGoalRow <= steps) {
+		if (c.goalX == fromX) {
+			return c.goalIndex;
+		}
+		//the sideways jump from the goal's row would run into it
+		int goalRowIndex	= (c.goalZ * gridWidth) + fromX;
+		int sideways		= jumpTable[goalRowIndex].straight[c.goalX > fromX ? JumpPosX : JumpNegX];
+		if (std::abs(c.goalX - fromX) <= std::abs(sideways)) {
+			return goalRowIndex;
+		}
+	}
+	return v > 0 ? ((fromZ + (dz * v)) * gridWidth) + fromX : PathSearchState::NoNode;
+}
+
+//Jump points are always in a straight or diagonal line from each other
+float NavigationGrid::StepCost(int fromIndex, int toIndex) const {
+	int dx = std::abs((fromIndex % gridWidth) - (toIndex % gridWidth));
+	int dz = std::abs((fromIndex / gridWidth) - (toIndex / gridWidth));
+	int diagonal = std::min(dx, dz);
+	return (float)(dx + dz - 2 * diagonal) + (diagonal * DIAGONAL_COST);
+}
+
+/*
+Manhattan distance in nodes (or octile distance, with diagonals) - every
+step costs at least 1, so this never overestimates, and the first path
+found is a shortest one.
+*/
+float NavigationGrid::Heuristic(int fromIndex, int toIndex) const {
+	int dx = std::abs((fromIndex % gridWidth) - (toIndex % gridWidth));
+	int dz = std::abs((fromIndex / gridWidth) - (toIndex / gridWidth));
+	if (!allowDiagonals) {
+		return (float)(dx + dz);
+	}
+	int diagonal = std::min(dx, dz);
+	return (float)(dx + dz - 2 * diagonal) + (diagonal * DIAGONAL_COST);
+}
@@ -1,53 +1,249 @@
 #pragma once
 #include "NavigationMap.h"
+#include "PathSearchState.h"
+#include "GridHierarchy.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <vector>
 namespace NCL {
 	namespace CSC8503 {
-		struct GridNode {
-			GridNode* parent;
+		/*
+		Just the shape of the grid - what each node is, and which neighbours it
+		connects to. The state of a search lives in a PathSearchState, so the
+		grid itself is never written to once it's loaded.
 
-			GridNode* connected[4];
-			int		  costs[4];
+		Neighbours are node indices (or -1) rather than pointers, so baked
+		grids can be used straight from the file.
+		*/
+		struct GridNode {
+			int		connected[4];
+			int		costs[4];
 
 			Vector3		position;
 
-			float f;
-			float g;
-
 			int type;
 
 			GridNode() {
 				for (int i = 0; i < 4; ++i) {
-					connected[i] = nullptr;
+					connected[i] = -1;
 					costs[i] = 0;
 				}
-				f = 0;
-				g = 0;
 				type = 0;
-				parent = nullptr;
 			}
-			~GridNode() {	}
 		};
 
+		enum class GridSearchMode {
+			AStar,			//plain A* over every node
+			JumpPoint,		//Jump Point Search - only expands the nodes where a path could have to turn
+			JumpPointPlus,	//JPS, with the straight-line jumps looked up from a table made at load time
+			Hierarchical	//HPA* over clusters of nodes - see GridHierarchy
+		};
+
+		/*
+		Jump Point Search relies on every move costing the same, which holds
+		for these grids - nodes are only ever floor or wall. Its paths only
+		have waypoints where they turn, so they come back with far fewer of
+		them than A*'s one-per-node paths, and are just as short.
+
+		With diagonal movement on, paths can go diagonally between nodes, but
+		never cut the corner of a wall.
+
+		For the biggest maps, Hierarchical mode searches a graph of cluster
+		entrances made at load time instead of the nodes themselves, which
+		keeps long queries cheap at the cost of slightly longer paths.
+		*/
 		class NavigationGrid : public NavigationMap	{
 		public:
 			NavigationGrid();
-			NavigationGrid(const std::string&filename);
+			static const int DefaultClusterSize = 16;
+
+			/*
+			Loads either the text format, or a file baked by NavigationBaker,
+			which is mapped rather than read, and comes with its jump table if
+			one was baked. A clusterSize above zero builds the hierarchy for
+			Hierarchical searches as well.
+			*/
+			NavigationGrid(const std::string&filename, bool buildJumpTable = false, int clusterSize = 0);
 			~NavigationGrid();
 
+			//Not thread safe - set these up before any searches start
+			void SetSearchMode(GridSearchMode mode);
+			//Rebuilds the hierarchy if there is one, as its costs depend on this
+			void SetDiagonalMovement(bool allow);
+			//Needed for JumpPointPlus - done automatically when switching to it if it wasn't done at load
+			void BuildJumpTable();
+			//Needed for Hierarchical - done automatically (with the default cluster size) when switching to it if it wasn't done at load
+			void BuildHierarchy(int clusterSize = DefaultClusterSize);
+
+			const GridHierarchy* GetHierarchy() const {
+				return hierarchy;
+			}
+
+			GridSearchMode GetSearchMode() const {
+				return searchMode;
+			}
+
+			bool GetDiagonalMovement() const {
+				return allowDiagonals;
+			}
+
+			//Uses a search state kept for the calling thread
 			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) override;
+
+			//Only reads the grid, so any number of these can run at once, each with its own state
+			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) const;
+
+			//A* and JPS searches stop and carry on between calls. Hierarchical ones are short enough to run in one go
+			PathSearchStatus StartPathSearch(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) override;
+			PathSearchStatus ContinuePathSearch(NavigationPath& outPath, PathSearchState& state, int maxNodes) override;
+
+			//False if the position is off the grid
+			bool WorldToGrid(const Vector3& pos, int& x, int& z) const;
+
+			int GetWidth() const {
+				return gridWidth;
+			}
+
+			int GetHeight() const {
+				return gridHeight;
+			}
+
+			int GetNodeSize() const {
+				return nodeSize;
+			}
+
+			const GridNode& GetNode(int index) const {
+				return allNodes[index];
+			}
+
+			bool IsWalkable(int x, int z) const {
+				return x >= 0 && x < gridWidth && z >= 0 && z < gridHeight && walkable[(z * gridWidth) + x];
+			}
+
+			int GetNodeIndex(const GridNode* n) const {
+				return (int)(n - allNodes);
+			}
+
+			/*
+			Dynamic obstacles (crates and the like) block every node their box
+			covers on X and Z, until they're moved off or removed. Obstacles
+			can overlap - a node only opens again once none of them cover it.
+
+			Searches on the workers read the nodes, so adding, moving and
+			removing obstacles only records the change - nothing is blocked
+			until ApplyPendingChanges, which must be called while no search is
+			running. A PathRequestQueue does that itself: it stops starting
+			searches while changes are waiting, and applies them once the
+			running ones are done. Without one, call it at a point in the frame
+			where nothing else is searching the grid.
+
+			Applying changes also repairs the jump table and hierarchy, for the
+			rows and clusters around the nodes that changed.
+			*/
+			int		AddObstacle(const Vector3& boxMin, const Vector3& boxMax);
+			//Only records anything if the box now covers different nodes, so is fine to call every frame
+			void	MoveObstacle(int obstacle, const Vector3& boxMin, const Vector3& boxMax);
+			void	RemoveObstacle(int obstacle);
+
+			bool	HasPendingChanges() const override {
+				return !changedObstacles.empty();
+			}
+			void	ApplyPendingChanges() override;
+
+			//Every node that changes between blocked and open is logged, so planners can repair their paths
+			uint64_t GetChangeCount() const {
+				return changeLogStart + changeLog.size();
+			}
+			//False if changes from that far back have already been dropped from the log
+			bool	GetChangesSince(uint64_t since, std::vector<int>& outNodes) const;
 				
 		protected:
-			bool		NodeInList(GridNode* n, std::vector<GridNode*>& list) const;
-			GridNode*	RemoveBestNode(std::vector<GridNode*>& list) const;
-			float		Heuristic(GridNode* hNode, GridNode* endNode) const;
+			friend class NavigationBaker;
+
+			void	LoadText(const std::string& filepath);
+			bool	LoadBaked();
+
+			//The four straight directions jump tables are kept for
+			enum JumpDirection {
+				JumpPosX, JumpNegX, JumpPosZ, JumpNegZ, MaxJumpDirections
+			};
+
+			/*
+			For each node and straight direction, how many nodes along the next
+			jump point is (positive), or how many walkable nodes there are before
+			a wall (zero or negative). verticalJumps is the 4-way version of the
+			Z directions, which also stop where a sideways jump would find something.
+			*/
+			struct JumpDistances {
+				int straight[MaxJumpDirections];
+				int vertical[2];
+			};
+
+			struct JumpContext;
+
+			//The nodes an obstacle covers, max inclusive - empty if it's off the grid
+			struct Obstacle {
+				int		minX;
+				int		minZ;
+				int		maxX;
+				int		maxZ;
+				bool	active;
+			};
+
+			void	ConnectNode(int x, int z);
+			void	GetObstacleNodes(const Vector3& boxMin, const Vector3& boxMax, Obstacle& o) const;
+			void	BlockNodes(const Obstacle& o, int change);
+			void	RepairSearchData(uint64_t firstChange);
+
+			void	BuildJumpRow(int z);
+			void	BuildJumpColumn(int x);
+			void	UpdateJumpTable(const std::vector<int>& changedNodes);
+
+			bool	AStarSearch(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const;
+			bool	JumpPointSearch(int startIndex, int endIndex, NavigationPath& outPath, PathSearchState& state) const;
+
+			//Both pick up a search from wherever its state left off, and close at most maxNodes more nodes
+			PathSearchStatus	AStarExpand(NavigationPath& outPath, PathSearchState& state, int maxNodes) const;
+			PathSearchStatus	JumpPointExpand(NavigationPath& outPath, PathSearchState& state, int maxNodes) const;
+			void				PushPath(int endIndex, NavigationPath& outPath, const PathSearchState& state) const;
+
+			void	AddJumpSuccessors(const JumpContext& c, int node, PathSearchState& state) const;
+			int		Jump(const JumpContext& c, int x, int z, int dx, int dz) const;
+			int		JumpStraight(const JumpContext& c, int x, int z, int dx, int dz) const;
+			int		JumpVertical4(const JumpContext& c, int x, int z, int dz) const;
+			int		JumpDiagonal(const JumpContext& c, int x, int z, int dx, int dz) const;
+			int		TableJumpStraight(const JumpContext& c, int fromX, int fromZ, int dx, int dz) const;
+			int		TableJumpVertical4(const JumpContext& c, int fromX, int fromZ, int dz) const;
+
+			bool	HasForcedNeighbour(int x, int z, int dx, int dz) const;
+			float	StepCost(int fromIndex, int toIndex) const;
+
+			float		Heuristic(int fromIndex, int toIndex) const;
 			int nodeSize;
 			int gridWidth;
 			int gridHeight;
 			
 			Vector3 gridOffset; // New
-			GridNode* allNodes;
+			GridNode* allNodes; //either owned, or part of bakedFile
+
+			MappedFile					bakedFile;
+
+			std::vector<char>			walkable;
+			std::vector<JumpDistances>	jumpTable;
+			GridHierarchy*				hierarchy;
+
+			std::vector<int>			blockedCounts; //how many obstacles cover each node
+			std::vector<Obstacle>		obstacles;			//the nodes each one blocks right now
+			std::vector<Obstacle>		wantedObstacles;	//and the nodes it will block once changes are applied
+			std::vector<int>			changedObstacles;
+			std::vector<int>			freeObstacles;
+			std::deque<int>				changeLog;
+			uint64_t					changeLogStart;
+
+			GridSearchMode	searchMode;
+			bool			allowDiagonals;
 		};
 	}
 }
-
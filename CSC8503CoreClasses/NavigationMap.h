@@ -1,8 +1,15 @@
 #pragma once
 #include "NavigationPath.h"
+#include "PathSearchState.h"
 namespace NCL {
 	using namespace NCL::Maths;
 	namespace CSC8503 {
+		enum class PathSearchStatus {
+			Searching,
+			Found,
+			NotFound
+		};
+
 		class NavigationMap
 		{
 		public:
@@ -10,6 +17,34 @@ namespace NCL {
 			~NavigationMap() {}
 
 			virtual bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) = 0;
+
+			/*
+			For spreading one search over several frames - StartPathSearch sets
+			the search up in state, then each ContinuePathSearch expands at most
+			maxNodes more nodes, until it comes back Found or NotFound. Maps that
+			can't stop partway just run the whole of FindPath in StartPathSearch,
+			which is what these do by default.
+			*/
+			virtual PathSearchStatus StartPathSearch(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) {
+				return FindPath(from, to, outPath) ? PathSearchStatus::Found : PathSearchStatus::NotFound;
+			}
+
+			virtual PathSearchStatus ContinuePathSearch(NavigationPath& outPath, PathSearchState& state, int maxNodes) {
+				return PathSearchStatus::NotFound;
+			}
+
+			/*
+			Maps that can change at runtime hold their changes back until
+			ApplyPendingChanges, so that searches running on other threads
+			don't see the map change partway through. It must only be called
+			while nothing is searching the map.
+			*/
+			virtual bool HasPendingChanges() const {
+				return false;
+			}
+
+			virtual void ApplyPendingChanges() {
+			}
 		};
 	}
 }
@@ -1,18 +1,79 @@
 #include "NavigationMesh.h"
+#include "NavigationData.h"
 #include "Assets.h"
 #include "Maths.h"
 #include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
 using namespace NCL;
 using namespace CSC8503;
 using namespace std;
 
+namespace {
+	/*
+	Twice the signed area of abc on the XZ plane - the funnel only needs the
+	sign, which says which side of a->b point c is on.
+	*/
+	float TriArea2(const Vector3& a, const Vector3& b, const Vector3& c) {
+		float abx = b.x - a.x;
+		float abz = b.z - a.z;
+		float acx = c.x - a.x;
+		float acz = c.z - a.z;
+		return (acx * abz) - (abx * acz);
+	}
+
+	bool SamePoint(const Vector3& a, const Vector3& b) {
+		return Vector::LengthSquared(a - b) < 0.000001f;
+	}
+
+	void GrowBounds(Vector3& minBounds, Vector3& maxBounds, const Vector3& p) {
+		for (int i = 0; i < 3; ++i) {
+			minBounds[i] = std::min(minBounds[i], p[i]);
+			maxBounds[i] = std::max(maxBounds[i], p[i]);
+		}
+	}
+}
+
 NavigationMesh::NavigationMesh()
 {
+	allTris			= nullptr;
+	allVerts		= nullptr;
+	triCount		= 0;
+	vertCount		= 0;
+	indexCellSize	= 1.0f;
+	indexWidth		= 0;
+	indexDepth		= 0;
+	cellStarts		= nullptr;
+	cellTris		= nullptr;
+}
+
+NavigationMesh::NavigationMesh(const std::string&filename) : NavigationMesh()
+{
+	std::string filepath = Assets::DATADIR + filename;
+
+	if (bakedFile.Open(filepath) && NavigationData::IsBaked(bakedFile.GetData(), bakedFile.GetSize())) {
+		if (!LoadBaked()) {
+			std::cout << __FUNCTION__ << " can't use baked mesh " << filepath << ", it needs baking again\n";
+			bakedFile.Close();
+		}
+		return;
+	}
+	bakedFile.Close();
+	LoadText(filepath);
+}
+
+NavigationMesh::NavigationMesh(const std::vector<Vector3>& verts, const std::vector<int>& indices, const std::vector<int>& neighbours) : NavigationMesh()
+{
+	SetMesh(verts, indices, neighbours);
 }
 
-NavigationMesh::NavigationMesh(const std::string&filename)
+NavigationMesh::~NavigationMesh()
 {
-	ifstream file(Assets::DATADIR + filename);
+}
+
+void NavigationMesh::LoadText(const std::string& filepath) {
+	ifstream file(filepath);
 
 	int numVertices = 0;
 	int numIndices	= 0;
@@ -20,77 +81,377 @@ NavigationMesh::NavigationMesh(const std::string&filename)
 	file >> numVertices;
 	file >> numIndices;
 
-	for (int i = 0; i < numVertices; ++i) {
-		Vector3 vert;
+	std::vector<Vector3>	verts(numVertices);
+	std::vector<int>		indices(numIndices);
+	std::vector<int>		neighbours((numIndices / 3) * 3);
+
+	for (Vector3& vert : verts) {
 		file >> vert.x;
 		file >> vert.y;
 		file >> vert.z;
-
-		allVerts.emplace_back(vert);
 	}
+	for (int& i : indices) {
+		file >> i;
+	}
+	for (int& n : neighbours) {
+		file >> n;
+	}
+	SetMesh(verts, indices, neighbours);
+}
+
+void NavigationMesh::SetMesh(const std::vector<Vector3>& verts, const std::vector<int>& indices, const std::vector<int>& neighbours) {
+	loadedVerts = verts;
+	loadedTris.resize(indices.size() / 3);
 
-	allTris.resize(numIndices / 3);
+	for (int i = 0; i < loadedTris.size(); ++i) {
+		NavTri* tri = &loadedTris[i];
+		for (int j = 0; j < 3; ++j) {
+			tri->indices[j]		= indices[(i * 3) + j];
+			tri->neighbours[j]	= neighbours[(i * 3) + j];
+		}
 
-	for (int i = 0; i < allTris.size(); ++i) {
-		NavTri* tri = &allTris[i];
-		file >> tri->indices[0];
-		file >> tri->indices[1];
-		file >> tri->indices[2];
+		tri->centroid = loadedVerts[tri->indices[0]] +
+			loadedVerts[tri->indices[1]] +
+			loadedVerts[tri->indices[2]];
 
-		tri->centroid = allVerts[tri->indices[0]] +
-			allVerts[tri->indices[1]] +
-			allVerts[tri->indices[2]];
+		tri->centroid = loadedTris[i].centroid / 3.0f;
 
-		tri->centroid = allTris[i].centroid / 3.0f;
+		tri->triPlane = Plane::PlaneFromTri(loadedVerts[tri->indices[0]],
+			loadedVerts[tri->indices[1]],
+			loadedVerts[tri->indices[2]]);
 
-		tri->triPlane = Plane::PlaneFromTri(allVerts[tri->indices[0]],
-			allVerts[tri->indices[1]],
-			allVerts[tri->indices[2]]);
+		tri->area = Maths::AreaofTri3D(loadedVerts[tri->indices[0]], loadedVerts[tri->indices[1]], loadedVerts[tri->indices[2]]);
+	}
+	allTris		= loadedTris.data();
+	allVerts	= loadedVerts.data();
+	triCount	= (int)loadedTris.size();
+	vertCount	= (int)loadedVerts.size();
 
-		tri->area = Maths::AreaofTri3D(allVerts[tri->indices[0]], allVerts[tri->indices[1]], allVerts[tri->indices[2]]);
+	BuildPortals();
+	BuildTriIndex();
+}
+
+//Everything, portals and tri grid included, is used straight out of the mapped file
+bool NavigationMesh::LoadBaked() {
+	using namespace NavigationData;
+	const char* data	= bakedFile.GetData();
+	size_t size			= bakedFile.GetSize();
+
+	if (size < sizeof(MeshHeader)) {
+		return false;
 	}
-	for (int i = 0; i < allTris.size(); ++i) {
-		NavTri* tri = &allTris[i];
-		for (int j = 0; j < 3; ++j) {
-			int index = 0;
-			file >> index;
-			if (index != -1) {
-				tri->neighbours[j] = &allTris[index];
+	const MeshHeader& header = *(const MeshHeader*)data;
+	if (header.file.version != Version || header.file.kind != (uint32_t)Kind::Mesh || header.triStride != sizeof(NavTri)) {
+		return false;
+	}
+	uint64_t cellCount = (uint64_t)header.indexWidth * header.indexDepth;
+	if (header.vertCount < 0 || header.triCount < 0 || header.indexWidth < 0 || header.indexDepth < 0 ||
+		!SectionFits(header.verts, size)		|| header.verts.size		!= (uint64_t)header.vertCount * sizeof(Vector3)	||
+		!SectionFits(header.tris, size)			|| header.tris.size			!= (uint64_t)header.triCount * sizeof(NavTri)	||
+		!SectionFits(header.cellStarts, size)	|| header.cellStarts.size	!= (cellCount + 1) * sizeof(int)				||
+		!SectionFits(header.cellTris, size)) {
+		return false;
+	}
+	const int* starts = (const int*)(data + header.cellStarts.offset);
+	if (header.cellTris.size != (uint64_t)starts[cellCount] * sizeof(int)) {
+		return false;
+	}
+	allVerts	= (const Vector3*)(data + header.verts.offset);
+	allTris		= (const NavTri*)(data + header.tris.offset);
+	vertCount	= header.vertCount;
+	triCount	= header.triCount;
+
+	indexOrigin		= Vector3(header.indexOrigin[0], header.indexOrigin[1], header.indexOrigin[2]);
+	indexCellSize	= header.indexCellSize;
+	indexWidth		= header.indexWidth;
+	indexDepth		= header.indexDepth;
+	cellStarts		= starts;
+	cellTris		= (const int*)(data + header.cellTris.offset);
+	return true;
+}
+
+//The neighbours in the file don't say which edge they're across, so that's worked out from the vertices they share
+void NavigationMesh::BuildPortals() {
+	for (NavTri& t : loadedTris) {
+		for (int i = 0; i < 3; ++i) {
+			if (t.neighbours[i] < 0) {
+				continue;
+			}
+			const NavTri* n = &allTris[t.neighbours[i]];
+			int shared = 0;
+			for (int j = 0; j < 3 && shared < 2; ++j) {
+				for (int k = 0; k < 3; ++k) {
+					if (t.indices[j] == n->indices[k] || SamePoint(allVerts[t.indices[j]], allVerts[n->indices[k]])) {
+						t.portals[i][shared++] = t.indices[j];
+						break;
+					}
+				}
+			}
+			if (shared < 2) {
+				t.neighbours[i] = -1; //they only touch at a corner, so can't be walked between
 			}
 		}
 	}
 }
 
-NavigationMesh::~NavigationMesh()
-{
+/*
+Triangles are bucketed by their bounds into a grid over the XZ plane, with
+cells about the size of a triangle on average, so looking a point up only
+has to test the few triangles in its cell.
+*/
+void NavigationMesh::BuildTriIndex() {
+	if (triCount == 0) {
+		return;
+	}
+	Vector3 minBounds = allVerts[allTris[0].indices[0]];
+	Vector3 maxBounds = minBounds;
+	for (const NavTri& t : loadedTris) {
+		for (int i = 0; i < 3; ++i) {
+			GrowBounds(minBounds, maxBounds, allVerts[t.indices[i]]);
+		}
+	}
+	float sizeX = std::max(maxBounds.x - minBounds.x, 0.001f);
+	float sizeZ = std::max(maxBounds.z - minBounds.z, 0.001f);
+
+	const int maxCellsPerSide = 512;
+	indexCellSize	= std::sqrt((sizeX * sizeZ) / triCount);
+	indexCellSize	= std::max({ indexCellSize, sizeX / maxCellsPerSide, sizeZ / maxCellsPerSide });
+	indexOrigin		= minBounds;
+	indexWidth		= std::max((int)std::ceil(sizeX / indexCellSize), 1);
+	indexDepth		= std::max((int)std::ceil(sizeZ / indexCellSize), 1);
+
+	auto cellRange = [&](const NavTri& t, int& minX, int& minZ, int& maxX, int& maxZ) {
+		Vector3 triMin = allVerts[t.indices[0]];
+		Vector3 triMax = triMin;
+		for (int i = 1; i < 3; ++i) {
+			GrowBounds(triMin, triMax, allVerts[t.indices[i]]);
+		}
+		minX = std::clamp((int)((triMin.x - indexOrigin.x) / indexCellSize), 0, indexWidth - 1);
+		minZ = std::clamp((int)((triMin.z - indexOrigin.z) / indexCellSize), 0, indexDepth - 1);
+		maxX = std::clamp((int)((triMax.x - indexOrigin.x) / indexCellSize), 0, indexWidth - 1);
+		maxZ = std::clamp((int)((triMax.z - indexOrigin.z) / indexCellSize), 0, indexDepth - 1);
+	};
+
+	//count, then fill - every cell's triangles end up next to each other in cellTris
+	loadedCellStarts.assign((indexWidth * indexDepth) + 1, 0);
+	for (const NavTri& t : loadedTris) {
+		int minX, minZ, maxX, maxZ;
+		cellRange(t, minX, minZ, maxX, maxZ);
+		for (int z = minZ; z <= maxZ; ++z) {
+			for (int x = minX; x <= maxX; ++x) {
+				loadedCellStarts[(z * indexWidth) + x + 1]++;
+			}
+		}
+	}
+	for (int i = 0; i < indexWidth * indexDepth; ++i) {
+		loadedCellStarts[i + 1] += loadedCellStarts[i];
+	}
+	loadedCellTris.resize(loadedCellStarts.back());
+	std::vector<int> fill(loadedCellStarts.begin(), loadedCellStarts.end() - 1);
+	for (const NavTri& t : loadedTris) {
+		int minX, minZ, maxX, maxZ;
+		cellRange(t, minX, minZ, maxX, maxZ);
+		for (int z = minZ; z <= maxZ; ++z) {
+			for (int x = minX; x <= maxX; ++x) {
+				loadedCellTris[fill[(z * indexWidth) + x]++] = GetTriIndex(&t);
+			}
+		}
+	}
+	cellStarts	= loadedCellStarts.data();
+	cellTris	= loadedCellTris.data();
 }
 
 bool NavigationMesh::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) {
+	static thread_local PathSearchState state;
+	return FindPath(from, to, outPath, state);
+}
+
+bool NavigationMesh::FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) const {
 	const NavTri* start	= GetTriForPosition(from);
 	const NavTri* end	= GetTriForPosition(to);
 
+	if (!start || !end) {
+		return false; //off the mesh!
+	}
+	int startIndex	= GetTriIndex(start);
+	int endIndex	= GetTriIndex(end);
+
+	state.Begin(triCount);
+	state.Open(startIndex, 0.0f, Vector::Length(end->centroid - start->centroid), PathSearchState::NoNode);
+
+	while (state.HasOpenNodes()) {
+		int current = state.PopBest();
+
+		if (current == endIndex) {
+			std::vector<int> corridor;
+			for (int node = endIndex; node != PathSearchState::NoNode; node = state.GetParent(node)) {
+				corridor.push_back(node);
+			}
+			std::reverse(corridor.begin(), corridor.end());
+			StringPull(from, to, corridor, outPath);
+			return true;
+		}
+		const NavTri& t = allTris[current];
+
+		for (int i = 0; i < 3; ++i) {
+			int neighbourIndex = t.neighbours[i];
+			if (neighbourIndex < 0 || state.IsClosed(neighbourIndex)) {
+				continue;
+			}
+			const NavTri* n = &allTris[neighbourIndex];
+			float g = state.GetCost(current) + Vector::Length(n->centroid - t.centroid);
+			state.Open(neighbourIndex, g, Vector::Length(end->centroid - n->centroid), current);
+		}
+	}
 	return false;
 }
 
 /*
-If you have triangles on top of triangles in a full 3D environment, you'll need to change this slightly,
-as it is currently ignoring height. You might find tri/plane raycasting is handy.
+The 'simple stupid funnel' - the funnel is the wedge from the last corner
+of the path (the apex) out to the edges of the edge being looked at, and
+each edge along the corridor narrows it. When a side would have to cross
+over the other to fit through an edge, the path must bend around that
+corner, so it becomes a waypoint and the new apex, and the scan carries on
+from there.
 */
+void NavigationMesh::StringPull(const Vector3& from, const Vector3& to, const std::vector<int>& corridor, NavigationPath& outPath) const {
+	//the edges crossed, as left and right points going along the path, with the start and end as zero width ones
+	std::vector<Vector3> lefts;
+	std::vector<Vector3> rights;
 
-const NavigationMesh::NavTri* NavigationMesh::GetTriForPosition(const Vector3& pos) const {
-	for (const NavTri& t : allTris) {
-		Vector3 planePoint = t.triPlane.ProjectPointOntoPlane(pos);
+	lefts.push_back(from);
+	rights.push_back(from);
+	for (size_t i = 0; i + 1 < corridor.size(); ++i) {
+		const NavTri& t	= allTris[corridor[i]];
+		int next		= corridor[i + 1];
 
-		float ta = Maths::AreaofTri3D(allVerts[t.indices[0]], allVerts[t.indices[1]], planePoint);
-		float tb = Maths::AreaofTri3D(allVerts[t.indices[1]], allVerts[t.indices[2]], planePoint);
-		float tc = Maths::AreaofTri3D(allVerts[t.indices[2]], allVerts[t.indices[0]], planePoint);
+		for (int j = 0; j < 3; ++j) {
+			if (t.neighbours[j] != next) {
+				continue;
+			}
+			const Vector3& a = allVerts[t.portals[j][0]];
+			const Vector3& b = allVerts[t.portals[j][1]];
+			if (TriArea2(t.centroid, a, b) < 0.0f) {
+				lefts.push_back(b);
+				rights.push_back(a);
+			}
+			else {
+				lefts.push_back(a);
+				rights.push_back(b);
+			}
+			break;
+		}
+	}
+	lefts.push_back(to);
+	rights.push_back(to);
 
-		float areaSum = ta + tb + tc;
+	std::vector<Vector3> points;
+	points.push_back(from);
 
-		if (abs(areaSum - t.area)  > 0.001f) { //floating points are annoying! Are we more or less inside the triangle?
+	Vector3 apex		= from;
+	Vector3 funnelLeft	= from;
+	Vector3 funnelRight	= from;
+	int apexIndex	= 0;
+	int leftIndex	= 0;
+	int rightIndex	= 0;
+
+	for (int i = 1; i < (int)lefts.size(); ++i) {
+		const Vector3& left		= lefts[i];
+		const Vector3& right	= rights[i];
+
+		if (TriArea2(apex, funnelRight, right) <= 0.0f) {
+			if (SamePoint(apex, funnelRight) || TriArea2(apex, funnelLeft, right) > 0.0f) {
+				funnelRight	= right; //narrows the funnel
+				rightIndex	= i;
+			}
+			else { //right crosses over left, so the path goes round the left corner
+				apex		= funnelLeft;
+				apexIndex	= leftIndex;
+				if (!SamePoint(points.back(), apex)) {
+					points.push_back(apex);
+				}
+
+				funnelLeft	= apex;
+				funnelRight	= apex;
+				leftIndex	= apexIndex;
+				rightIndex	= apexIndex;
+				i			= apexIndex;
+				continue;
+			}
+		}
+		if (TriArea2(apex, funnelLeft, left) >= 0.0f) {
+			if (SamePoint(apex, funnelLeft) || TriArea2(apex, funnelRight, left) < 0.0f) {
+				funnelLeft	= left;
+				leftIndex	= i;
+			}
+			else {
+				apex		= funnelRight;
+				apexIndex	= rightIndex;
+				if (!SamePoint(points.back(), apex)) {
+					points.push_back(apex);
+				}
+
+				funnelLeft	= apex;
+				funnelRight	= apex;
+				leftIndex	= apexIndex;
+				rightIndex	= apexIndex;
+				i			= apexIndex;
+				continue;
+			}
+		}
+	}
+	if (!SamePoint(points.back(), to)) {
+		points.push_back(to);
+	}
+	for (int i = (int)points.size() - 1; i >= 0; --i) {
+		outPath.PushWaypoint(points[i]);
+	}
+}
+
+/*
+Tests the triangles in the point's cell on the XZ plane. If the point is
+over more than one (a walkway over a floor, say), it's on the one closest
+to it in height.
+*/
+const NavigationMesh::NavTri* NavigationMesh::GetTriForPosition(const Vector3& pos) const {
+	if (!cellStarts) {
+		return nullptr; //nothing loaded
+	}
+	float cellX = (pos.x - indexOrigin.x) / indexCellSize;
+	float cellZ = (pos.z - indexOrigin.z) / indexCellSize;
+	if (cellX < 0.0f || cellX > indexWidth || cellZ < 0.0f || cellZ > indexDepth) {
+		return nullptr;
+	}
+	//a point right on the far edge of the bounds is in the last cell, not one past it
+	int x = std::min((int)cellX, indexWidth - 1);
+	int z = std::min((int)cellZ, indexDepth - 1);
+	const NavTri*	best		= nullptr;
+	float			bestHeight	= 0.0f;
+
+	int cell = (z * indexWidth) + x;
+	for (int i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i) {
+		const NavTri& t = allTris[cellTris[i]];
+		const Vector3& a = allVerts[t.indices[0]];
+		const Vector3& b = allVerts[t.indices[1]];
+		const Vector3& c = allVerts[t.indices[2]];
+
+		float area = TriArea2(a, b, c);
+		if (std::abs(area) < 0.000001f) {
+			continue; //on its edge when seen from above, so can't be stood on
+		}
+		//barycentric coordinates on the XZ plane, with a little slack so points on shared edges aren't missed
+		float u = TriArea2(b, c, pos) / area;
+		float v = TriArea2(c, a, pos) / area;
+		float w = 1.0f - u - v;
+		const float tolerance = -0.0001f;
+		if (u < tolerance || v < tolerance || w < tolerance) {
 			continue;
 		}
-		return &t;
+		float height = std::abs((a.y * u) + (b.y * v) + (c.y * w) - pos.y);
+		if (!best || height < bestHeight) {
+			best		= &t;
+			bestHeight	= height;
+		}
 	}
-	return nullptr;
-}
\ No newline at end of file
+	return best;
+}
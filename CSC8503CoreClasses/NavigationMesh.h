@@ -1,43 +1,106 @@
 #pragma once
 #include "NavigationMap.h"
+#include "PathSearchState.h"
+#include "MappedFile.h"
 #include "Plane.h"
 #include <string>
 #include <vector>
 namespace NCL {
 	namespace CSC8503 {
+		/*
+		Paths are found with A* over the triangles, moving between the
+		centroids of neighbouring triangles, and then pulled tight through
+		the edges they cross (the 'funnel' algorithm), so the waypoints end
+		up only at the corners the path actually has to go around.
+
+		Finding the triangle under a point goes through a grid over the mesh
+		on the XZ plane, rather than testing every triangle. Where triangles
+		overlap on different floors, the one nearest in height to the point
+		is used.
+
+		Meshes baked by NavigationBaker are mapped, and used straight from
+		the file - the portals and the grid are baked along with them.
+		*/
 		class NavigationMesh : public NavigationMap	{
 		public:
 			NavigationMesh();
+			//Loads either the text format, or a baked file
 			NavigationMesh(const std::string&filename);
+			//The same data as the text format - as made by NavMeshBuilder, say
+			NavigationMesh(const std::vector<Vector3>& verts, const std::vector<int>& indices, const std::vector<int>& neighbours);
 			~NavigationMesh();
 
+			//Uses a search state kept for the calling thread
 			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath) override;
+
+			//Only reads the mesh, so any number of these can run at once, each with its own state
+			bool FindPath(const Vector3& from, const Vector3& to, NavigationPath& outPath, PathSearchState& state) const;
 		
 		protected:
+			friend class NavigationBaker;
+
+			//Triangle indices (or -1) rather than pointers, so baked meshes can be used straight from the file
 			struct NavTri {
 				Plane   triPlane;
 				Vector3 centroid;
 				float	area;
-				NavTri* neighbours[3];
+				int		neighbours[3];
 
 				int indices[3];
+				//for each neighbour, the two vertices of the edge shared with it
+				int portals[3][2];
 
 				NavTri() {
 					area = 0.0f;
-					neighbours[0] = nullptr;
-					neighbours[1] = nullptr;
-					neighbours[2] = nullptr;
+					neighbours[0] = -1;
+					neighbours[1] = -1;
+					neighbours[2] = -1;
 
 					indices[0] = -1;
 					indices[1] = -1;
 					indices[2] = -1;
+
+					for (int i = 0; i < 3; ++i) {
+						portals[i][0] = -1;
+						portals[i][1] = -1;
+					}
 				}
 			};
 
 			const NavTri* GetTriForPosition(const Vector3& pos) const;
 
-			std::vector<NavTri>		allTris;
-			std::vector<Vector3>	allVerts;
+			void	LoadText(const std::string& filepath);
+			void	SetMesh(const std::vector<Vector3>& verts, const std::vector<int>& indices, const std::vector<int>& neighbours);
+			bool	LoadBaked();
+
+			void	BuildPortals();
+			void	BuildTriIndex();
+			void	StringPull(const Vector3& from, const Vector3& to, const std::vector<int>& corridor, NavigationPath& outPath) const;
+
+			int GetTriIndex(const NavTri* t) const {
+				return (int)(t - allTris);
+			}
+
+			//These point into either the loaded vectors below, or the baked file
+			const NavTri*	allTris;
+			const Vector3*	allVerts;
+			int				triCount;
+			int				vertCount;
+
+			//Each cell of the grid lists the triangles whose bounds overlap it, as a range of cellTris
+			Vector3			indexOrigin;
+			float			indexCellSize;
+			int				indexWidth;
+			int				indexDepth;
+			const int*		cellStarts;
+			const int*		cellTris;
+
+			std::vector<NavTri>		loadedTris;
+			std::vector<Vector3>	loadedVerts;
+			std::vector<int>		loadedCellStarts;
+			std::vector<int>		loadedCellTris;
+
+			MappedFile				bakedFile;
 		};
 	}
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ namespace NCL {
 			void	Clear() {
 				waypoints.clear();
 			}
+			bool	IsEmpty() const {
+				return waypoints.empty();
+			}
 			void	PushWaypoint(const Vector3& wp) {
 				waypoints.emplace_back(wp);
 			}
@@ -22,13 +22,13 @@ bool NetworkObject::ReadPacket(GamePacket& p) {
 	return false; //this isn't a packet we care about!
 }
 
-bool NetworkObject::WritePacket(GamePacket** p, bool deltaFrame, int stateID) {
+bool NetworkObject::WritePacket(GamePacket** p, bool deltaFrame, int stateID, FrameArena& arena) {
 	if (deltaFrame) {
-		if (!WriteDeltaPacket(p, stateID)) {
-			return WriteFullPacket(p);
+		if (!WriteDeltaPacket(p, stateID, arena)) {
+			return WriteFullPacket(p, arena);
 		}
 	}
-	return WriteFullPacket(p);
+	return WriteFullPacket(p, arena);
 }
 
 //Client objects recieve these packets
@@ -68,12 +68,12 @@ bool NetworkObject::ReadFullPacket(FullPacket &p) {
 	return true;
 }
 
-bool NetworkObject::WriteDeltaPacket(GamePacket**p, int stateID) {
-	DeltaPacket* dp = new DeltaPacket();
+bool NetworkObject::WriteDeltaPacket(GamePacket**p, int stateID, FrameArena& arena) {
 	NetworkState state;
 	if (!GetNetworkState(stateID, state)) {
 		return false; // can t delta !
 	}
+	DeltaPacket* dp = arena.New<DeltaPacket>();
 	
 	dp -> fullID = stateID;
 	dp -> objectID = networkID;
@@ -96,8 +96,8 @@ bool NetworkObject::WriteDeltaPacket(GamePacket**p, int stateID) {
 	return true;
 }
 
-bool NetworkObject::WriteFullPacket(GamePacket**p) {
-	FullPacket* fp = new FullPacket();
+bool NetworkObject::WriteFullPacket(GamePacket**p, FrameArena& arena) {
+	FullPacket* fp = arena.New<FullPacket>();
 	
 	fp -> objectID = networkID;
 	fp -> fullState.position = object.GetTransform().GetPosition();
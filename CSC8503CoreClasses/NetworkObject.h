@@ -2,6 +2,7 @@
 #include "GameObject.h"
 #include "NetworkBase.h"
 #include "NetworkState.h"
+#include "FrameArena.h"
 
 namespace NCL::CSC8503 {
 	class GameObject;
@@ -71,8 +72,8 @@ namespace NCL::CSC8503 {
 
 		//Called by clients
 		virtual bool ReadPacket(GamePacket& p);
-		//Called by servers
-		virtual bool WritePacket(GamePacket** p, bool deltaFrame, int stateID);
+		//Called by servers - the packet is allocated from the arena, and is gone once it is reset
+		virtual bool WritePacket(GamePacket** p, bool deltaFrame, int stateID, FrameArena& arena);
 
 		void UpdateStateHistory(int minID);
 		int GetNetworkID() { return networkID; }
@@ -85,8 +86,8 @@ namespace NCL::CSC8503 {
 		virtual bool ReadDeltaPacket(DeltaPacket &p);
 		virtual bool ReadFullPacket(FullPacket &p);
 
-		virtual bool WriteDeltaPacket(GamePacket**p, int stateID);
-		virtual bool WriteFullPacket(GamePacket**p);
+		virtual bool WriteDeltaPacket(GamePacket**p, int stateID, FrameArena& arena);
+		virtual bool WriteFullPacket(GamePacket**p, FrameArena& arena);
 
 		GameObject& object;
 
@@ -5,7 +5,4 @@ using namespace CSC8503;
 
 NetworkState::NetworkState()	{
 	stateID = 0;
-}
-
-NetworkState::~NetworkState()	{
 }
\ No newline at end of file
@@ -4,10 +4,11 @@ namespace NCL {
 	using namespace Maths;
 	namespace CSC8503 {
 		class GameObject;
+		//Sent as raw bytes inside packets, so this must stay free of virtuals
 		class NetworkState	{
 		public:
 			NetworkState();
-			virtual ~NetworkState();
+			~NetworkState() = default;
 
 			Vector3		position;
 			Quaternion	orientation;
@@ -2,7 +2,7 @@
 #include "CollisionVolume.h"
 
 namespace NCL {
-	class OBBVolume : public CollisionVolume
+	class OBBVolume : public CollisionVolume, public PoolAllocated<OBBVolume>
 	{
 	public:
 		OBBVolume(const Maths::Vector3& halfDims) 
@@ -13,6 +13,8 @@ namespace NCL {
 
 			void UpdateConstraint(float dt) override;
 
+			bool Uses(const GameObject* o) const override { return o == objectA || o == objectB; }
+
 		protected:
 			GameObject* objectA;
 			GameObject* objectB;
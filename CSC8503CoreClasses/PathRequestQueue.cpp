@@ -0,0 +1,295 @@
+#include "PathRequestQueue.h"
+#include "GameTimer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+using namespace NCL;
+using namespace CSC8503;
+
+//TimeSliced searches check the frame's time budget after every this many nodes
+const int NODES_PER_SLICE = 256;
+
+PathRequestQueue::PathRequestQueue(NavigationMap& map, PathRequestMode mode) : map(map) {
+	this->mode		= mode;
+	mergeSize		= 0.0f;
+	maxConcurrent	= 16;
+	nodesPerUpdate	= 8192;
+	running			= 0;
+	nextTicket		= 1;
+}
+
+PathRequestQueue::~PathRequestQueue() {
+	WaitIdle(); //searches still running hold pointers into this queue
+
+	for (auto& i : unfinished) {
+		delete i.second;
+	}
+}
+
+PathTicket PathRequestQueue::Submit(const Vector3& from, const Vector3& to, PathCallback callback) {
+	PathTicket ticket = nextTicket++;
+	if (nextTicket == InvalidPathTicket) {
+		nextTicket = 1;
+	}
+	SearchKey key = MakeKey(from, to);
+
+	Search* s = nullptr;
+	auto existing = unfinished.find(key);
+	if (existing != unfinished.end()) {
+		s = existing->second;
+	}
+	else {
+		s = new Search();
+		s->from		= from;
+		s->to		= to;
+		s->key		= key;
+		s->found	= false;
+		s->started	= false;
+		unfinished.insert({ key, s });
+		queued.push_back(s);
+	}
+	s->tickets.push_back(ticket);
+
+	Request& r = requests[ticket];
+	r.search	= s;
+	r.callback	= std::move(callback);
+	r.status	= PathRequestStatus::Pending;
+
+	return ticket;
+}
+
+void PathRequestQueue::Cancel(PathTicket ticket) {
+	auto i = requests.find(ticket);
+	if (i == requests.end()) {
+		return;
+	}
+	Search* s = i->second.search;
+	requests.erase(i);
+	if (!s) {
+		return;
+	}
+	s->tickets.erase(std::remove(s->tickets.begin(), s->tickets.end(), ticket), s->tickets.end());
+
+	if (!s->tickets.empty()) {
+		return;
+	}
+	//one running on a worker is left to finish, and its result dropped - a TimeSliced one is still in the queue, so can just stop
+	auto q = std::find(queued.begin(), queued.end(), s);
+	if (q != queued.end()) {
+		queued.erase(q);
+		unfinished.erase(s->key);
+		delete s;
+	}
+}
+
+PathRequestStatus PathRequestQueue::GetStatus(PathTicket ticket) const {
+	auto i = requests.find(ticket);
+	if (i == requests.end()) {
+		return PathRequestStatus::Unknown;
+	}
+	return i->second.status;
+}
+
+bool PathRequestQueue::TakeResult(PathTicket ticket, NavigationPath& outPath, bool& found) {
+	auto i = requests.find(ticket);
+	if (i == requests.end() || i->second.status == PathRequestStatus::Pending) {
+		return false;
+	}
+	found	= (i->second.status == PathRequestStatus::Found);
+	outPath	= std::move(i->second.path);
+	requests.erase(i);
+	return true;
+}
+
+void PathRequestQueue::Update(float budgetMS) {
+	HandOutFinished();
+
+	if (UsingWorkers()) {
+		if (ApplyMapChanges()) {
+			StartQueued();
+		}
+	}
+	else {
+		ApplyMapChanges();
+		RunSliced(budgetMS, nodesPerUpdate);
+	}
+}
+
+void PathRequestQueue::WaitIdle() {
+	JobSystem::Get().Wait(searchJobs);
+}
+
+void PathRequestQueue::Flush() {
+	//callbacks can submit more requests, so keep going until there's nothing left at all
+	while (!queued.empty() || running > 0) {
+		if (UsingWorkers()) {
+			if (ApplyMapChanges()) {
+				StartQueued();
+			}
+			WaitIdle();
+		}
+		else {
+			ApplyMapChanges();
+			RunSliced(FLT_MAX, INT_MAX);
+		}
+		HandOutFinished();
+	}
+}
+
+bool PathRequestQueue::UsingWorkers() const {
+	return mode == PathRequestMode::Workers && JobSystem::Get().GetWorkerCount() > 0;
+}
+
+void PathRequestQueue::HandOutFinished() {
+	std::vector<Search*> done;
+	{
+		std::lock_guard<std::mutex> guard(finishedLock);
+		done.swap(finished);
+	}
+	for (Search* s : done) {
+		running--;
+		FinishSearch(s);
+	}
+}
+
+/*
+The map can only change while nothing is searching it, so this does
+nothing while searches are still out on the workers, or a TimeSliced one
+is part way through, and returns false so no more get started. Restarting
+the sliced search instead would never let a long one finish if something
+moves every frame.
+*/
+bool PathRequestQueue::ApplyMapChanges() {
+	if (!map.HasPendingChanges()) {
+		return true;
+	}
+	if (running > 0 || (!queued.empty() && queued.front()->started)) {
+		return false;
+	}
+	map.ApplyPendingChanges();
+	return true;
+}
+
+void PathRequestQueue::StartQueued() {
+	while (!queued.empty() && running < maxConcurrent) {
+		Search* s = queued.front();
+		queued.pop_front();
+		StartSearch(s);
+	}
+}
+
+/*
+The search at the front of the queue is the only one that can be part
+done - it stays there, its progress kept in sliceState, until it either
+finds a path or runs out of nodes to try.
+*/
+void PathRequestQueue::RunSliced(float budgetMS, int maxNodes) {
+	GameTimer timer;
+	int nodesLeft = maxNodes;
+
+	while (!queued.empty()) {
+		Search* s = queued.front();
+
+		PathSearchStatus status = PathSearchStatus::Searching;
+		if (!s->started) {
+			ApplyMapChanges(); //the last search just finished, so this is the chance
+			s->started	= true;
+			status		= map.StartPathSearch(s->from, s->to, s->path, sliceState);
+		}
+		if (status == PathSearchStatus::Searching) {
+			int expandedBefore = sliceState.GetExpandedCount();
+			status = map.ContinuePathSearch(s->path, sliceState, std::min(nodesLeft, NODES_PER_SLICE));
+			nodesLeft -= std::max(sliceState.GetExpandedCount() - expandedBefore, 1);
+		}
+		if (status != PathSearchStatus::Searching) {
+			queued.pop_front();
+			s->found = (status == PathSearchStatus::Found);
+			FinishSearch(s);
+		}
+		if (nodesLeft <= 0 || timer.GetTotalTimeMSec() >= budgetMS) {
+			break; //the rest can wait for next frame
+		}
+	}
+}
+
+void PathRequestQueue::StartSearch(Search* s) {
+	s->started = true;
+	running++;
+
+	JobSystem::Get().Run([this, s]() {
+		s->found = map.FindPath(s->from, s->to, s->path);
+
+		std::lock_guard<std::mutex> guard(finishedLock);
+		finished.push_back(s);
+	}, &searchJobs);
+}
+
+/*
+Callbacks can submit or cancel requests of their own, so each ticket is
+dealt with completely before its callback is called, and the search is
+no longer one new requests can join.
+*/
+void PathRequestQueue::FinishSearch(Search* s) {
+	unfinished.erase(s->key);
+
+	std::vector<PathTicket> tickets;
+	tickets.swap(s->tickets);
+
+	PathRequestStatus status = s->found ? PathRequestStatus::Found : PathRequestStatus::NotFound;
+
+	for (PathTicket ticket : tickets) {
+		auto i = requests.find(ticket);
+		if (i == requests.end()) {
+			continue; //cancelled by an earlier callback
+		}
+		Request& r = i->second;
+		if (!r.callback) {
+			r.search	= nullptr;
+			r.status	= status;
+			r.path		= s->path;
+			continue;
+		}
+		PathCallback callback = std::move(r.callback);
+		requests.erase(i);
+		callback(ticket, s->found, s->path);
+	}
+	delete s;
+}
+
+PathRequestQueue::SearchKey PathRequestQueue::MakeKey(const Vector3& from, const Vector3& to) const {
+	const float positions[6] = { from.x, from.y, from.z, to.x, to.y, to.z };
+
+	SearchKey key;
+	for (int i = 0; i < 6; ++i) {
+		if (mergeSize > 0.0f) {
+			key.values[i] = (int32_t)std::floor(positions[i] / mergeSize);
+		}
+		else {
+			float p = positions[i] + 0.0f; //so -0 and 0 match
+			std::memcpy(&key.values[i], &p, sizeof(float));
+		}
+	}
+	return key;
+}
+
+bool PathRequestQueue::SearchKey::operator==(const SearchKey& other) const {
+	for (int i = 0; i < 6; ++i) {
+		if (values[i] != other.values[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t PathRequestQueue::SearchKeyHash::operator()(const SearchKey& k) const {
+	uint64_t hash = 14695981039346656037ull; //FNV-1a, over the six values
+	for (int i = 0; i < 6; ++i) {
+		hash ^= (uint32_t)k.values[i];
+		hash *= 1099511628211ull;
+	}
+	return (size_t)hash;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "NavigationMap.h"
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		typedef uint32_t PathTicket;
+
+		const PathTicket InvalidPathTicket = 0;
+
+		enum class PathRequestStatus {
+			Unknown,	//never issued, cancelled, or its result has already been taken
+			Pending,
+			Found,
+			NotFound
+		};
+
+		enum class PathRequestMode {
+			Workers,	//searches run as jobs, alongside everything else
+			TimeSliced	//searches run inside Update, a few nodes at a time, carrying on next frame where they stopped
+		};
+
+		typedef std::function<void(PathTicket ticket, bool found, const NavigationPath& path)> PathCallback;
+
+		/*
+		Lets AI ask for paths without waiting on them - Submit hands back a
+		ticket straight away, and the search happens later, either on the job
+		system's workers or in small slices of each frame on the thread that
+		calls Update. A burst of agents all repathing at once then costs a
+		little each frame, rather than one long frame.
+
+		Results come back either through the callback given to Submit, which
+		is called from Update, or by polling GetStatus and then TakeResult.
+
+		Requests for the same start and end as a search that hasn't finished
+		yet just wait on that search, rather than starting their own - set
+		the merge size to the map's node size, and every request from the
+		same node to the same node shares one search.
+
+		In Workers mode, the map's FindPath must be safe to call from several
+		threads at once - NavigationGrid's is. With no job system workers,
+		that falls back to TimeSliced. Apart from the searches themselves,
+		everything happens on the thread calling Update, so submitting,
+		cancelling and polling should happen there too.
+
+		Changes to the map (NavigationGrid's obstacles) are applied by Update,
+		once no searches are running - while any are waiting, no new searches
+		are started, so the running ones drain away first. A TimeSliced search
+		part way through finishes on the map it started on.
+
+		TimeSliced mode works through one search at a time, using the map's
+		StartPathSearch / ContinuePathSearch, so even a single long search is
+		split across frames. Maps that can't pause a search run it whole.
+		*/
+		class PathRequestQueue {
+		public:
+			PathRequestQueue(NavigationMap& map, PathRequestMode mode = PathRequestMode::Workers);
+			~PathRequestQueue();
+
+			PathRequestQueue(const PathRequestQueue&) = delete;
+			PathRequestQueue& operator=(const PathRequestQueue&) = delete;
+
+			PathTicket Submit(const Vector3& from, const Vector3& to, PathCallback callback = nullptr);
+
+			//The callback won't be called, and the search is dropped if nothing else is waiting on it
+			void Cancel(PathTicket ticket);
+
+			PathRequestStatus GetStatus(PathTicket ticket) const;
+
+			//Once a request has finished, copies out its path and forgets the ticket. False if it isn't finished
+			bool TakeResult(PathTicket ticket, NavigationPath& outPath, bool& found);
+
+			/*
+			Call once a frame. Hands out finished results, applies any waiting
+			map changes if it can, and starts (or in TimeSliced mode, runs)
+			queued searches. budgetMS only applies to
+			TimeSliced mode, which stops at whichever comes first of budgetMS
+			and the nodes per update, but always expands at least one slice of
+			nodes, so the queue keeps moving.
+			*/
+			void Update(float budgetMS);
+
+			/*
+			Blocks until no search is running on the workers, so nothing is
+			reading the map - the point to change it at. Results that came in
+			are handed out by the next Update as usual.
+			*/
+			void WaitIdle();
+
+			//Runs every queued search to the end and hands out all of the results, callbacks and all
+			void Flush();
+
+			//Positions within the same cube of this size count as the same for merging requests - 0 only merges exact matches
+			void SetMergeSize(float size) {
+				mergeSize = size;
+			}
+
+			//The most searches handed to the workers at any one time
+			void SetMaxConcurrentSearches(int count) {
+				maxConcurrent = count > 0 ? count : 1;
+			}
+
+			//The most nodes a TimeSliced Update expands, across all of its searches
+			void SetNodesPerUpdate(int count) {
+				nodesPerUpdate = count > 0 ? count : 1;
+			}
+
+			int GetQueuedCount() const {
+				return (int)queued.size();
+			}
+
+			int GetRunningCount() const {
+				return running;
+			}
+
+		protected:
+			struct SearchKey {
+				int32_t values[6];
+
+				bool operator==(const SearchKey& other) const;
+			};
+
+			struct SearchKeyHash {
+				size_t operator()(const SearchKey& k) const;
+			};
+
+			//One actual search, shared by every ticket waiting on it
+			struct Search {
+				Vector3		from;
+				Vector3		to;
+				SearchKey	key;
+
+				std::vector<PathTicket>	tickets;
+
+				NavigationPath	path;
+				bool			found;
+				bool			started;
+			};
+
+			struct Request {
+				Search*				search; //null once it's finished
+				PathCallback		callback;
+				PathRequestStatus	status;
+				NavigationPath		path;
+			};
+
+			SearchKey	MakeKey(const Vector3& from, const Vector3& to) const;
+			bool		UsingWorkers() const;
+			void		HandOutFinished();
+			bool		ApplyMapChanges();
+			void		StartQueued();
+			void		RunSliced(float budgetMS, int maxNodes);
+			void		StartSearch(Search* s);
+			void		FinishSearch(Search* s);
+
+			NavigationMap&	map;
+			PathRequestMode	mode;
+			float			mergeSize;
+			int				maxConcurrent;
+			int				nodesPerUpdate;
+			int				running;
+			PathTicket		nextTicket;
+
+			//TimeSliced mode only ever has the search at the front of the queue part done, so it gets this state
+			PathSearchState	sliceState;
+
+			std::unordered_map<PathTicket, Request>					requests;
+			std::unordered_map<SearchKey, Search*, SearchKeyHash>	unfinished;
+			std::deque<Search*>										queued;
+
+			//Filled in by the workers, emptied by Update
+			std::mutex				finishedLock;
+			std::vector<Search*>	finished;
+			JobCounter				searchJobs;
+		};
+	}
+}
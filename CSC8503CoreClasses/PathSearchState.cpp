@@ -0,0 +1,116 @@
+#include "PathSearchState.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+PathSearchState::PathSearchState() {
+	stamp		= 0;
+	expanded	= 0;
+	goal		= NoNode;
+}
+
+PathSearchState::~PathSearchState() {
+}
+
+void PathSearchState::Begin(int nodeCount) {
+	if ((int)records.size() < nodeCount) {
+		records.resize(nodeCount);
+	}
+	heap.clear();
+	expanded	= 0;
+	goal		= NoNode;
+
+	stamp++;
+	if (stamp == 0) { //wrapped around, so old stamps could match again
+		for (NodeRecord& r : records) {
+			r.stamp = 0;
+		}
+		stamp = 1;
+	}
+}
+
+bool PathSearchState::Open(int node, float g, float h, int parent) {
+	NodeRecord& r = records[node];
+
+	if (r.stamp != stamp) {
+		r.stamp		= stamp;
+		r.g			= g;
+		r.f			= g + h;
+		r.parent	= parent;
+		heap.push_back(node);
+		r.heapIndex	= (int)heap.size() - 1;
+		SiftUp(r.heapIndex);
+		return true;
+	}
+	if (r.heapIndex < 0 || g >= r.g) {
+		return false;
+	}
+	//decrease-key - the estimate only ever goes down, so it can only move towards the top
+	r.f			= g + (r.f - r.g);
+	r.g			= g;
+	r.parent	= parent;
+	SiftUp(r.heapIndex);
+	return true;
+}
+
+int PathSearchState::PopBest() {
+	if (heap.empty()) {
+		return NoNode;
+	}
+	int best = heap[0];
+	records[best].heapIndex = -1;
+
+	int last = heap.back();
+	heap.pop_back();
+	if (!heap.empty()) {
+		Place(0, last);
+		SiftDown(0);
+	}
+	expanded++;
+	return best;
+}
+
+//Ties go to the node that's got further, which keeps searches on open ground from fanning out
+bool PathSearchState::Better(int a, int b) const {
+	const NodeRecord& ra = records[a];
+	const NodeRecord& rb = records[b];
+	return ra.f < rb.f || (ra.f == rb.f && ra.g > rb.g);
+}
+
+void PathSearchState::Place(int heapIndex, int node) {
+	heap[heapIndex] = node;
+	records[node].heapIndex = heapIndex;
+}
+
+void PathSearchState::SiftUp(int heapIndex) {
+	int node = heap[heapIndex];
+	while (heapIndex > 0) {
+		int parentIndex = (heapIndex - 1) / 2;
+		if (!Better(node, heap[parentIndex])) {
+			break;
+		}
+		Place(heapIndex, heap[parentIndex]);
+		heapIndex = parentIndex;
+	}
+	Place(heapIndex, node);
+}
+
+void PathSearchState::SiftDown(int heapIndex) {
+	int node	= heap[heapIndex];
+	int count	= (int)heap.size();
+	while (true) {
+		int child = heapIndex * 2 + 1;
+		if (child >= count) {
+			break;
+		}
+		if (child + 1 < count && Better(heap[child + 1], heap[child])) {
+			child++;
+		}
+		if (!Better(heap[child], node)) {
+			break;
+		}
+		Place(heapIndex, heap[child]);
+		heapIndex = child;
+	}
+	Place(heapIndex, node);
+}
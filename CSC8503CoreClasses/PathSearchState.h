@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Everything one A* query needs to remember about the nodes it has
+		touched - the cost so far, the estimate, where it came from, and
+		whether it's open or closed - kept out of the navigation data itself,
+		so any number of queries can run over the same map at once, each with
+		its own state.
+
+		Nodes are just indices. The open list is a binary heap that tracks
+		where each node sits in it, so finding the best node is O(log n), and
+		a cheaper route to an open node can move it up in place (decrease-key)
+		rather than it being searched for.
+
+		Every record is stamped with the query it was last written by, so
+		starting a new query is just bumping the stamp - nothing is cleared,
+		and the arrays are only reallocated when a bigger map comes along.
+		Keep one of these per thread (or per agent) and reuse it.
+		*/
+		class PathSearchState
+		{
+		public:
+			static const int NoNode = -1;
+
+			PathSearchState();
+			~PathSearchState();
+
+			//Call before each search, with the number of nodes in the map being searched
+			void Begin(int nodeCount);
+
+			bool IsVisited(int node) const {
+				return records[node].stamp == stamp;
+			}
+
+			bool IsOpen(int node) const {
+				return IsVisited(node) && records[node].heapIndex >= 0;
+			}
+
+			bool IsClosed(int node) const {
+				return IsVisited(node) && records[node].heapIndex < 0;
+			}
+
+			float GetCost(int node) const {
+				return records[node].g;
+			}
+
+			int GetParent(int node) const {
+				return records[node].parent;
+			}
+
+			/*
+			Adds a node to the open list, or if it's already open and this is a
+			cheaper route to it, updates it in place. Returns false (and changes
+			nothing) if the node is closed, or the route is no better.
+			*/
+			bool Open(int node, float g, float h, int parent);
+
+			//Closes and returns the open node with the lowest estimate, or NoNode if there are none
+			int PopBest();
+
+			bool HasOpenNodes() const {
+				return !heap.empty();
+			}
+
+			//How many nodes this search has closed so far
+			int GetExpandedCount() const {
+				return expanded;
+			}
+
+			//For searches run a few nodes at a time - where the search is headed, so it can carry on later
+			void SetGoal(int node) {
+				goal = node;
+			}
+
+			int GetGoal() const {
+				return goal;
+			}
+
+		protected:
+			struct NodeRecord {
+				uint32_t	stamp		= 0;
+				float		g			= 0.0f;
+				float		f			= 0.0f;
+				int			parent		= NoNode;
+				int			heapIndex	= -1; //-1 once closed
+			};
+
+			bool Better(int a, int b) const;
+			void SiftUp(int heapIndex);
+			void SiftDown(int heapIndex);
+			void Place(int heapIndex, int node);
+
+			std::vector<NodeRecord>	records;
+			std::vector<int>		heap;
+			uint32_t				stamp;
+			int						expanded;
+			int						goal;
+		};
+	}
+}
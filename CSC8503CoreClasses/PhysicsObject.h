@@ -1,4 +1,5 @@
 #pragma once
+#include "ObjectPool.h"
 using namespace NCL::Maths;
 
 namespace NCL {
@@ -7,7 +8,7 @@ namespace NCL {
 	namespace CSC8503 {
 		class Transform;
 
-		class PhysicsObject	{
+		class PhysicsObject : public PoolAllocated<PhysicsObject>	{
 		public:
 			PhysicsObject(Transform& parentTransform, const CollisionVolume* parentVolume);
 			~PhysicsObject() = default;
@@ -8,21 +8,30 @@
 #include "QuadTree.h"
 #include "Debug.h"
 #include "Window.h"
+#include "WorldSnapshot.h"
+#include "JobSystem.h"
 #include <functional>
+#include <cassert>
 using namespace NCL;
 using namespace CSC8503;
 
-PhysicsSystem::PhysicsSystem(GameWorld& g) : gameWorld(g)
+PhysicsSystem::PhysicsSystem(GameWorld& g) : gameWorld(g), broadphaseCollisions(ArenaAllocator<CollisionDetection::CollisionInfo>(broadphaseArena))
 {
 	applyGravity = false;
 	useBroadPhase = false;
 	dTOffset = 0.0f;
 	globalDamping = 0.995f;
+	deterministic = false;
 	SetGravity(Vector3(0.0f, -9.8f, 0.0f));
+	SetDeterministic(false);
+	narrowPhaseBatch.SetAxisCache(&satAxisCache);
+	removalListener = gameWorld.AddRemovalListener([this](GameObject* o) { OnObjectRemoved(o); });
 }
 
 PhysicsSystem::~PhysicsSystem()
 {
+	gameWorld.RemoveRemovalListener(removalListener);
+	delete checksumSnapshot;
 }
 
 void PhysicsSystem::SetGravity(const Vector3& g)
@@ -34,15 +43,45 @@ void PhysicsSystem::SetGravity(const Vector3& g)
 
 If the 'game' is ever reset, the PhysicsSystem must be
 'cleared' to remove any old collisions that might still
-be hanging around in the collision list. If your engine
-is expanded to allow objects to be removed from the world,
-you'll need to iterate through this collisions list to remove
-any collisions they are in.
+be hanging around in the collision list. Objects removed
+from the world one at a time are taken out of it by
+OnObjectRemoved instead.
 
 */
 void PhysicsSystem::Clear()
 {
 	allCollisions.clear();
+	satAxisCache.Clear();
+}
+
+/*
+The world calls this before the object might be deleted, so it's still safe
+to read - the collision set's ordering needs its world ID. Only collisions
+that have had their OnCollisionBegin get an OnCollisionEnd.
+*/
+void PhysicsSystem::OnObjectRemoved(GameObject* o)
+{
+	for (auto i = allCollisions.begin(); i != allCollisions.end(); ) {
+		if (i->a != o && i->b != o) {
+			++i;
+			continue;
+		}
+		if (i->framesLeft < numCollisionFrames) {
+			GameObject* other = (i->a == o) ? i->b : i->a;
+			other->OnCollisionEnd(o);
+		}
+		i = allCollisions.erase(i);
+	}
+	for (auto i = broadphaseCollisions.begin(); i != broadphaseCollisions.end(); ) {
+		if (i->a == o || i->b == o) {
+			i = broadphaseCollisions.erase(i);
+		}
+		else {
+			++i;
+		}
+	}
+	narrowPhaseBatch.Clear();
+	satAxisCache.Forget(o->GetWorldID());
 }
 
 /*
@@ -60,31 +99,49 @@ const int   idealHZ = 120;
 const float idealDT = 1.0f / idealHZ;
 
 /*
-This is the fixed update we actually have...
+The fixed update we actually have is held in realHZ / realDT...
 If physics takes too long it starts to kill the framerate, it'll drop the
 iteration count down until the FPS stabilises, even if that ends up
-being at a low rate.
+being at a low rate. Deterministic mode pins it at the ideal rate.
 */
-int realHZ = idealHZ;
-float realDT = idealDT;
+void PhysicsSystem::SetDeterministic(bool state)
+{
+	deterministic	= state;
+	realHZ			= idealHZ;
+	realDT			= idealDT;
+	gameWorld.SetDeterministic(state);
+}
 
-void PhysicsSystem::Update(float dt)
+unsigned int PhysicsSystem::GetStateChecksum()
 {
-	if (Window::GetKeyboard()->KeyPressed(KeyCodes::B)) {
-		useBroadPhase = !useBroadPhase;
-		std::cout << "Setting broadphase to " << useBroadPhase << std::endl;
-	}
-	if (Window::GetKeyboard()->KeyPressed(KeyCodes::N)) {
-		useSimpleContainer = !useSimpleContainer;
-		std::cout << "Setting broad container to " << useSimpleContainer << std::endl;
+	if (!checksumSnapshot) {
+		checksumSnapshot = new WorldSnapshot();
 	}
-	if (Window::GetKeyboard()->KeyPressed(KeyCodes::I)) {
-		constraintIterationCount--;
-		std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
-	}
-	if (Window::GetKeyboard()->KeyPressed(KeyCodes::O)) {
-		constraintIterationCount++;
-		std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+	checksumSnapshot->Reset();
+	WriteSnapshot(*checksumSnapshot);
+	return checksumSnapshot->GetChecksum();
+}
+
+void PhysicsSystem::Update(float dt)
+{
+	//No window when running headless (benchmarks, servers), so no debug keys either
+	if (const Keyboard* keyboard = Window::GetKeyboard()) {
+		if (keyboard->KeyPressed(KeyCodes::B)) {
+			useBroadPhase = !useBroadPhase;
+			std::cout << "Setting broadphase to " << useBroadPhase << std::endl;
+		}
+		if (keyboard->KeyPressed(KeyCodes::N)) {
+			useSimpleContainer = !useSimpleContainer;
+			std::cout << "Setting broad container to " << useSimpleContainer << std::endl;
+		}
+		if (keyboard->KeyPressed(KeyCodes::I)) {
+			constraintIterationCount--;
+			std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+		}
+		if (keyboard->KeyPressed(KeyCodes::O)) {
+			constraintIterationCount++;
+			std::cout << "Setting constraint iterations to " << constraintIterationCount << std::endl;
+		}
 	}
 
 	dTOffset += dt; //We accumulate time delta here - there might be remainders from previous frame!
@@ -92,19 +149,30 @@ void PhysicsSystem::Update(float dt)
 	GameTimer t;
 	t.GetTimeDeltaSeconds();
 
+	GameTimer phaseTimer; //Tick'd after each phase, to fill in the stats
+	auto EndPhase = [&](float& total) {
+		phaseTimer.Tick();
+		total += phaseTimer.GetTimeDeltaMSec();
+	};
+
 	if (useBroadPhase) {
 		UpdateObjectAABBs();
 	}
+	EndPhase(stats.broadPhaseTime);
+
 	int iteratorCount = 0;
 	while (dTOffset > realDT) {
 		IntegrateAccel(realDT); //Update accelerations from external forces
+		EndPhase(stats.integrateAccelTime);
 		if (useBroadPhase) {
 			BroadPhase();
+			EndPhase(stats.broadPhaseTime);
 			NarrowPhase();
 		}
 		else {
 			BasicCollisionDetection();
 		}
+		EndPhase(stats.narrowPhaseTime);
 
 		//This is our simple iterative solver - 
 		//we just run things multiple times, slowly moving things forward
@@ -113,7 +181,9 @@ void PhysicsSystem::Update(float dt)
 		for (int i = 0; i < constraintIterationCount; ++i) {
 			UpdateConstraints(constraintDt);
 		}
+		EndPhase(stats.constraintTime);
 		IntegrateVelocity(realDT); //update positions from new velocity changes
+		EndPhase(stats.integrateVelocityTime);
 
 		dTOffset -= realDT;
 		iteratorCount++;
@@ -122,6 +192,14 @@ void PhysicsSystem::Update(float dt)
 	ClearForces();	//Once we've finished with the forces, reset them to zero
 
 	UpdateCollisionList(); //Remove any old collisions
+	EndPhase(stats.collisionListTime);
+
+	stats.updates++;
+	stats.substeps += iteratorCount;
+
+	if (deterministic) {
+		return; //step rate must never depend on how long we took
+	}
 
 	t.Tick();
 	float updateTime = t.GetTimeDeltaSeconds();
@@ -204,6 +282,8 @@ void PhysicsSystem::BasicCollisionDetection()
 	std::vector <GameObject*>::const_iterator last;
 	gameWorld.GetObjectIterators(first, last);
 
+	satAxisCache.NextStep();
+
 	for (auto i = first; i != last; ++i) {
 		if ((*i)->GetPhysicsObject() == nullptr) {
 			continue;
@@ -213,7 +293,19 @@ void PhysicsSystem::BasicCollisionDetection()
 				continue;
 			}
 			CollisionDetection::CollisionInfo info;
-			if (CollisionDetection::ObjectIntersection(*i, *j, info)) {
+			const CollisionVolume* volA = (*i)->GetBoundingVolume();
+			const CollisionVolume* volB = (*j)->GetBoundingVolume();
+			bool useCache = volA && volB && CollisionDetection::UsesSATAxis(*volA, *volB);
+			if (useCache) {
+				info.satAxis = satAxisCache.GetAxis((*i)->GetWorldID(), (*j)->GetWorldID());
+			}
+			bool collided = CollisionDetection::ObjectIntersection(*i, *j, info);
+			if (useCache) {
+				satAxisCache.StoreAxis((*i)->GetWorldID(), (*j)->GetWorldID(), info.satAxis);
+			}
+			stats.pairsTested++;
+			if (collided) {
+				stats.contacts++;
 				/*std::cout << " Collision between " << (*i)->GetName()
 					<< " and " << (*j) -> GetName() << std::endl;*/
 				ImpulseResolveCollision(*info.a, *info.b, info.point);
@@ -320,6 +412,7 @@ compare the collisions that we absolutely need to.
 void PhysicsSystem::BroadPhase()
 {
 	broadphaseCollisions.clear();
+	broadphaseArena.Reset(); //only safe now the set is empty
 	QuadTree<GameObject*> tree(Vector2(1024, 1024), 7, 6);
 
 	std::vector<GameObject*>::const_iterator first;
@@ -340,8 +433,9 @@ void PhysicsSystem::BroadPhase()
 				for (auto j = std::next(i); j != data.end(); ++j) {
 					// is this pair of items already in the collision set -
 					// if the same pair is in another quadtree node together etc
-					info.a = std::min((*i).object, (*j).object);
-					info.b = std::max((*i).object, (*j).object);
+					bool swap = (*j).object->GetWorldID() < (*i).object->GetWorldID();
+					info.a = swap ? (*j).object : (*i).object;
+					info.b = swap ? (*i).object : (*j).object;
 					broadphaseCollisions.insert(info);
 				}
 			}
@@ -354,16 +448,23 @@ and work out if they are truly colliding, and if so, add them into the main coll
 */
 void PhysicsSystem::NarrowPhase()
 {
-	for (std::set<CollisionDetection::CollisionInfo>::iterator
-		i = broadphaseCollisions.begin();
-		i != broadphaseCollisions.end(); ++i) {
-		CollisionDetection::CollisionInfo info = *i;
-		if (CollisionDetection::ObjectIntersection(info.a, info.b, info)) {
+	satAxisCache.NextStep();
+
+	narrowPhaseBatch.Clear();
+	for (const CollisionDetection::CollisionInfo& i : broadphaseCollisions) {
+		narrowPhaseBatch.AddPair(i.a, i.b);
+	}
+	narrowPhaseBatch.Cull();
+	stats.pairsTested += narrowPhaseBatch.GetPairsTested();
+
+	narrowPhaseBatch.OperateOnContacts(
+		[&](CollisionDetection::CollisionInfo& info) {
+			stats.contacts++;
 			info.framesLeft = numCollisionFrames;
 			ImpulseResolveCollision(*info.a, *info.b, info.point);
 			allCollisions.insert(info); // insert into our main set
 		}
-	}
+	);
 }
 
 /*
@@ -377,38 +478,37 @@ the course of the previous game frame.
 */
 void PhysicsSystem::IntegrateAccel(float dt)
 {
-	std::vector<GameObject*>::const_iterator first;
-	std::vector<GameObject*>::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
+	//Only objects with a physics component are in here, so no null checks
+	const std::vector<PhysicsObject*>& objects = gameWorld.GetPhysicsComponents().GetComponents();
 
-	for (auto i = first; i != last; ++i) {
-		PhysicsObject* object = (*i)->GetPhysicsObject();
-		if (object == nullptr) {
-			continue; // No physics object for this GameObject !
-		}
-		float inverseMass = object->GetInverseMass();
+	//Each object only touches its own state, so they can be split across the job system
+	JobSystem::Get().ParallelFor((int)objects.size(), integrationBatchSize, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			PhysicsObject* object = objects[i];
+			float inverseMass = object->GetInverseMass();
 
-		Vector3 linearVel = object->GetLinearVelocity();
-		Vector3 force = object->GetForce();
-		Vector3 accel = force * inverseMass;
+			Vector3 linearVel = object->GetLinearVelocity();
+			Vector3 force = object->GetForce();
+			Vector3 accel = force * inverseMass;
 
-		if (applyGravity && inverseMass > 0) {
-			accel += gravity; // don't move infinitely heavy things
-		}
+			if (applyGravity && inverseMass > 0) {
+				accel += gravity; // don't move infinitely heavy things
+			}
 
-		linearVel += accel * dt; // integrate accel !
-		object->SetLinearVelocity(linearVel);
+			linearVel += accel * dt; // integrate accel !
+			object->SetLinearVelocity(linearVel);
 
-		// Angular stuff
-		Vector3 torque = object->GetTorque();
-		Vector3 angVel = object->GetAngularVelocity();
+			// Angular stuff
+			Vector3 torque = object->GetTorque();
+			Vector3 angVel = object->GetAngularVelocity();
 
-		object->UpdateInertiaTensor(); // update tensor vs orientation
-		Vector3 angAccel = object->GetInertiaTensor() * torque;
+			object->UpdateInertiaTensor(); // update tensor vs orientation
+			Vector3 angAccel = object->GetInertiaTensor() * torque;
 
-		angVel += angAccel * dt; // integrate angular accel !
-		object->SetAngularVelocity(angVel);
-	}
+			angVel += angAccel * dt; // integrate angular accel !
+			object->SetAngularVelocity(angVel);
+		}
+	});
 }
 
 /*
@@ -419,40 +519,38 @@ the world, looking for collisions.
 */
 void PhysicsSystem::IntegrateVelocity(float dt)
 {
-	std::vector < GameObject* >::const_iterator first;
-	std::vector < GameObject* >::const_iterator last;
-	gameWorld.GetObjectIterators(first, last);
+	const ComponentArray<PhysicsObject>& physicsComponents = gameWorld.GetPhysicsComponents();
 	float frameLinearDamping = 1.0f - (1.0f * dt);
 
-	for (auto i = first; i != last; ++i) {
-		PhysicsObject* object = (*i)->GetPhysicsObject();
-		if (object == nullptr) {
-			continue;
+	JobSystem::Get().ParallelFor((int)physicsComponents.Size(), integrationBatchSize, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			PhysicsObject* object = physicsComponents.Get(i);
+			Transform& transform = physicsComponents.GetOwner(i)->GetTransform();
+			assert(!transform.GetParent() && "Physics objects must be root transforms, as their local values are treated as world space!");
+			// Position Stuff
+			Vector3 position = transform.GetPosition();
+			Vector3 linearVel = object->GetLinearVelocity();
+			position += linearVel * dt;
+			transform.SetPosition(position);
+			// Linear Damping
+			linearVel = linearVel * frameLinearDamping;
+			object->SetLinearVelocity(linearVel);
+
+			// Orientation Stuff
+			Quaternion orientation = transform.GetOrientation();
+			Vector3 angVel = object->GetAngularVelocity();
+
+			orientation = orientation + (Quaternion(angVel * dt * 0.5f, 0.0f) * orientation);
+			orientation.Normalise();
+
+			transform.SetOrientation(orientation);
+
+			// Damp the angular velocity too
+			float frameAngularDamping = 1.0f - (0.4f * dt);
+			angVel = angVel * frameAngularDamping;
+			object->SetAngularVelocity(angVel);
 		}
-		Transform& transform = (*i)->GetTransform();
-		// Position Stuff
-		Vector3 position = transform.GetPosition();
-		Vector3 linearVel = object->GetLinearVelocity();
-		position += linearVel * dt;
-		transform.SetPosition(position);
-		// Linear Damping
-		linearVel = linearVel * frameLinearDamping;
-		object->SetLinearVelocity(linearVel);
-
-		// Orientation Stuff
-		Quaternion orientation = transform.GetOrientation();
-		Vector3 angVel = object->GetAngularVelocity();
-
-		orientation = orientation + (Quaternion(angVel * dt * 0.5f, 0.0f) * orientation);
-		orientation.Normalise();
-
-		transform.SetOrientation(orientation);
-
-		// Damp the angular velocity too
-		float frameAngularDamping = 1.0f - (0.4f * dt);
-		angVel = angVel * frameAngularDamping;
-		object->SetAngularVelocity(angVel);
-	}
+	});
 }
 
 /*
@@ -462,11 +560,9 @@ ones in the next 'game' frame.
 */
 void PhysicsSystem::ClearForces()
 {
-	gameWorld.OperateOnContents(
-		[](GameObject* o) {
-			o->GetPhysicsObject()->ClearForces();
-		}
-	);
+	for (PhysicsObject* object : gameWorld.GetPhysicsComponents().GetComponents()) {
+		object->ClearForces();
+	}
 }
 
 
@@ -552,4 +648,71 @@ void PhysicsSystem::DrawDebugData() {
 			}
 		}
 	);
+}
+
+/*
+Rollback support. The physics snapshot is the world snapshot followed by
+our own state - the leftover timestep and the persistent collision list.
+Collisions are stored by world ID rather than pointer, so the snapshot
+doesn't depend on where the objects happen to be in memory.
+*/
+
+struct PhysicsSnapshotHeader {
+	float	dTOffset;
+	int		collisionCount;
+};
+
+struct CollisionSnapshot {
+	int		aWorldID;
+	int		bWorldID;
+	int		framesLeft;
+	CollisionDetection::ContactPoint point;
+};
+
+void PhysicsSystem::WriteSnapshot(WorldSnapshot& s) const {
+	gameWorld.WriteSnapshot(s);
+
+	PhysicsSnapshotHeader header;
+	header.dTOffset			= dTOffset;
+	header.collisionCount	= (int)allCollisions.size();
+	s.Write(header);
+
+	for (const CollisionDetection::CollisionInfo& i : allCollisions) {
+		CollisionSnapshot cs;
+		cs.aWorldID		= i.a->GetWorldID();
+		cs.bWorldID		= i.b->GetWorldID();
+		cs.framesLeft	= i.framesLeft;
+		cs.point		= i.point;
+		s.Write(cs);
+	}
+}
+
+bool PhysicsSystem::ReadSnapshot(const WorldSnapshot& s) {
+	size_t offset = 0;
+	if (!gameWorld.ReadSnapshot(s, offset)) {
+		return false;
+	}
+	PhysicsSnapshotHeader header;
+	if (!s.Read(offset, header)) {
+		return false;
+	}
+	dTOffset = header.dTOffset;
+
+	allCollisions.clear();
+	for (int i = 0; i < header.collisionCount; ++i) {
+		CollisionSnapshot cs;
+		if (!s.Read(offset, cs)) {
+			return false;
+		}
+		CollisionDetection::CollisionInfo info;
+		info.a			= gameWorld.GetSnapshotObject(cs.aWorldID);
+		info.b			= gameWorld.GetSnapshotObject(cs.bWorldID);
+		info.framesLeft = cs.framesLeft;
+		info.point		= cs.point;
+		if (!info.a || !info.b) {
+			return false;
+		}
+		allCollisions.insert(info);
+	}
+	return true;
 }
\ No newline at end of file
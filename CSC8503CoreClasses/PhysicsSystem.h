@@ -1,9 +1,29 @@
 #pragma once
 #include "GameWorld.h"
 #include "./CollisionDetection.h"
+#include "NarrowPhaseBatch.h"
+#include "FrameArena.h"
 
 namespace NCL {
 	namespace CSC8503 {
+		/*
+		Running totals of where the physics time goes, accumulated across
+		every Update until ResetStats is called. Times are in milliseconds.
+		*/
+		struct PhysicsStats {
+			float	integrateAccelTime		= 0.0f;
+			float	broadPhaseTime			= 0.0f;
+			float	narrowPhaseTime			= 0.0f;
+			float	constraintTime			= 0.0f;
+			float	integrateVelocityTime	= 0.0f;
+			float	collisionListTime		= 0.0f;
+
+			int		updates			= 0;
+			int		substeps		= 0;
+			int		pairsTested		= 0;
+			int		contacts		= 0;
+		};
+
 		class PhysicsSystem	
 		{
 		public:
@@ -12,6 +32,9 @@ namespace NCL {
 
 			void Clear();
 
+			//Ends every collision the object is part of, and forgets it - called by the world as it is removed
+			void OnObjectRemoved(GameObject* o);
+
 			void Update(float dt);
 
 			void UseGravity(bool state) 
@@ -19,6 +42,21 @@ namespace NCL {
 				applyGravity = state;
 			}
 
+			void UseBroadPhase(bool state) 
+			{
+				useBroadPhase = state;
+			}
+
+			const PhysicsStats& GetStats() const 
+			{
+				return stats;
+			}
+
+			void ResetStats() 
+			{
+				stats = PhysicsStats();
+			}
+
 			void SetGlobalDamping(float d) 
 			{
 				globalDamping = d;
@@ -26,7 +64,27 @@ namespace NCL {
 
 			void SetGravity(const Vector3& g);
 
+			/*
+			In deterministic mode the simulation always steps at the ideal rate
+			and the world is never shuffled, so two runs fed the same inputs
+			produce bit-identical results - needed for lockstep networking
+			and replays. The adaptive step rate is disabled, so a slow machine
+			will slow down rather than drop physics accuracy.
+			*/
+			void SetDeterministic(bool state);
+
+			bool IsDeterministic() const 
+			{
+				return deterministic;
+			}
+
+			//Hash of the current simulation state, for spotting lockstep desyncs
+			unsigned int GetStateChecksum();
+
 			void DrawDebugData();
+
+			void WriteSnapshot(WorldSnapshot& s) const;
+			bool ReadSnapshot(const WorldSnapshot& s);
 		protected:
 			void BasicCollisionDetection();
 			void BroadPhase();
@@ -51,11 +109,29 @@ namespace NCL {
 			float	dTOffset;
 			float	globalDamping;
 
+			int		realHZ;
+			float	realDT;
+			bool	deterministic;
+
 			std::set<CollisionDetection::CollisionInfo>		allCollisions;
-			std::set<CollisionDetection::CollisionInfo>		broadphaseCollisions;
+			//The broadphase pairs are rebuilt every substep, so their set nodes come from an arena
+			typedef std::set<CollisionDetection::CollisionInfo, std::less<CollisionDetection::CollisionInfo>,
+				ArenaAllocator<CollisionDetection::CollisionInfo>> BroadphasePairSet;
+
+			FrameArena										broadphaseArena;
+			BroadphasePairSet								broadphaseCollisions;
 			std::vector<CollisionDetection::CollisionInfo>	broadphaseCollisionsVec;
+			NarrowPhaseBatch								narrowPhaseBatch;
+			SATAxisCache									satAxisCache;
 			bool	useBroadPhase		= true;
 			int		numCollisionFrames	= 5;
+			int		integrationBatchSize	= 64; //objects per job when integrating
+
+			WorldSnapshot* checksumSnapshot = nullptr;
+
+			int		removalListener;
+
+			PhysicsStats stats;
 		};
 	}
 }
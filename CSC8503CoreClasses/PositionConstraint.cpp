@@ -1,6 +1,7 @@
 #include "PositionConstraint.h"
 #include "GameObject.h"
 #include "PhysicsObject.h"
+#include "WorldSnapshot.h"
 
 using namespace NCL;
 using namespace Maths;
@@ -51,3 +52,13 @@ void PositionConstraint::UpdateConstraint(float dt)
 		}
 	}
 }
+
+void PositionConstraint::WriteSnapshot(WorldSnapshot& s) const
+{
+	s.Write(distance);
+}
+
+bool PositionConstraint::ReadSnapshot(const WorldSnapshot& s, size_t& offset)
+{
+	return s.Read(offset, distance);
+}
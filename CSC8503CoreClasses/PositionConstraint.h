@@ -12,6 +12,11 @@ namespace NCL {
 
 			void UpdateConstraint(float dt) override;
 
+			void WriteSnapshot(WorldSnapshot& s) const override;
+			bool ReadSnapshot(const WorldSnapshot& s, size_t& offset) override;
+
+			bool Uses(const GameObject* o) const override { return o == objectA || o == objectB; }
+
 		protected:
 			GameObject* objectA;
 			GameObject* objectB;
@@ -1,4 +1,5 @@
 #pragma once
+#include "ObjectPool.h"
 
 namespace NCL {
 	namespace Rendering {
@@ -25,7 +26,7 @@ namespace NCL {
 			Texture*		bumpTex		= nullptr;
 		};
 
-		class RenderObject
+		class RenderObject : public PoolAllocated<RenderObject>
 		{
 		public:
 			RenderObject(Transform& parentTransform, Mesh* mesh, const GameTechMaterial& material);
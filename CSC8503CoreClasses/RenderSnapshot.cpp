@@ -0,0 +1,41 @@
+#include "RenderSnapshot.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "Mesh.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+void RenderSnapshot::Capture(const GameWorld& world) {
+	//clear() keeps the capacity, so a snapshot that's reused every frame stops allocating
+	entries.clear();
+
+	//Only objects with a render component are in here, so no null checks
+	const ComponentArray<RenderObject>& renderComponents = world.GetRenderComponents();
+	entries.reserve(renderComponents.Size());
+
+	for (int i = 0; i < (int)renderComponents.Size(); ++i) {
+		if (!renderComponents.GetOwner(i)->IsActive()) {
+			continue;
+		}
+		const RenderObject* o	= renderComponents.Get(i);
+		GameTechMaterial mat	= o->GetMaterial();
+
+		Entry e;
+		e.modelMatrix		= o->GetTransform().GetMatrix();
+		e.colour			= o->GetColour();
+		e.mesh				= o->GetMesh();
+		e.diffuseTex		= mat.diffuseTex;
+		e.type				= mat.type;
+		e.hasVertexColours	= !o->GetMesh()->GetColourData().empty();
+		entries.emplace_back(e);
+	}
+
+	camera		= world.GetMainCamera();
+	sunPosition	= world.GetSunPosition();
+	sunColour	= world.GetSunColour();
+
+	debugLines		= Debug::GetDebugLines();
+	debugStrings	= Debug::GetDebugStrings();
+	debugTex		= Debug::GetDebugTex();
+}
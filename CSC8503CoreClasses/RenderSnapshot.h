@@ -0,0 +1,79 @@
+#pragma once
+#include "Camera.h"
+#include "RenderObject.h"
+#include "Debug.h"
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameWorld;
+
+		/*
+		An immutable copy of everything the renderer needs to draw one frame:
+		a compact array of model matrices, colours and mesh / material IDs,
+		plus the camera, the sun and that frame's debug lines and text.
+
+		Capturing one at the end of a simulation frame lets the renderer draw
+		frame N from it while the game, AI and physics are already working on
+		frame N+1, without ever touching a live GameObject. Meshes and textures
+		are shared assets that outlive any frame, so their pointers double up
+		as the mesh and material IDs.
+		*/
+		class RenderSnapshot
+		{
+		public:
+			struct Entry {
+				Matrix4			modelMatrix;
+				Vector4			colour;
+				const Mesh*		mesh;
+				const Texture*	diffuseTex;
+				MaterialType	type;
+				bool			hasVertexColours;
+			};
+
+			RenderSnapshot() = default;
+			~RenderSnapshot() = default;
+
+			//Must be called at a point where nothing else is changing the world
+			void Capture(const GameWorld& world);
+
+			const std::vector<Entry>& GetEntries() const {
+				return entries;
+			}
+
+			const PerspectiveCamera& GetCamera() const {
+				return camera;
+			}
+
+			Vector3 GetSunPosition() const {
+				return sunPosition;
+			}
+
+			Vector3 GetSunColour() const {
+				return sunColour;
+			}
+
+			const std::vector<Debug::DebugLineEntry>& GetDebugLines() const {
+				return debugLines;
+			}
+
+			const std::vector<Debug::DebugStringEntry>& GetDebugStrings() const {
+				return debugStrings;
+			}
+
+			const std::vector<Debug::DebugTexEntry>& GetDebugTex() const {
+				return debugTex;
+			}
+
+		protected:
+			std::vector<Entry>	entries;
+
+			PerspectiveCamera	camera;
+			Vector3				sunPosition;
+			Vector3				sunColour;
+
+			std::vector<Debug::DebugLineEntry>		debugLines;
+			std::vector<Debug::DebugStringEntry>	debugStrings;
+			std::vector<Debug::DebugTexEntry>		debugTex;
+		};
+	}
+}
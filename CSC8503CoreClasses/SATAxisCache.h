@@ -0,0 +1,66 @@
+#pragma once
+#include <unordered_map>
+#include <cstdint>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		Remembers the SAT axis each OBB pair ended on last substep, so that
+		OBBIntersection can try it first next time round. Pairs are keyed on
+		their world IDs, in the order they were handed to the narrowphase.
+
+		Entries are double buffered - lookups read last substep's results and
+		writes go into this substep's, so a pair the broadphase stops reporting
+		simply drops out of the cache instead of lingering forever.
+		*/
+		class SATAxisCache
+		{
+		public:
+			void NextStep() {
+				std::swap(previous, current);
+				current.clear();
+			}
+
+			void Clear() {
+				previous.clear();
+				current.clear();
+			}
+
+			int GetAxis(int worldIDA, int worldIDB) const {
+				auto i = previous.find(MakeKey(worldIDA, worldIDB));
+				return i == previous.end() ? -1 : i->second;
+			}
+
+			void StoreAxis(int worldIDA, int worldIDB, int axis) {
+				if (axis >= 0) {
+					current[MakeKey(worldIDA, worldIDB)] = axis;
+				}
+			}
+
+			//Drops every pair the object is part of, so a later object given the same ID starts fresh
+			void Forget(int worldID) {
+				Forget(previous, worldID);
+				Forget(current, worldID);
+			}
+
+		protected:
+			static uint64_t MakeKey(int a, int b) {
+				return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+			}
+
+			static void Forget(std::unordered_map<uint64_t, int>& pairs, int worldID) {
+				for (auto i = pairs.begin(); i != pairs.end(); ) {
+					if ((uint32_t)(i->first >> 32) == (uint32_t)worldID || (uint32_t)i->first == (uint32_t)worldID) {
+						i = pairs.erase(i);
+					}
+					else {
+						++i;
+					}
+				}
+			}
+
+			std::unordered_map<uint64_t, int> previous;
+			std::unordered_map<uint64_t, int> current;
+		};
+	}
+}
@@ -2,7 +2,7 @@
 #include "CollisionVolume.h"
 
 namespace NCL {
-	class SphereVolume : public CollisionVolume
+	class SphereVolume : public CollisionVolume, public PoolAllocated<SphereVolume>
 	{
 	public:
 		SphereVolume(float sphereRadius = 1.0f) {
@@ -0,0 +1,41 @@
+#include "Tag.h"
+
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+using namespace NCL;
+using namespace CSC8503;
+
+namespace {
+	struct TagRegistry {
+		std::mutex								lock;
+		std::unordered_map<NameID, int, NameIDHash>	bits;
+	};
+
+	TagRegistry& GetTagRegistry() {
+		static TagRegistry* registry = new TagRegistry();
+		return *registry;
+	}
+}
+
+Tag::Tag(const NameID& name) {
+	bit = -1;
+	if (name.IsNull()) {
+		return;
+	}
+	TagRegistry& registry = GetTagRegistry();
+	std::lock_guard<std::mutex> guard(registry.lock);
+
+	auto found = registry.bits.find(name);
+	if (found != registry.bits.end()) {
+		bit = found->second;
+		return;
+	}
+	if ((int)registry.bits.size() >= MaxTags) {
+		std::cout << "Tag: ran out of tag bits registering '" << name.GetString() << "'\n";
+		return;
+	}
+	bit = (int)registry.bits.size();
+	registry.bits.insert({ name, bit });
+}
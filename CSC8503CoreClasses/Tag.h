@@ -0,0 +1,43 @@
+#pragma once
+#include "NameID.h"
+
+#include <bitset>
+
+namespace NCL::CSC8503 {
+	const int MaxTags = 64;
+
+	typedef std::bitset<MaxTags> TagSet;
+
+	/*
+	A named category that GameObjects can be put in - "Metal", "Pickup" and
+	so on. Each distinct tag name is given its own bit the first time it's
+	asked for, so an object's tags are just a bitset, checking one is a bit
+	test, and the GameWorld can keep a list of the objects with each tag.
+
+	Like NameIDs, hot code should make the Tags it uses once and keep them.
+	*/
+	class Tag {
+	public:
+		Tag() : bit(-1) {}
+		explicit Tag(const NameID& name);
+
+		int GetBit() const {
+			return bit;
+		}
+
+		bool IsValid() const {
+			return bit >= 0;
+		}
+
+		bool operator==(const Tag& other) const {
+			return bit == other.bit;
+		}
+
+		bool operator!=(const Tag& other) const {
+			return bit != other.bit;
+		}
+
+	protected:
+		int bit;
+	};
+}
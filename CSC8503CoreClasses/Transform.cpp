@@ -1,36 +1,114 @@
 #include "Transform.h"
+#include <algorithm>
 
 using namespace NCL::CSC8503;
 
 Transform::Transform()	{
-	scale = Vector3(1, 1, 1);
+	scale	= Vector3(1, 1, 1);
+	parent	= nullptr;
+	dirty	= true;
 }
 
 Transform::~Transform()	{
+	SetParent(nullptr);
+	for (Transform* c : children) {
+		c->parent = nullptr;
+		c->MarkDirty();
+	}
+}
+
+/*
+Builds translation * rotation * scale straight into the columns, rather
+than multiplying three full 4x4 matrices together - the rotation columns
+are just scaled, and the translation is dropped into the last column.
+Only parented transforms pay for a matrix multiply.
+*/
+void Transform::UpdateMatrix() const {
+	Matrix4 local = Quaternion::RotationMatrix<Matrix4>(orientation);
+
+	for (int r = 0; r < 3; ++r) {
+		local.array[0][r] *= scale.x;
+		local.array[1][r] *= scale.y;
+		local.array[2][r] *= scale.z;
+	}
+	local.array[3][0] = position.x;
+	local.array[3][1] = position.y;
+	local.array[3][2] = position.z;
+
+	matrix	= parent ? parent->GetMatrix() * local : local;
+	dirty	= false;
+}
+
+void Transform::UpdateHierarchy() const {
+	if (dirty) {
+		UpdateMatrix();
+	}
+	for (const Transform* c : children) {
+		c->UpdateHierarchy();
+	}
+}
 
+/*
+A dirty transform always has dirty children - they're marked with it, and
+only ever cleaned after it - so there's no need to go any further down.
+*/
+void Transform::MarkDirty() {
+	if (dirty) {
+		return;
+	}
+	dirty = true;
+	for (Transform* c : children) {
+		c->MarkDirty();
+	}
 }
 
-void Transform::UpdateMatrix() {
-	matrix =
-		Matrix::Translation(position) *
-		Quaternion::RotationMatrix<Matrix4>(orientation) *
-		Matrix::Scale(scale);
+Vector3 Transform::GetWorldPosition() const {
+	if (!parent) {
+		return position;
+	}
+	Matrix4 m = GetMatrix();
+	return Vector3(m.array[3][0], m.array[3][1], m.array[3][2]);
 }
 
-Transform& Transform::SetPosition(const Vector3& worldPos) {
-	position = worldPos;
-	UpdateMatrix();
+Quaternion Transform::GetWorldOrientation() const {
+	return parent ? parent->GetWorldOrientation() * orientation : orientation;
+}
+
+Transform& Transform::SetParent(Transform* newParent) {
+	if (newParent == parent) {
+		return *this;
+	}
+	for (Transform* p = newParent; p; p = p->parent) {
+		if (p == this) {
+			return *this; //would make a loop
+		}
+	}
+	if (parent) {
+		vector<Transform*>& siblings = parent->children;
+		siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+	}
+	parent = newParent;
+	if (parent) {
+		parent->children.push_back(this);
+	}
+	MarkDirty();
+	return *this;
+}
+
+Transform& Transform::SetPosition(const Vector3& localPos) {
+	position = localPos;
+	MarkDirty();
 	return *this;
 }
 
-Transform& Transform::SetScale(const Vector3& worldScale) {
-	scale = worldScale;
-	UpdateMatrix();
+Transform& Transform::SetScale(const Vector3& localScale) {
+	scale = localScale;
+	MarkDirty();
 	return *this;
 }
 
-Transform& Transform::SetOrientation(const Quaternion& worldOrientation) {
-	orientation = worldOrientation;
-	UpdateMatrix();
+Transform& Transform::SetOrientation(const Quaternion& localOrientation) {
+	orientation = localOrientation;
+	MarkDirty();
 	return *this;
-}
\ No newline at end of file
+}
@@ -6,16 +6,45 @@ using namespace NCL::Maths;
 
 namespace NCL {
 	namespace CSC8503 {
+		/*
+		Position, orientation and scale are all relative to the parent
+		transform, if there is one - for a root transform they're simply in
+		world space. Physics integrates and collides these values directly,
+		as if they were world space, so an object with a PhysicsObject must
+		stay a root - PhysicsSystem asserts this in debug builds.
+
+		Setting any of them just marks this transform and everything below it
+		as dirty; the world matrix is rebuilt once, either by the
+		GameWorld::UpdateTransforms pass before rendering, or on demand the
+		next time GetMatrix is called. That on-demand rebuild writes the
+		cached matrix, so GetMatrix and GetWorldPosition are only safe to
+		call from several threads at once while the matrices are clean.
+		*/
 		class Transform
 		{
 		public:
 			Transform();
 			~Transform();
 
-			Transform& SetPosition(const Vector3& worldPos);
-			Transform& SetScale(const Vector3& worldScale);
+			//Children and parent links are tied to this transform's address
+			Transform(const Transform&) = delete;
+			Transform& operator=(const Transform&) = delete;
+
+			Transform& SetPosition(const Vector3& localPos);
+			Transform& SetScale(const Vector3& localScale);
 			Transform& SetOrientation(const Quaternion& newOr);
 
+			//Pass nullptr to detach. Local values are kept as they are, so the object will move with its new parent
+			Transform& SetParent(Transform* newParent);
+
+			Transform* GetParent() const {
+				return parent;
+			}
+
+			const vector<Transform*>& GetChildren() const {
+				return children;
+			}
+
 			Vector3 GetPosition() const {
 				return position;
 			}
@@ -28,16 +57,38 @@ namespace NCL {
 				return orientation;
 			}
 
+			Vector3 GetWorldPosition() const;
+			Quaternion GetWorldOrientation() const;
+
 			Matrix4 GetMatrix() const {
+				if (dirty) {
+					UpdateMatrix();
+				}
 				return matrix;
 			}
-			void UpdateMatrix();
+
+			bool IsDirty() const {
+				return dirty;
+			}
+
+			void UpdateMatrix() const;
+
+			//Rebuilds this transform and everything below it, parents always before their children
+			void UpdateHierarchy() const;
+
 		protected:
-			Matrix4		matrix;
+			void MarkDirty();
+
+			mutable Matrix4	matrix;
 			Quaternion	orientation;
 			Vector3		position;
 
 			Vector3		scale;
+
+			Transform*			parent;
+			vector<Transform*>	children;
+
+			mutable bool		dirty;
 		};
 	}
 }
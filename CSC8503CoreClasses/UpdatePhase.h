@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+namespace NCL::CSC8503 {
+	/*
+	The phases of a frame's object updates, run by the UpdateScheduler in
+	this order. Each one is a promise about what an object's update touches,
+	which is what lets the first two run across the job system without any
+	locking:
+
+	Gather	- parallel. May read any object, but only writes this object's
+			  own private members - targets, decisions, timers. World
+			  matrices are all clean by now, so positions can be read.
+	Apply	- parallel. Writes this object's own transform and physics state,
+			  and doesn't look at any other object. Transforms get dirty
+			  again here, so stick to the local position, orientation and
+			  scale - not GetMatrix or GetWorldPosition.
+	Serial	- one object at a time on the calling thread, in world order.
+			  Anything goes: input, the camera, Debug drawing, other objects.
+
+	Objects and constraints added or removed from a parallel phase must go
+	through the world's command buffer.
+	*/
+	enum class UpdatePhase : uint8_t {
+		Gather,
+		Apply,
+		Serial,
+		MaxPhases
+	};
+
+	typedef uint8_t UpdatePhaseMask;
+
+	constexpr UpdatePhaseMask UpdatePhaseBit(UpdatePhase phase) {
+		return (UpdatePhaseMask)(1 << (int)phase);
+	}
+}
@@ -0,0 +1,100 @@
+#include "UpdateScheduler.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+
+using namespace NCL;
+using namespace CSC8503;
+
+UpdateScheduler::UpdateScheduler() {
+	batchSize = 32;
+}
+
+UpdateScheduler::~UpdateScheduler() {
+}
+
+void UpdateScheduler::Update(GameWorld& world, float dt) {
+	BuildBuckets(world);
+
+	//Reading a dirty world matrix rebuilds it, which can't happen on several
+	//threads at once - so they're all brought up to date first
+	world.UpdateTransforms();
+
+	RunParallelPhase(UpdatePhase::Gather, dt);
+	RunParallelPhase(UpdatePhase::Apply, dt);
+
+	for (GameObject* o : serialObjects) {
+		o->RunUpdatePhase(UpdatePhase::Serial, dt);
+	}
+}
+
+/*
+Rebuilt every frame, as objects come and go and can change which phases
+they want. The buckets themselves are kept, so this is just a type lookup
+per object.
+*/
+void UpdateScheduler::BuildBuckets(GameWorld& world) {
+	for (TypeBucket& b : buckets) {
+		b.entries.clear();
+		b.phases = 0;
+	}
+	serialObjects.clear();
+
+	GameObjectIterator first, last;
+	world.GetObjectIterators(first, last);
+
+	for (auto i = first; i != last; ++i) {
+		GameObject* o = *i;
+		if (!o->IsActive()) {
+			continue;
+		}
+		UpdatePhaseMask phases = o->GetUpdatePhases();
+
+		if (phases & UpdatePhaseBit(UpdatePhase::Serial)) {
+			serialObjects.emplace_back(o);
+		}
+		phases &= ~UpdatePhaseBit(UpdatePhase::Serial);
+		if (!phases) {
+			continue;
+		}
+
+		auto found = bucketLookup.find(std::type_index(typeid(*o)));
+		int index;
+		if (found == bucketLookup.end()) {
+			index = (int)buckets.size();
+			buckets.emplace_back();
+			bucketLookup.insert({ std::type_index(typeid(*o)), index });
+		}
+		else {
+			index = found->second;
+		}
+		buckets[index].entries.push_back({ o, phases });
+		buckets[index].phases |= phases;
+	}
+}
+
+void UpdateScheduler::RunParallelPhase(UpdatePhase phase, float dt) {
+	UpdatePhaseMask bit = UpdatePhaseBit(phase);
+	JobCounter counter;
+
+	for (TypeBucket& b : buckets) {
+		if (!(b.phases & bit)) {
+			continue;
+		}
+		int count = (int)b.entries.size();
+		for (int start = 0; start < count; start += batchSize) {
+			int end = std::min(start + batchSize, count);
+
+			JobSystem::Get().Run([&b, start, end, phase, bit, dt]() {
+				for (int i = start; i < end; ++i) {
+					if (b.entries[i].phases & bit) {
+						b.entries[i].object->RunUpdatePhase(phase, dt);
+					}
+				}
+			}, &counter);
+		}
+	}
+	JobSystem::Get().Wait(counter);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "UpdatePhase.h"
+
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameWorld;
+		class GameObject;
+
+		/*
+		Runs every active object's update through the phases in UpdatePhase.h,
+		in place of calling GameObject::Update on each in turn.
+
+		Objects are grouped by their concrete type, so each batch handed to a
+		worker runs the same update code over and over. The parallel phases
+		finish completely before the next one starts, so everything written
+		during Gather is settled before Apply reads it. World matrices are
+		updated before Gather starts, as reading a dirty one writes to it.
+
+		Objects that don't declare any phases only take part in Serial, which
+		calls their Update as before.
+		*/
+		class UpdateScheduler
+		{
+		public:
+			UpdateScheduler();
+			~UpdateScheduler();
+
+			void Update(GameWorld& world, float dt);
+
+			//Objects per job in the parallel phases
+			void SetBatchSize(int size) {
+				batchSize = size;
+			}
+
+		protected:
+			struct Entry {
+				GameObject*		object;
+				UpdatePhaseMask	phases;
+			};
+
+			struct TypeBucket {
+				std::vector<Entry>	entries;
+				UpdatePhaseMask		phases = 0; //every phase any of these objects wants
+			};
+
+			void BuildBuckets(GameWorld& world);
+			void RunParallelPhase(UpdatePhase phase, float dt);
+
+			//Kept between frames, so the vectors stop allocating once they've grown
+			std::vector<TypeBucket>					buckets;
+			std::unordered_map<std::type_index, int> bucketLookup;
+			std::vector<GameObject*>				serialObjects;
+
+			int batchSize;
+		};
+	}
+}
@@ -0,0 +1,93 @@
+#include "WorldCommandBuffer.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "Constraint.h"
+
+#include <algorithm>
+
+using namespace NCL;
+using namespace NCL::CSC8503;
+
+void WorldCommandBuffer::Record(const Command& c) {
+	std::lock_guard<std::mutex> lock(commandLock);
+	commands.emplace_back(c);
+}
+
+void WorldCommandBuffer::AddGameObject(GameObject* o) {
+	Record({ CommandType::AddObject, o, nullptr, false });
+}
+
+void WorldCommandBuffer::RemoveGameObject(GameObject* o, bool andDelete) {
+	Record({ CommandType::RemoveObject, o, nullptr, andDelete });
+}
+
+void WorldCommandBuffer::AddConstraint(Constraint* c) {
+	Record({ CommandType::AddConstraint, nullptr, c, false });
+}
+
+void WorldCommandBuffer::RemoveConstraint(Constraint* c, bool andDelete) {
+	Record({ CommandType::RemoveConstraint, nullptr, c, andDelete });
+}
+
+void WorldCommandBuffer::Apply(GameWorld& world) {
+	/*
+	Applying a command can run destructors that record new commands (a
+	character dropping its held item as it is deleted, say), so we swap the
+	list out first and keep going until nothing new turns up.
+
+	A constraint queued in the same frame as one of its objects was removed
+	would be added after the world had purged constraints using that object,
+	so those are held back - the constraint's owner still has it.
+	*/
+	std::vector<GameObject*> removed;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lock(commandLock);
+			if (commands.empty()) {
+				break;
+			}
+			std::swap(commands, applying);
+		}
+		for (const Command& c : applying) {
+			switch (c.type) {
+				case CommandType::AddObject:
+					removed.erase(std::remove(removed.begin(), removed.end(), c.object), removed.end());
+					world.AddGameObject(c.object);
+					break;
+				case CommandType::RemoveObject:
+					removed.emplace_back(c.object);
+					world.RemoveGameObject(c.object, c.andDelete);
+					break;
+				case CommandType::AddConstraint:
+					if (std::none_of(removed.begin(), removed.end(), [&c](const GameObject* o) { return c.constraint->Uses(o); })) {
+						world.AddConstraint(c.constraint);
+					}
+					break;
+				case CommandType::RemoveConstraint:	world.RemoveConstraint(c.constraint, c.andDelete); break;
+			}
+		}
+		applying.clear();
+	}
+}
+
+void WorldCommandBuffer::Discard(bool deleteAdded) {
+	std::vector<Command> discarded;
+	{
+		std::lock_guard<std::mutex> lock(commandLock);
+		std::swap(commands, discarded);
+	}
+	//a queued constraint is the world's from the moment it's recorded, so nothing else will free it
+	for (const Command& c : discarded) {
+		if (c.type == CommandType::AddObject && deleteAdded) {
+			delete c.object;
+		}
+		else if (c.type == CommandType::AddConstraint) {
+			delete c.constraint;
+		}
+	}
+}
+
+bool WorldCommandBuffer::IsEmpty() const {
+	std::lock_guard<std::mutex> lock(commandLock);
+	return commands.empty();
+}
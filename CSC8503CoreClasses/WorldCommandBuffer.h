@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <mutex>
+
+namespace NCL {
+	namespace CSC8503 {
+		class GameWorld;
+		class GameObject;
+		class Constraint;
+
+		/*
+		Records structural changes to a GameWorld - objects and constraints
+		being added or removed - so that they can be made in one go at a sync
+		point, rather than in the middle of something iterating over the
+		world. Collision callbacks, item pickups and dialogue actions can all
+		safely record changes while the world's lists are being walked.
+
+		Commands are applied in the order they were recorded, so an object
+		added and then removed within the same frame ends up removed. Recording
+		is guarded by a mutex, so systems updating in parallel can all push
+		changes into the same buffer.
+		*/
+		class WorldCommandBuffer
+		{
+		public:
+			WorldCommandBuffer() = default;
+			~WorldCommandBuffer() = default;
+
+			void AddGameObject(GameObject* o);
+			void RemoveGameObject(GameObject* o, bool andDelete = false);
+
+			void AddConstraint(Constraint* c);
+			void RemoveConstraint(Constraint* c, bool andDelete = false);
+
+			//Makes every recorded change to the world, and empties the buffer
+			void Apply(GameWorld& world);
+
+			//Throws away every recorded change. Constraints that were waiting to be added are
+			//deleted, as the world owns them once queued - objects only if deleteAdded is set
+			void Discard(bool deleteAdded);
+
+			bool IsEmpty() const;
+
+		protected:
+			enum class CommandType {
+				AddObject,
+				RemoveObject,
+				AddConstraint,
+				RemoveConstraint
+			};
+
+			struct Command {
+				CommandType	type;
+				GameObject*	object;
+				Constraint*	constraint;
+				bool		andDelete;
+			};
+
+			void Record(const Command& c);
+
+			std::vector<Command>	commands;
+			std::vector<Command>	applying;
+			mutable std::mutex		commandLock;
+		};
+	}
+}
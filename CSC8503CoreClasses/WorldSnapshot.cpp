@@ -0,0 +1,39 @@
+#include "WorldSnapshot.h"
+
+using namespace NCL;
+using namespace CSC8503;
+
+//FNV-1a over the used part of the buffer - handy for spotting two peers
+//whose simulations have drifted apart
+unsigned int WorldSnapshot::GetChecksum() const {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char)buffer[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+SnapshotPool::~SnapshotPool() {
+	for (WorldSnapshot* s : allSnapshots) {
+		delete s;
+	}
+}
+
+WorldSnapshot* SnapshotPool::Acquire() {
+	if (freeSnapshots.empty()) {
+		WorldSnapshot* s = new WorldSnapshot();
+		allSnapshots.push_back(s);
+		return s;
+	}
+	WorldSnapshot* s = freeSnapshots.back();
+	freeSnapshots.pop_back();
+	s->Reset();
+	return s;
+}
+
+void SnapshotPool::Release(WorldSnapshot* s) {
+	if (s) {
+		freeSnapshots.push_back(s);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		A WorldSnapshot is a flat, contiguous copy of the dynamic state of a
+		GameWorld and its PhysicsSystem - transforms, velocities, forces,
+		the collision pair cache and any constraint state. Writing and reading
+		are plain memcpys of trivially copyable records, so restoring a level
+		or rolling back a few frames is far cheaper than rebuilding the world.
+
+		The buffer is never shrunk by Reset, so a snapshot that is reused
+		every frame stops allocating once it has grown to fit the world.
+		*/
+		class WorldSnapshot
+		{
+		public:
+			WorldSnapshot() {
+				size = 0;
+			}
+			~WorldSnapshot() = default;
+
+			void Reset() {
+				size = 0;
+			}
+
+			template <typename T>
+			void Write(const T& value) {
+				static_assert(std::is_trivially_copyable<T>::value, "Snapshot records must be trivially copyable!");
+				if (size + sizeof(T) > buffer.size()) {
+					buffer.resize(std::max(buffer.size() * 2, size + sizeof(T)));
+				}
+				memcpy(&buffer[size], &value, sizeof(T));
+				size += sizeof(T);
+			}
+
+			template <typename T>
+			bool Read(size_t& offset, T& value) const {
+				static_assert(std::is_trivially_copyable<T>::value, "Snapshot records must be trivially copyable!");
+				if (offset + sizeof(T) > size) {
+					return false; //ran off the end, snapshot doesn't match what we're reading!
+				}
+				memcpy(&value, &buffer[offset], sizeof(T));
+				offset += sizeof(T);
+				return true;
+			}
+
+			const char* GetData() const {
+				return buffer.data();
+			}
+
+			size_t GetSize() const {
+				return size;
+			}
+
+			size_t GetCapacity() const {
+				return buffer.size();
+			}
+
+			unsigned int GetChecksum() const;
+
+		protected:
+			std::vector<char>	buffer;
+			size_t				size;
+		};
+
+		/*
+		Snapshots are expensive to grow but cheap to reuse, so systems that
+		take them regularly (rollback histories, level restarts) should pull
+		them from a pool rather than new'ing them each time.
+		*/
+		class SnapshotPool
+		{
+		public:
+			SnapshotPool() = default;
+			~SnapshotPool();
+
+			WorldSnapshot*	Acquire();
+			void			Release(WorldSnapshot* s);
+
+		protected:
+			std::vector<WorldSnapshot*> allSnapshots;
+			std::vector<WorldSnapshot*> freeSnapshots;
+		};
+	}
+}
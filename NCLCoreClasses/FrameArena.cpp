@@ -0,0 +1,90 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace NCL;
+
+FrameArena::FrameArena(size_t initialSize) {
+	currentBlock		= 0;
+	offset				= 0;
+	usedInEarlierBlocks	= 0;
+	AddBlock(initialSize);
+}
+
+FrameArena::~FrameArena() {
+	for (Block& b : blocks) {
+		::operator delete(b.memory);
+	}
+}
+
+void FrameArena::AddBlock(size_t minSize) {
+	Block b;
+	b.size		= minSize;
+	b.memory	= (char*)::operator new(b.size);
+	blocks.push_back(b);
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+	while (true) {
+		Block& b = blocks[currentBlock];
+		uintptr_t base		= (uintptr_t)b.memory;
+		uintptr_t aligned	= (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		size_t newOffset	= (size_t)(aligned - base) + bytes;
+
+		if (newOffset <= b.size) {
+			offset = newOffset;
+			return (void*)aligned;
+		}
+		//Doesn't fit - move on to the next block, making one big enough if need be
+		usedInEarlierBlocks += offset;
+		offset = 0;
+		currentBlock++;
+		if (currentBlock == blocks.size()) {
+			AddBlock(std::max(blocks.back().size * 2, bytes + alignment));
+		}
+	}
+}
+
+void FrameArena::Free(void* memory, size_t bytes) {
+	char* top = blocks[currentBlock].memory + offset;
+	if ((char*)memory + bytes == top) {
+		offset -= bytes;
+	}
+}
+
+void FrameArena::Reset() {
+	if (blocks.size() > 1) {
+		//Last frame needed more than one block, so replace them all with one that would have fit it
+		size_t totalSize = 0;
+		for (Block& b : blocks) {
+			totalSize += b.size;
+			::operator delete(b.memory);
+		}
+		blocks.clear();
+		AddBlock(totalSize);
+	}
+	currentBlock		= 0;
+	offset				= 0;
+	usedInEarlierBlocks	= 0;
+}
+
+size_t FrameArena::GetUsedBytes() const {
+	return usedInEarlierBlocks + offset;
+}
+
+size_t FrameArena::GetCapacity() const {
+	size_t total = 0;
+	for (const Block& b : blocks) {
+		total += b.size;
+	}
+	return total;
+}
@@ -0,0 +1,114 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace NCL {
+	/*
+	A linear 'bump' allocator for data that only lives for a frame (or a
+	physics substep). Allocating just moves an offset along a block of
+	memory, freeing does nothing, and the whole lot is thrown away at once
+	with Reset - so transient lists, maps and packets cost no heap traffic
+	and no allocator locks once the arena has grown to fit a frame.
+
+	If a frame overflows the current block, another is chained on, and the
+	next Reset swaps them all for a single block big enough for the lot.
+
+	An arena is not thread safe - each system (or thread) should own its own.
+	Nothing allocated from it has its destructor run on Reset.
+	*/
+	class FrameArena {
+	public:
+		FrameArena(size_t initialSize = 64 * 1024);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		//Only reclaims the memory if it was the most recent allocation, which is
+		//enough to let a growing vector reuse its old space
+		void Free(void* memory, size_t bytes);
+
+		template <typename T, typename... Args>
+		T* New(Args&&... args) {
+			static_assert(std::is_trivially_destructible<T>::value, "Arena objects never have their destructors called!");
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		void Reset();
+
+		size_t GetUsedBytes() const;
+		size_t GetCapacity() const;
+
+	protected:
+		struct Block {
+			char*	memory;
+			size_t	size;
+		};
+
+		void AddBlock(size_t minSize);
+
+		std::vector<Block>	blocks;
+		size_t				currentBlock;
+		size_t				offset;
+		size_t				usedInEarlierBlocks;
+	};
+
+	/*
+	Lets std containers allocate out of a FrameArena. Containers using one
+	must be cleared or destroyed before the arena they use is Reset.
+	*/
+	template <typename T>
+	class ArenaAllocator {
+	public:
+		typedef T value_type;
+
+		ArenaAllocator(FrameArena& a) noexcept : arena(&a) {}
+
+		template <typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+		T* allocate(size_t n) {
+			return (T*)arena->Allocate(n * sizeof(T), alignof(T));
+		}
+
+		void deallocate(T* p, size_t n) noexcept {
+			arena->Free(p, n * sizeof(T));
+		}
+
+		template <typename U>
+		bool operator==(const ArenaAllocator<U>& other) const {
+			return arena == other.arena;
+		}
+
+		template <typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const {
+			return arena != other.arena;
+		}
+
+	protected:
+		template <typename U>
+		friend class ArenaAllocator;
+
+		FrameArena* arena;
+	};
+
+	template <typename T>
+	using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+	template <typename K, typename V, typename Hash = std::hash<K>>
+	using ArenaUnorderedMap = std::unordered_map<K, V, Hash, std::equal_to<K>, ArenaAllocator<std::pair<const K, V>>>;
+}
@@ -0,0 +1,244 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "JobSystem.h"
+
+#include <algorithm>
+
+using namespace NCL;
+
+//Which worker's deque this thread owns, or -1 for the main thread and any others
+static thread_local int currentWorker = -1;
+
+JobSystem& JobSystem::Get() {
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem::JobSystem() : queuedJobs(0), nextQueue(0), quitting(false) {
+	mainThreadID = std::this_thread::get_id();
+}
+
+JobSystem::~JobSystem() {
+	Shutdown();
+}
+
+void JobSystem::Initialise(int workerCount) {
+	Shutdown();
+
+	if (workerCount < 0) {
+		workerCount = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+	}
+	mainThreadID	= std::this_thread::get_id();
+	quitting		= false;
+
+	for (int i = 0; i < workerCount; ++i) {
+		queues.emplace_back(std::make_unique<WorkerQueue>());
+	}
+	for (int i = 0; i < workerCount; ++i) {
+		workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+void JobSystem::Shutdown() {
+	if (workers.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		quitting = true;
+	}
+	wakeCondition.notify_all();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	workers.clear();
+
+	//Anything still queued is finished off here, so no counter is left waiting forever
+	Job job;
+	while (PopJob(-1, job)) {
+		Execute(job);
+	}
+	queues.clear();
+	queuedJobs = 0;
+}
+
+void JobSystem::AddToCounter(JobCounter* counter) {
+	if (counter) {
+		std::lock_guard<std::mutex> lock(counter->lock);
+		counter->unfinished++;
+		counter->pending.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void JobSystem::Run(JobFunc func, JobCounter* counter, JobAffinity affinity) {
+	AddToCounter(counter);
+	Submit({ std::move(func), counter }, affinity);
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, JobFunc func, JobCounter* counter, JobAffinity affinity) {
+	AddToCounter(counter);
+	{
+		//Either the dependency's last job hasn't finished yet and will pick this
+		//up, or it already has, and we start it ourselves
+		std::lock_guard<std::mutex> lock(dependency.lock);
+		if (dependency.unfinished > 0) {
+			dependency.continuations.push_back({ std::move(func), counter, affinity });
+			return;
+		}
+	}
+	Submit({ std::move(func), counter }, affinity);
+}
+
+void JobSystem::Submit(Job&& job, JobAffinity affinity) {
+	if (affinity == JobAffinity::MainThread) {
+		std::lock_guard<std::mutex> lock(mainThreadQueue.lock);
+		mainThreadQueue.jobs.emplace_back(std::move(job));
+		return;
+	}
+	if (queues.empty()) {
+		Execute(job); //no workers, so just do it now
+		return;
+	}
+	//Workers keep their own jobs to themselves (until stolen), anyone else spreads them out
+	int queueIndex = currentWorker >= 0 ? currentWorker : (int)(nextQueue++ % queues.size());
+	{
+		std::lock_guard<std::mutex> lock(queues[queueIndex]->lock);
+		queues[queueIndex]->jobs.emplace_back(std::move(job));
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		queuedJobs++;
+	}
+	wakeCondition.notify_one();
+}
+
+bool JobSystem::PopJob(int workerIndex, Job& job) {
+	if (workerIndex >= 0) {
+		WorkerQueue& own = *queues[workerIndex];
+		std::lock_guard<std::mutex> lock(own.lock);
+		if (!own.jobs.empty()) {
+			job = std::move(own.jobs.back());
+			own.jobs.pop_back();
+			queuedJobs--;
+			return true;
+		}
+	}
+	int queueCount = (int)queues.size();
+	for (int i = 1; i <= queueCount; ++i) {
+		int victim = (workerIndex + i + queueCount) % queueCount;
+		if (victim == workerIndex) {
+			continue;
+		}
+		WorkerQueue& other = *queues[victim];
+		std::lock_guard<std::mutex> lock(other.lock);
+		if (!other.jobs.empty()) {
+			job = std::move(other.jobs.front());
+			other.jobs.pop_front();
+			queuedJobs--;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool JobSystem::TryRunJob(int workerIndex) {
+	Job job;
+	if (PopJob(workerIndex, job)) {
+		Execute(job);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Execute(Job& job) {
+	job.func();
+	FinishJob(job.counter);
+}
+
+void JobSystem::FinishJob(JobCounter* counter) {
+	if (!counter) {
+		return;
+	}
+	std::vector<JobCounter::Continuation> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter->lock);
+		if (--counter->unfinished == 0) {
+			std::swap(ready, counter->continuations);
+		}
+	}
+	//Waiters may destroy the counter as soon as this reaches zero, so it must be the last use of it
+	counter->pending.fetch_sub(1, std::memory_order_release);
+
+	for (JobCounter::Continuation& c : ready) {
+		Submit({ std::move(c.func), c.counter }, c.affinity);
+	}
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	while (!counter.IsDone()) {
+		if (!TryRunJob(currentWorker)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ParallelFor(int count, int minBatchSize, const JobRangeFunc& func) {
+	if (count <= 0) {
+		return;
+	}
+	int batchCount = count / std::max(minBatchSize, 1);
+	batchCount = std::min(batchCount, ((int)workers.size() + 1) * 4); //a few per thread, to give stealing some slack
+
+	if (batchCount <= 1 || workers.empty()) {
+		func(0, count);
+		return;
+	}
+	int batchSize = (count + batchCount - 1) / batchCount;
+
+	JobCounter counter;
+	for (int start = batchSize; start < count; start += batchSize) {
+		int end = std::min(start + batchSize, count);
+		Run([&func, start, end]() { func(start, end); }, &counter);
+	}
+	func(0, batchSize);
+	Wait(counter);
+}
+
+void JobSystem::RunMainThreadJobs() {
+	if (!IsMainThread()) {
+		return;
+	}
+	while (true) {
+		Job job;
+		{
+			std::lock_guard<std::mutex> lock(mainThreadQueue.lock);
+			if (mainThreadQueue.jobs.empty()) {
+				return;
+			}
+			job = std::move(mainThreadQueue.jobs.front());
+			mainThreadQueue.jobs.pop_front();
+		}
+		Execute(job);
+	}
+}
+
+void JobSystem::WorkerLoop(int workerIndex) {
+	currentWorker = workerIndex;
+	while (true) {
+		if (TryRunJob(workerIndex)) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepLock);
+		wakeCondition.wait(lock, [&]() { return queuedJobs > 0 || quitting; });
+		if (quitting) {
+			break;
+		}
+	}
+	currentWorker = -1;
+}
@@ -0,0 +1,154 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NCL {
+	typedef std::function<void()> JobFunc;
+	typedef std::function<void(int start, int end)> JobRangeFunc;
+
+	enum class JobAffinity {
+		Any,		//run on whichever worker gets to it first
+		MainThread	//for anything that touches the window or graphics context, run at the next sync point
+	};
+
+	/*
+	Tracks a group of jobs - it goes up when a job is added with this
+	counter, and down again when that job finishes. Wait on a counter to
+	block until its jobs are done, or use JobSystem::RunAfter to start
+	another job once they are, which is how dependencies are expressed.
+
+	A counter must outlive every job that was started with it.
+	*/
+	class JobCounter {
+	public:
+		JobCounter() : pending(0), unfinished(0) {}
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const {
+			return pending.load(std::memory_order_acquire) == 0;
+		}
+
+	protected:
+		friend class JobSystem;
+
+		struct Continuation {
+			JobFunc		func;
+			JobCounter*	counter;
+			JobAffinity	affinity;
+		};
+
+		/*
+		Both of these count the unfinished jobs. unfinished is guarded by the
+		lock, and decides who runs the continuations; pending is what waiters
+		poll, and is always the very last thing a finishing job touches, so
+		the counter can be safely destroyed as soon as it reads zero.
+		*/
+		std::atomic<int>			pending;
+		int							unfinished;
+		std::mutex					lock;
+		std::vector<Continuation>	continuations;
+	};
+
+	/*
+	A shared work-stealing scheduler, so that physics, render list building,
+	animation and asset loading can all spread work across the same set of
+	threads rather than each creating their own.
+
+	Every worker has its own deque of jobs - it pushes and pops at the back,
+	so the work it just made is still in cache, while idle workers steal
+	from the front of each other's deques. Jobs that must run on the main
+	thread go into a separate queue, which is only drained when the main
+	loop calls RunMainThreadJobs - that's its sync point, where nothing else
+	is running, so those jobs can safely touch anything. Don't Wait on a
+	main thread job from the main thread, as it won't run until then.
+
+	Until Initialise is called there are no workers, and everything simply
+	runs inline on the calling thread, so code written against the job
+	system still works in single threaded tools.
+	*/
+	class JobSystem {
+	public:
+		static JobSystem& Get();
+
+		//workerCount < 0 picks one worker per hardware thread, less one for the main thread
+		void Initialise(int workerCount = -1);
+		void Shutdown();
+
+		int GetWorkerCount() const {
+			return (int)workers.size();
+		}
+
+		bool IsMainThread() const {
+			return std::this_thread::get_id() == mainThreadID;
+		}
+
+		void Run(JobFunc func, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+		//Starts func once every job in dependency has finished
+		void RunAfter(JobCounter& dependency, JobFunc func, JobCounter* counter = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+		//Helps out with other jobs until the counter's jobs are done
+		void Wait(JobCounter& counter);
+
+		/*
+		Splits [0, count) into batches of at least minBatchSize, and runs func
+		on each batch across the workers, returning once they are all done.
+		The calling thread takes a batch too, so this is safe to use from
+		inside other jobs.
+		*/
+		void ParallelFor(int count, int minBatchSize, const JobRangeFunc& func);
+
+		//Should be called once a frame by the main loop
+		void RunMainThreadJobs();
+
+	protected:
+		JobSystem();
+		~JobSystem();
+
+		struct Job {
+			JobFunc		func;
+			JobCounter*	counter;
+		};
+
+		struct WorkerQueue {
+			std::mutex		lock;
+			std::deque<Job>	jobs;
+		};
+
+		void AddToCounter(JobCounter* counter);
+		void Submit(Job&& job, JobAffinity affinity);
+		bool PopJob(int workerIndex, Job& job);
+		bool TryRunJob(int workerIndex);
+		void Execute(Job& job);
+		void FinishJob(JobCounter* counter);
+		void WorkerLoop(int workerIndex);
+
+		std::vector<std::thread>					workers;
+		std::vector<std::unique_ptr<WorkerQueue>>	queues;
+		WorkerQueue									mainThreadQueue;
+
+		std::atomic<int>		queuedJobs;
+		std::atomic<unsigned>	nextQueue;
+		std::atomic<bool>		quitting;
+
+		std::mutex				sleepLock;
+		std::condition_variable	wakeCondition;
+
+		std::thread::id			mainThreadID;
+	};
+}
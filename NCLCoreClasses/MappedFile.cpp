@@ -0,0 +1,110 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace NCL;
+
+MappedFile::MappedFile() {
+	data		= nullptr;
+	size		= 0;
+	copyOnWrite	= false;
+#ifdef _WIN32
+	fileHandle		= INVALID_HANDLE_VALUE;
+	mappingHandle	= nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& filepath, bool copyOnWrite) {
+	Close();
+	this->copyOnWrite = copyOnWrite;
+
+	fileHandle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) { //empty files can't be mapped
+		Close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		Close();
+		return false;
+	}
+	data = (char*)MapViewOfFile(mappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mappingHandle) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+	data			= nullptr;
+	size			= 0;
+	mappingHandle	= nullptr;
+	fileHandle		= INVALID_HANDLE_VALUE;
+}
+#else
+bool MappedFile::Open(const std::string& filepath, bool copyOnWrite) {
+	Close();
+	this->copyOnWrite = copyOnWrite;
+
+	int file = open(filepath.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat fileStats;
+	if (fstat(file, &fileStats) != 0 || fileStats.st_size == 0) { //empty files can't be mapped
+		close(file);
+		return false;
+	}
+	int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+	void* mapped = mmap(nullptr, (size_t)fileStats.st_size, protection, MAP_PRIVATE, file, 0);
+	close(file); //the mapping keeps its own reference to the file
+
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+	data = (char*)mapped;
+	size = (size_t)fileStats.st_size;
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		munmap(data, size);
+	}
+	data = nullptr;
+	size = 0;
+}
+#endif
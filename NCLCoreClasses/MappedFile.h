@@ -0,0 +1,61 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace NCL {
+	/*
+	A whole file mapped into memory, so its contents can be used where they
+	are instead of being read into a buffer first - pages are only loaded
+	from disk when they're first touched, and the OS can share them between
+	processes, and drop them again under memory pressure.
+
+	A copy on write mapping can be written to as well. Changes never reach
+	the file - the first write to a page gives this mapping its own copy of
+	just that page.
+	*/
+	class MappedFile {
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::string& filepath, bool copyOnWrite = false);
+		void Close();
+
+		bool IsOpen() const {
+			return data != nullptr;
+		}
+
+		const char* GetData() const {
+			return data;
+		}
+
+		//Only for copy on write mappings - anything else is read only
+		char* GetWritableData() const {
+			return copyOnWrite ? data : nullptr;
+		}
+
+		size_t GetSize() const {
+			return size;
+		}
+
+	protected:
+		char*	data;
+		size_t	size;
+		bool	copyOnWrite;
+#ifdef _WIN32
+		void*	fileHandle;
+		void*	mappingHandle;
+#endif
+	};
+}
@@ -0,0 +1,68 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#include "NameID.h"
+
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+using namespace NCL;
+
+namespace {
+	struct InternTable {
+		std::mutex									lock;
+		std::unordered_map<uint32_t, std::string>	names;
+	};
+
+	//Never destroyed, so names can still be looked up from other statics' destructors
+	InternTable& GetInternTable() {
+		static InternTable* table = new InternTable();
+		return *table;
+	}
+}
+
+uint32_t NameID::Hash(const char* str, size_t length) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+NameID::NameID(const std::string& name) {
+	if (name.empty()) {
+		id = 0;
+		return;
+	}
+	id = Hash(name.c_str(), name.size());
+	if (id == 0) {
+		id = 1; //keep 0 for the empty name
+	}
+
+	InternTable& table = GetInternTable();
+	std::lock_guard<std::mutex> guard(table.lock);
+
+	auto inserted = table.names.insert({ id, name });
+	if (!inserted.second && inserted.first->second != name) {
+		std::cout << "NameID: '" << name << "' and '" << inserted.first->second << "' hash to the same ID!\n";
+	}
+}
+
+const std::string& NameID::GetString() const {
+	static const std::string emptyName;
+	if (id == 0) {
+		return emptyName;
+	}
+	InternTable& table = GetInternTable();
+	std::lock_guard<std::mutex> guard(table.lock);
+
+	auto found = table.names.find(id);
+	return found != table.names.end() ? found->second : emptyName;
+}
@@ -0,0 +1,66 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace NCL {
+	/*
+	An interned string - the name is hashed down to a 32 bit ID once, when
+	the NameID is made, and from then on comparing two names is comparing
+	two integers. The original string is kept in a shared table, so it can
+	still be got back for debug output.
+
+	Hot code should build the NameIDs it compares against once, as function
+	statics or members, rather than from a literal every call.
+
+	The empty string is the null ID, 0.
+	*/
+	class NameID {
+	public:
+		NameID() : id(0) {}
+		NameID(const std::string& name);
+		NameID(const char* name) : NameID(std::string(name)) {}
+
+		uint32_t GetID() const {
+			return id;
+		}
+
+		bool IsNull() const {
+			return id == 0;
+		}
+
+		//Looks the name up in the intern table, so keep it out of per-frame code
+		const std::string& GetString() const;
+
+		bool operator==(const NameID& other) const {
+			return id == other.id;
+		}
+
+		bool operator!=(const NameID& other) const {
+			return id != other.id;
+		}
+
+		bool operator<(const NameID& other) const {
+			return id < other.id;
+		}
+
+		//32 bit FNV-1a
+		static uint32_t Hash(const char* str, size_t length);
+
+	protected:
+		uint32_t id;
+	};
+
+	struct NameIDHash {
+		size_t operator()(const NameID& n) const {
+			return n.GetID();
+		}
+	};
+}
@@ -0,0 +1,117 @@
+/*
+Part of Newcastle University's Game Engineering source code.
+
+Use as you see fit!
+
+Comments and queries to: richard-gordon.davison AT ncl.ac.uk
+https://research.ncl.ac.uk/game/
+*/
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace NCL {
+	/*
+	A pool of fixed size slots, carved out of large contiguous chunks. Freed
+	slots go onto a free list and are handed straight back out, so objects
+	of one type end up packed next to each other instead of scattered across
+	the heap, and creating or destroying one never touches the system
+	allocator once the pool has warmed up.
+
+	Chunks are never given back, and the per-type pools are deliberately
+	never destroyed, so it's still safe to delete pooled objects during
+	static destruction at exit.
+	*/
+	template <typename T, size_t SlotsPerChunk = 256>
+	class ObjectPool {
+	public:
+		static ObjectPool& Get() {
+			static ObjectPool* pool = new ObjectPool();
+			return *pool;
+		}
+
+		//Anything that isn't exactly a T (a bigger derived class, say) goes to the normal heap
+		void* Allocate(size_t size) {
+			if (size != sizeof(T)) {
+				return ::operator new(size);
+			}
+			std::lock_guard<std::mutex> lock(poolLock);
+			if (!freeList) {
+				AddChunk();
+			}
+			FreeSlot* slot = freeList;
+			freeList = slot->next;
+			liveCount++;
+			return slot;
+		}
+
+		void Free(void* p, size_t size) {
+			if (!p) {
+				return;
+			}
+			if (size != sizeof(T)) {
+				::operator delete(p);
+				return;
+			}
+			std::lock_guard<std::mutex> lock(poolLock);
+			FreeSlot* slot = (FreeSlot*)p;
+			slot->next = freeList;
+			freeList = slot;
+			liveCount--;
+		}
+
+		size_t GetLiveCount() const {
+			return liveCount;
+		}
+
+		size_t GetCapacity() const {
+			return chunks.size() * SlotsPerChunk;
+		}
+
+	protected:
+		ObjectPool() = default;
+		~ObjectPool() = default;
+
+		struct FreeSlot {
+			FreeSlot* next;
+		};
+
+		static const size_t SlotAlignment	= alignof(T) > alignof(std::max_align_t) ? alignof(T) : alignof(std::max_align_t);
+		static const size_t SlotSize		= ((sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot)) + SlotAlignment - 1) & ~(SlotAlignment - 1);
+
+		void AddChunk() {
+			char* chunk = (char*)::operator new(SlotSize * SlotsPerChunk, std::align_val_t(SlotAlignment));
+			chunks.push_back(chunk);
+			//thread the new slots onto the free list in address order, so they get handed out in order too
+			for (size_t i = SlotsPerChunk; i > 0; --i) {
+				FreeSlot* slot = (FreeSlot*)(chunk + (i - 1) * SlotSize);
+				slot->next = freeList;
+				freeList = slot;
+			}
+		}
+
+		std::vector<char*>	chunks;
+		FreeSlot*			freeList	= nullptr;
+		size_t				liveCount	= 0;
+		std::mutex			poolLock;
+	};
+
+	/*
+	Derive from this to give a class pooled new and delete. Classes deleted
+	through a base pointer need a virtual destructor, so that the sized
+	delete sees the real size of the object.
+	*/
+	template <typename T>
+	class PoolAllocated {
+	public:
+		static void* operator new(size_t size) {
+			return ObjectPool<T>::Get().Allocate(size);
+		}
+
+		static void operator delete(void* p, size_t size) {
+			ObjectPool<T>::Get().Free(p, size);
+		}
+	};
+}
@@ -0,0 +1,176 @@
+#include "BenchmarkScenes.h"
+#include "GameObject.h"
+#include "PhysicsObject.h"
+#include "PositionConstraint.h"
+
+#include "AABBVolume.h"
+#include "OBBVolume.h"
+#include "SphereVolume.h"
+
+#include <random>
+
+using namespace NCL;
+using namespace CSC8503;
+
+const std::vector<BenchmarkScenes::Scene>& BenchmarkScenes::GetAllScenes() {
+	static const std::vector<Scene> scenes = {
+		{ "SphereGrid",	BuildSphereGrid	},
+		{ "AABBGrid",	BuildAABBGrid	},
+		{ "MixedGrid",	BuildMixedGrid	},
+		{ "BoxStacks",	BuildBoxStacks	},
+		{ "RopeChains",	BuildRopeChains	},
+		{ "MetalPile",	BuildMetalPile	},
+	};
+	return scenes;
+}
+
+GameObject* BenchmarkScenes::AddFloor(GameWorld& world, const Vector3& position) {
+	GameObject* floor = new GameObject("Floor");
+
+	Vector3 floorSize = Vector3(200, 2, 200);
+	floor->SetBoundingVolume(new AABBVolume(floorSize));
+	floor->GetTransform()
+		.SetScale(floorSize * 2.0f)
+		.SetPosition(position);
+
+	floor->SetPhysicsObject(new PhysicsObject(floor->GetTransform(), floor->GetBoundingVolume()));
+	floor->GetPhysicsObject()->SetInverseMass(0);
+	floor->GetPhysicsObject()->InitCubeInertia();
+
+	world.AddGameObject(floor);
+	return floor;
+}
+
+GameObject* BenchmarkScenes::AddSphere(GameWorld& world, const Vector3& position, float radius, float inverseMass) {
+	GameObject* sphere = new GameObject("Sphere");
+
+	sphere->SetBoundingVolume(new SphereVolume(radius));
+	sphere->GetTransform()
+		.SetScale(Vector3(radius, radius, radius))
+		.SetPosition(position);
+
+	sphere->SetPhysicsObject(new PhysicsObject(sphere->GetTransform(), sphere->GetBoundingVolume()));
+	sphere->GetPhysicsObject()->SetInverseMass(inverseMass);
+	sphere->GetPhysicsObject()->InitSphereInertia();
+
+	world.AddGameObject(sphere);
+	return sphere;
+}
+
+GameObject* BenchmarkScenes::AddCube(GameWorld& world, const Vector3& position, const Vector3& halfDims, float inverseMass) {
+	GameObject* cube = new GameObject("Cube");
+
+	cube->SetBoundingVolume(new AABBVolume(halfDims));
+	cube->GetTransform()
+		.SetPosition(position)
+		.SetScale(halfDims * 2.0f);
+
+	cube->SetPhysicsObject(new PhysicsObject(cube->GetTransform(), cube->GetBoundingVolume()));
+	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
+	cube->GetPhysicsObject()->InitCubeInertia();
+
+	world.AddGameObject(cube);
+	return cube;
+}
+
+GameObject* BenchmarkScenes::AddOBBCube(GameWorld& world, const Vector3& position, const Vector3& halfDims, float inverseMass, const std::string& name) {
+	GameObject* cube = new GameObject(name.empty() ? "OBBCube" : name);
+
+	cube->SetBoundingVolume(new OBBVolume(halfDims));
+	cube->GetTransform()
+		.SetPosition(position)
+		.SetScale(halfDims * 2.0f);
+
+	cube->SetPhysicsObject(new PhysicsObject(cube->GetTransform(), cube->GetBoundingVolume()));
+	cube->GetPhysicsObject()->SetInverseMass(inverseMass);
+	cube->GetPhysicsObject()->InitCubeInertia();
+
+	world.AddGameObject(cube);
+	return cube;
+}
+
+//Matches TutorialGame::CreateSphereGrid(15, 15, 3.5f, 3.5f, 1.0f)
+void BenchmarkScenes::BuildSphereGrid(GameWorld& world) {
+	for (int x = 0; x < 15; ++x) {
+		for (int z = 0; z < 15; ++z) {
+			AddSphere(world, Vector3(x * 3.5f, 10.0f, z * 3.5f), 1.0f);
+		}
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
+
+//Matches TutorialGame::CreateAABBGrid(15, 15, 3.5f, 3.5f, (1,1,1)), plus a floor to land on
+void BenchmarkScenes::BuildAABBGrid(GameWorld& world) {
+	for (int x = 1; x < 16; ++x) {
+		for (int z = 1; z < 16; ++z) {
+			AddCube(world, Vector3(x * 3.5f, 10.0f, z * 3.5f), Vector3(1, 1, 1));
+		}
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
+
+//Matches TutorialGame::CreatedMixedGrid, but with a fixed seed instead of rand()
+void BenchmarkScenes::BuildMixedGrid(GameWorld& world) {
+	std::mt19937 rng(8503);
+
+	for (int x = 0; x < 15; ++x) {
+		for (int z = 0; z < 15; ++z) {
+			Vector3 position = Vector3(x * 3.5f, 10.0f, z * 3.5f);
+			if (rng() % 2) {
+				AddCube(world, position, Vector3(1, 1, 1));
+			}
+			else {
+				AddSphere(world, position, 1.0f);
+			}
+		}
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
+
+//Resting contact: towers of OBB boxes, which go through the full SAT and clipping path
+void BenchmarkScenes::BuildBoxStacks(GameWorld& world) {
+	const int stacks	= 8;
+	const int height	= 10;
+	Vector3 halfDims	= Vector3(1, 1, 1);
+
+	for (int s = 0; s < stacks; ++s) {
+		for (int h = 0; h < height; ++h) {
+			AddOBBCube(world, Vector3(s * 5.0f, 1.0f + h * 2.05f, 0), halfDims);
+		}
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
+
+//Constraint solver load: hanging chains of spheres held by position constraints
+void BenchmarkScenes::BuildRopeChains(GameWorld& world) {
+	const int	chains		= 10;
+	const int	links		= 20;
+	const float	linkSpacing	= 1.2f;
+
+	for (int c = 0; c < chains; ++c) {
+		Vector3 anchorPos	= Vector3(c * 6.0f, 40.0f, 0);
+		GameObject* previous = AddSphere(world, anchorPos, 0.5f, 0.0f);
+
+		for (int l = 1; l <= links; ++l) {
+			//swing the chains out sideways so they start moving straight away
+			GameObject* link = AddSphere(world, anchorPos + Vector3(0, 0, l * linkSpacing), 0.5f);
+			world.AddConstraint(new PositionConstraint(previous, link, linkSpacing));
+			previous = link;
+		}
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
+
+//A heap of the game's pull/push metal crates dropped on top of each other
+void BenchmarkScenes::BuildMetalPile(GameWorld& world) {
+	std::mt19937 rng(8508);
+	std::uniform_real_distribution<float> offset(-4.0f, 4.0f);
+	std::uniform_real_distribution<float> size(0.5f, 1.5f);
+
+	for (int i = 0; i < 200; ++i) {
+		Vector3 position	= Vector3(offset(rng), 5.0f + i * 0.75f, offset(rng));
+		Vector3 halfDims	= Vector3(size(rng), size(rng), size(rng));
+		AddOBBCube(world, position, halfDims, 1.0f, "MetalObject");
+	}
+	AddFloor(world, Vector3(0, -2, 0));
+}
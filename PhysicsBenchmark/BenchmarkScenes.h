@@ -0,0 +1,38 @@
+#pragma once
+#include "GameWorld.h"
+
+#include <string>
+#include <vector>
+
+namespace NCL {
+	namespace CSC8503 {
+		/*
+		The canonical physics test scenes, built procedurally with no meshes,
+		materials or window - just transforms, volumes and physics objects -
+		so they can be stepped headless. The grids match TutorialGame's, and
+		everything random is seeded so every run builds the same world.
+		*/
+		namespace BenchmarkScenes {
+			typedef void(*SceneBuilder)(GameWorld& world);
+
+			struct Scene {
+				std::string		name;
+				SceneBuilder	build;
+			};
+
+			const std::vector<Scene>& GetAllScenes();
+
+			GameObject* AddFloor(GameWorld& world, const Vector3& position);
+			GameObject* AddSphere(GameWorld& world, const Vector3& position, float radius, float inverseMass = 1.0f);
+			GameObject* AddCube(GameWorld& world, const Vector3& position, const Vector3& halfDims, float inverseMass = 1.0f);
+			GameObject* AddOBBCube(GameWorld& world, const Vector3& position, const Vector3& halfDims, float inverseMass = 1.0f, const std::string& name = "");
+
+			void BuildSphereGrid(GameWorld& world);
+			void BuildAABBGrid(GameWorld& world);
+			void BuildMixedGrid(GameWorld& world);
+			void BuildBoxStacks(GameWorld& world);
+			void BuildRopeChains(GameWorld& world);
+			void BuildMetalPile(GameWorld& world);
+		}
+	}
+}
@@ -0,0 +1,138 @@
+/*
+Headless physics benchmark.
+
+Builds each of the benchmark scenes, steps the PhysicsSystem a fixed number
+of times at the ideal 120Hz rate, and writes the timings and pair counts to
+stdout as JSON, so that results can be diffed between builds.
+
+Usage: PhysicsBenchmark [-steps N] [-scene Name] [-broadphase on|off|both] [-threads N]
+
+Threads defaults to 0, which keeps everything on the main thread.
+*/
+#include "GameWorld.h"
+#include "PhysicsSystem.h"
+#include "GameTimer.h"
+#include "JobSystem.h"
+#include "BenchmarkScenes.h"
+
+#include <iostream>
+#include <cstring>
+#include <string>
+
+using namespace NCL;
+using namespace CSC8503;
+
+struct BenchmarkSettings {
+	int			steps			= 1000;
+	std::string	sceneFilter;
+	bool		runBroadPhase	= true;
+	bool		runBruteForce	= true;
+	int			threads			= 0;
+};
+
+static void WriteResult(const BenchmarkScenes::Scene& scene, bool broadPhase, int objectCount, int steps, float buildTime, float totalTime, unsigned int checksum, const PhysicsStats& stats, bool first) {
+	std::cout << (first ? "" : ",\n");
+	std::cout << "\t\t{\n";
+	std::cout << "\t\t\t\"scene\": \"" << scene.name << "\",\n";
+	std::cout << "\t\t\t\"broadphase\": " << (broadPhase ? "true" : "false") << ",\n";
+	std::cout << "\t\t\t\"objects\": " << objectCount << ",\n";
+	std::cout << "\t\t\t\"steps\": " << steps << ",\n";
+	std::cout << "\t\t\t\"substeps\": " << stats.substeps << ",\n";
+	std::cout << "\t\t\t\"buildMs\": " << buildTime << ",\n";
+	std::cout << "\t\t\t\"totalMs\": " << totalTime << ",\n";
+	std::cout << "\t\t\t\"msPerStep\": " << (steps > 0 ? totalTime / steps : 0.0f) << ",\n";
+	std::cout << "\t\t\t\"phasesMs\": {\n";
+	std::cout << "\t\t\t\t\"integrateAccel\": " << stats.integrateAccelTime << ",\n";
+	std::cout << "\t\t\t\t\"broadPhase\": " << stats.broadPhaseTime << ",\n";
+	std::cout << "\t\t\t\t\"narrowPhase\": " << stats.narrowPhaseTime << ",\n";
+	std::cout << "\t\t\t\t\"constraints\": " << stats.constraintTime << ",\n";
+	std::cout << "\t\t\t\t\"integrateVelocity\": " << stats.integrateVelocityTime << ",\n";
+	std::cout << "\t\t\t\t\"collisionList\": " << stats.collisionListTime << "\n";
+	std::cout << "\t\t\t},\n";
+	std::cout << "\t\t\t\"pairsTested\": " << stats.pairsTested << ",\n";
+	std::cout << "\t\t\t\"contacts\": " << stats.contacts << ",\n";
+	std::cout << "\t\t\t\"stateChecksum\": " << checksum << "\n";
+	std::cout << "\t\t}";
+}
+
+static void RunScene(const BenchmarkScenes::Scene& scene, bool broadPhase, int steps, bool first) {
+	GameWorld		world;
+	PhysicsSystem	physics(world);
+
+	physics.UseGravity(true);
+	physics.UseBroadPhase(broadPhase);
+	physics.SetDeterministic(true); //fixed step rate, and repeatable results to compare checksums
+
+	GameTimer timer;
+	scene.build(world);
+	timer.Tick();
+	float buildTime = timer.GetTimeDeltaMSec();
+
+	const float dt = 1.0f / 120.0f;
+	for (int i = 0; i < steps; ++i) {
+		physics.Update(dt);
+	}
+	timer.Tick();
+	float totalTime = timer.GetTimeDeltaMSec();
+
+	GameObjectIterator objFirst, objLast;
+	world.GetObjectIterators(objFirst, objLast);
+	int objectCount = (int)(objLast - objFirst);
+
+	WriteResult(scene, broadPhase, objectCount, steps, buildTime, totalTime, physics.GetStateChecksum(), physics.GetStats(), first);
+
+	world.ClearAndErase();
+	physics.Clear();
+}
+
+int main(int argc, char** argv) {
+	BenchmarkSettings settings;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-steps") == 0 && i + 1 < argc) {
+			settings.steps = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-scene") == 0 && i + 1 < argc) {
+			settings.sceneFilter = argv[++i];
+		}
+		else if (strcmp(argv[i], "-broadphase") == 0 && i + 1 < argc) {
+			std::string mode = argv[++i];
+			settings.runBroadPhase = (mode != "off");
+			settings.runBruteForce = (mode != "on");
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			settings.threads = atoi(argv[++i]);
+		}
+		else {
+			std::cerr << "Unknown argument " << argv[i] << "\n";
+			std::cerr << "Usage: PhysicsBenchmark [-steps N] [-scene Name] [-broadphase on|off|both] [-threads N]\n";
+			return 1;
+		}
+	}
+
+	JobSystem::Get().Initialise(settings.threads);
+
+	std::cout << "{\n";
+	std::cout << "\t\"steps\": " << settings.steps << ",\n";
+	std::cout << "\t\"threads\": " << settings.threads << ",\n";
+	std::cout << "\t\"results\": [\n";
+
+	bool first = true;
+	for (const BenchmarkScenes::Scene& scene : BenchmarkScenes::GetAllScenes()) {
+		if (!settings.sceneFilter.empty() && scene.name != settings.sceneFilter) {
+			continue;
+		}
+		if (settings.runBruteForce) {
+			RunScene(scene, false, settings.steps, first);
+			first = false;
+		}
+		if (settings.runBroadPhase) {
+			RunScene(scene, true, settings.steps, first);
+			first = false;
+		}
+	}
+	std::cout << "\n\t]\n}\n";
+
+	JobSystem::Get().Shutdown();
+	return 0;
+}